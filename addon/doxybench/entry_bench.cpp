@@ -0,0 +1,168 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  @brief Micro benchmark for allocating Entry trees with and without an EntryArena.
+ *
+ *  Usage: entry_bench heap|arena [files] [classes] [members]
+ *
+ *  Builds a tree like the scanner does for the given number of files, each
+ *  with a number of classes that have a number of members with a short
+ *  argument list and some documentation, and then destroys it again.
+ *  With \c arena the entries of each file are allocated from their own
+ *  EntryArena, as parseFile() does; with \c heap every entry is allocated
+ *  separately. Reported are the number of heap allocations, the time to build
+ *  and to destroy the tree, and the resident set size after building and
+ *  after destroying it (Linux only). Run each mode in its own process, so
+ *  the sizes are not influenced by memory that an earlier run freed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <new>
+#include <string>
+
+#include "entry.h"
+
+static size_t g_numAllocs = 0;
+
+void *operator new(size_t size)
+{
+  g_numAllocs++;
+  void *p = malloc(size ? size : 1);
+  if (p==0) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void *p,size_t) noexcept
+{
+  free(p);
+}
+
+/** Returns the resident set size in KB or -1 if it is not known */
+static long residentKB()
+{
+  FILE *f = fopen("/proc/self/statm","r");
+  if (f==0) return -1;
+  long size=0, resident=-1;
+  if (fscanf(f,"%ld %ld",&size,&resident)!=2) resident=-1;
+  fclose(f);
+  return resident<0 ? -1 : resident*4; // assumes 4KB pages
+}
+
+static double msSince(std::chrono::steady_clock::time_point start)
+{
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0;
+}
+
+static std::shared_ptr<Entry> buildFile(int fileIndex,int numClasses,int numMembers)
+{
+  QCString fileName;
+  fileName.sprintf("src/module%d/file%d.cpp",fileIndex%50,fileIndex);
+  std::shared_ptr<Entry> fileRoot = Entry::create();
+  fileRoot->section  = Entry::SOURCE_SEC;
+  fileRoot->name     = fileName;
+  fileRoot->fileName = fileName;
+  for (int c=0;c<numClasses;c++)
+  {
+    std::shared_ptr<Entry> cls = Entry::create();
+    cls->section   = Entry::CLASS_SEC;
+    cls->name.sprintf("ns%d::Class%d_%d",fileIndex%10,fileIndex,c);
+    cls->fileName  = fileName;
+    cls->brief     = "A class that is used by the benchmark.";
+    cls->doc       = "The detailed description of the class, which is typically a few sentences "
+                     "long and explains how the class is meant to be used.";
+    for (int m=0;m<numMembers;m++)
+    {
+      std::shared_ptr<Entry> member = Entry::create();
+      member->section  = Entry::FUNCTION_SEC;
+      member->type     = "const QCString &";
+      member->name.sprintf("memberFunction%d",m);
+      member->args     = "(const char *name, int value) const";
+      member->fileName = fileName;
+      member->brief    = "Returns the value for a name.";
+      member->doc      = "Looks up \\a name and returns the value associated with it.";
+      Argument a;
+      a.type = "const char *";
+      a.name = "name";
+      member->argList.push_back(a);
+      a.type = "int";
+      a.name = "value";
+      member->argList.push_back(a);
+      cls->moveToSubEntryAndKeep(member);
+    }
+    fileRoot->moveToSubEntryAndKeep(cls);
+  }
+  return fileRoot;
+}
+
+int main(int argc,char **argv)
+{
+  if (argc<2 || (strcmp(argv[1],"heap")!=0 && strcmp(argv[1],"arena")!=0))
+  {
+    fprintf(stderr,"Usage: %s heap|arena [files] [classes] [members]\n",argv[0]);
+    return 1;
+  }
+  bool useArena  = strcmp(argv[1],"arena")==0;
+  int numFiles   = argc>2 ? atoi(argv[2]) : 2000;
+  int numClasses = argc>3 ? atoi(argv[3]) : 10;
+  int numMembers = argc>4 ? atoi(argv[4]) : 20;
+
+  long rssStart = residentKB();
+  size_t allocsBefore = g_numAllocs;
+  auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<Entry> root = Entry::create();
+  for (int f=0;f<numFiles;f++)
+  {
+    if (useArena)
+    {
+      EntryArena::Scope arenaScope;
+      root->moveToSubEntryAndKeep(buildFile(f,numClasses,numMembers));
+    }
+    else
+    {
+      root->moveToSubEntryAndKeep(buildFile(f,numClasses,numMembers));
+    }
+  }
+  double buildTime = msSince(start);
+  size_t allocs = g_numAllocs-allocsBefore;
+  long rssBuilt = residentKB();
+
+  start = std::chrono::steady_clock::now();
+  root.reset();
+  double destroyTime = msSince(start);
+  long rssFreed = residentKB();
+
+  printf("mode=%s files=%d classes=%d members=%d entries=%d\n",argv[1],
+         numFiles,numClasses,numMembers,numFiles*(1+numClasses*(1+numMembers))+1);
+  printf("allocations  %10zu\n",allocs);
+  printf("build        %10.1f ms\n",buildTime);
+  printf("destroy      %10.1f ms\n",destroyTime);
+  if (rssStart>=0)
+  {
+    printf("rss built    %10ld KB\n",rssBuilt-rssStart);
+    printf("rss freed    %10ld KB\n",rssFreed-rssStart);
+  }
+  return 0;
+}
@@ -0,0 +1,163 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  @brief Micro benchmark counting the heap allocations done by QCString.
+ *
+ *  Usage: qcstring_bench file...
+ *
+ *  All identifiers found in the given files (for instance the sources in the
+ *  testing directory) are fed through a number of string operations that are
+ *  typical for doxygen's hot paths: building qualified names, splitting
+ *  scopes, stripping white space, formatting and substitution. Some operations
+ *  are measured twice, once with copies made by left(), right() or mid() and
+ *  once with references made by leftRef(), rightRef() or midRef().
+ *  For each operation the number of heap allocations and the time is reported.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include <chrono>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "qcstring.h"
+
+static size_t g_numAllocs = 0;
+
+void *operator new(size_t size)
+{
+  g_numAllocs++;
+  void *p = malloc(size ? size : 1);
+  if (p==0) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void *p,size_t) noexcept
+{
+  free(p);
+}
+
+static size_t g_sink = 0;
+
+static std::vector<QCString> readIdentifiers(int argc,char **argv)
+{
+  std::vector<QCString> result;
+  for (int i=1;i<argc;i++)
+  {
+    std::ifstream f(argv[i]);
+    if (!f)
+    {
+      fprintf(stderr,"Could not open %s\n",argv[i]);
+      continue;
+    }
+    std::stringstream ss;
+    ss << f.rdbuf();
+    std::string contents = ss.str();
+    size_t p=0, l=contents.size();
+    while (p<l)
+    {
+      if (isalpha((unsigned char)contents[p]) || contents[p]=='_')
+      {
+        size_t s=p;
+        while (p<l && (isalnum((unsigned char)contents[p]) || contents[p]=='_')) p++;
+        result.push_back(QCString(contents.substr(s,p-s)));
+      }
+      else
+      {
+        p++;
+      }
+    }
+  }
+  return result;
+}
+
+template<class F>
+static void run(const char *name,const std::vector<QCString> &ids,F &&f)
+{
+  size_t allocsBefore = g_numAllocs;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i=0;i<ids.size();i++)
+  {
+    g_sink+=f(ids[i],ids[(i+1)%ids.size()]).length();
+  }
+  auto end = std::chrono::steady_clock::now();
+  size_t allocs = g_numAllocs-allocsBefore;
+  printf("%-34s %10zu %8.2f %9.3f ms\n",name,allocs,
+         static_cast<double>(allocs)/static_cast<double>(ids.size()),
+         std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0);
+}
+
+int main(int argc,char **argv)
+{
+  if (argc<2)
+  {
+    fprintf(stderr,"Usage: %s file...\n",argv[0]);
+    return 1;
+  }
+  std::vector<QCString> ids = readIdentifiers(argc,argv);
+  if (ids.empty())
+  {
+    fprintf(stderr,"No identifiers found\n");
+    return 1;
+  }
+  printf("identifiers=%zu\n",ids.size());
+  printf("%-34s %10s %8s %12s\n","operation","allocs","per id","time");
+
+  run("scope+\"::\"+name",ids,[](const QCString &a,const QCString &b)
+      { return a+"::"+b; });
+  run("scope+\"::\"+name+\"::\"+scope",ids,[](const QCString &a,const QCString &b)
+      { return a+"::"+b+"::"+a; });
+  run("name+'<'+arg+'>'",ids,[](const QCString &a,const QCString &b)
+      { return a+'<'+b+'>'; });
+  run("qualified.left/right/mid",ids,[](const QCString &a,const QCString &b)
+      {
+        QCString q = a+"::"+b;
+        int i = q.find("::");
+        return q.left(i)+q.right(q.length()-i-2)+q.mid(1,3);
+      });
+  run("(' '+name+' ').stripWhiteSpace()",ids,[](const QCString &a,const QCString &)
+      { return (' '+a+' ').stripWhiteSpace(); });
+  run("sprintf(\"@%d\")",ids,[](const QCString &a,const QCString &)
+      { QCString s; s.sprintf("@%d",a.length()); return s; });
+  run("substitute(\"::\",\".\")",ids,[](const QCString &a,const QCString &b)
+      { return substitute(a+"::"+b,"::","."); });
+  run("lower()",ids,[](const QCString &a,const QCString &)
+      { return a.lower(); });
+  run("QCString(ptr,len)",ids,[](const QCString &a,const QCString &)
+      { return QCString(a.data(),a.length()>3 ? 3 : a.length()); });
+  run("std::string round trip",ids,[](const QCString &a,const QCString &)
+      { return QCString(a.str()); });
+  run("r+=a.mid(1)+b.left(4)",ids,[](const QCString &a,const QCString &b)
+      { QCString r; r+=a.mid(1); r+="::"; r+=b.left(4); return r; });
+  run("r+=a.midRef(1)+b.leftRef(4)",ids,[](const QCString &a,const QCString &b)
+      { QCString r; r+=a.midRef(1); r+="::"; r+=b.leftRef(4); return r; });
+  run("a.right(2)==b.right(2)",ids,[](const QCString &a,const QCString &b)
+      { return QCString(a.right(2)==b.right(2) ? "y" : "n"); });
+  run("a.rightRef(2)==b.rightRef(2)",ids,[](const QCString &a,const QCString &b)
+      { return QCString(a.rightRef(2)==b.rightRef(2) ? "y" : "n"); });
+
+  return g_sink==0 ? 1 : 0;
+}
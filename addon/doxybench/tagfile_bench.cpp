@@ -0,0 +1,142 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  @brief Benchmark comparing reading tag files as XML and via their binary index.
+ *
+ *  Usage: tagfile_bench [-r repeat] tagfile...
+ *
+ *  For each tag file parseTagFile() is run with TAGFILE_INDEX disabled
+ *  (XML parsing), with the index removed first (XML parsing plus writing
+ *  the index) and with an up to date index (memory mapped index), each time
+ *  into a new Entry tree. The number of entries created is compared to check
+ *  that both ways produce the same result. The index file is removed
+ *  afterwards.
+ *
+ *  The anchors of a tag file are registered globally the first time it is
+ *  read, so one untimed run is done first to give all timed runs the same
+ *  starting point.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <qfile.h>
+#include <qfileinfo.h>
+
+#include "doxygen.h"
+#include "entry.h"
+#include "config.h"
+#include "tagreader.h"
+
+static size_t countEntries(const Entry *e)
+{
+  size_t count=1;
+  for (const auto &child : e->children()) count+=countEntries(child.get());
+  return count;
+}
+
+/** Reads \a fileName \a repeat times and returns the time per run in ms. */
+static double measure(const char *fileName,int repeat,bool useIndex,bool removeIndex,size_t &numEntries)
+{
+  Config_updateBool(TAGFILE_INDEX,useIndex);
+  QCString indexName = QCString(fileName)+".idx";
+  double total=0;
+  for (int r=0;r<repeat;r++)
+  {
+    if (removeIndex) QFile::remove(indexName);
+    std::shared_ptr<Entry> root = std::make_shared<Entry>();
+    auto start = std::chrono::steady_clock::now();
+    parseTagFile(root,fileName);
+    auto end = std::chrono::steady_clock::now();
+    total+=std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0;
+    numEntries=countEntries(root.get());
+  }
+  return total/repeat;
+}
+
+static void usage(const char *name)
+{
+  fprintf(stderr,"Usage: %s [-r repeat] tagfile...\n",name);
+  exit(1);
+}
+
+int main(int argc,char **argv)
+{
+  int repeat=5;
+  std::vector<std::string> tagFiles;
+  for (int i=1;i<argc;i++)
+  {
+    if (strcmp(argv[i],"-r")==0 && i+1<argc)
+    {
+      repeat=atoi(argv[++i]);
+    }
+    else
+    {
+      tagFiles.push_back(argv[i]);
+    }
+  }
+  if (tagFiles.empty() || repeat<1) usage(argv[0]);
+
+  initDoxygen();
+  checkConfiguration();
+  adjustConfiguration();
+  Config_updateBool(QUIET,TRUE);
+  Config_updateBool(WARNINGS,FALSE);
+
+  printf("%-30s %10s %8s %12s %12s %12s\n","tag file","size","entries",
+         "xml ms","build ms","index ms");
+  int result=0;
+  for (const auto &name : tagFiles)
+  {
+    QFileInfo fi(name.c_str());
+    if (!fi.exists())
+    {
+      fprintf(stderr,"Tag file %s does not exist\n",name.c_str());
+      result=1;
+      continue;
+    }
+    std::string fileName = fi.absFilePath().utf8().data();
+    QCString indexName = QCString(fileName.c_str())+".idx";
+    size_t xmlEntries=0, buildEntries=0, indexEntries=0;
+    measure(fileName.c_str(),1,false,false,xmlEntries); // warm up
+    double xmlMs   = measure(fileName.c_str(),repeat,false,false,xmlEntries);
+    double buildMs = measure(fileName.c_str(),repeat,true,true,buildEntries);
+    bool hasIndex  = QFileInfo(indexName).exists();
+    double indexMs = measure(fileName.c_str(),repeat,true,false,indexEntries);
+    QFile::remove(indexName);
+
+    printf("%-30s %10u %8zu %12.3f %12.3f %12.3f\n",fi.fileName().utf8().data(),fi.size(),
+           xmlEntries,xmlMs,buildMs,indexMs);
+    if (!hasIndex)
+    {
+      fprintf(stderr,"No index written for %s\n",fileName.c_str());
+      result=2;
+    }
+    else if (buildEntries!=xmlEntries || indexEntries!=xmlEntries)
+    {
+      fprintf(stderr,"Entry count mismatch for %s: xml=%zu build=%zu index=%zu\n",
+              fileName.c_str(),xmlEntries,buildEntries,indexEntries);
+      result=2;
+    }
+  }
+  return result;
+}
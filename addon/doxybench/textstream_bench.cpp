@@ -0,0 +1,175 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  @brief Micro benchmark comparing the unbuffered and buffered FTextStream.
+ *
+ *  Usage: textstream_bench [members [repeat [outputfile]]]
+ *
+ *  Writes a synthetic HTML page for a class with the given number of members
+ *  (default 5000) in the way HtmlGenerator and HtmlDocVisitor do: markup as
+ *  short strings and the documentation text escaped character by character.
+ *  The page is written to a QBuffer, as OutputGenerator does for all generated
+ *  pages, and to a QFile, as the XML output does, once through an unbuffered
+ *  and once through a buffered stream. The output file defaults to
+ *  textstream_bench.out in the current directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+
+#include <qbuffer.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+
+#include "ftextstream.h"
+
+static const char *g_docText =
+  "Returns the number of elements in the list that match the <i>predicate</i> & "
+  "are not \"hidden\"; the list is not modified. See also count() and find().";
+
+static void docify(FTextStream &t,const char *str)
+{
+  const char *p=str;
+  char c;
+  while ((c=*p++))
+  {
+    switch(c)
+    {
+      case '<':  t << "&lt;"; break;
+      case '>':  t << "&gt;"; break;
+      case '&':  t << "&amp;"; break;
+      case '"':  t << "&quot;"; break;
+      default:   t << c;
+    }
+  }
+}
+
+static void writeClassPage(FTextStream &t,int numMembers)
+{
+  t << "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Transitional//EN\">" << endl;
+  t << "<html><head><title>MyList Class Reference</title></head><body>" << endl;
+  t << "<table class=\"memberdecls\">" << endl;
+  for (int i=0;i<numMembers;i++)
+  {
+    t << "<tr class=\"memitem:a" << i << "\"><td class=\"memItemLeft\" align=\"right\" valign=\"top\">";
+    docify(t,"std::vector< int > &");
+    t << "&#160;</td><td class=\"memItemRight\" valign=\"bottom\"><a class=\"el\" href=\"class_my_list.html#a";
+    t << i << "\">member" << i << "</a> (";
+    docify(t,"const Predicate &p, int flags=0");
+    t << ")</td></tr>" << endl;
+    t << "<tr class=\"memdesc:a" << i << "\"><td class=\"mdescLeft\">&#160;</td><td class=\"mdescRight\">";
+    docify(t,g_docText);
+    t << "<br /></td></tr>" << endl;
+  }
+  t << "</table>" << endl;
+  for (int i=0;i<numMembers;i++)
+  {
+    t << "<a id=\"a" << i << "\"></a>" << endl;
+    t << "<h2 class=\"memtitle\"><span class=\"permalink\"><a href=\"#a" << i << "\">&#9670;&nbsp;</a></span>";
+    t << "member" << i << "()</h2>" << endl;
+    t << "<div class=\"memitem\"><div class=\"memproto\">" << endl;
+    for (int p=0;p<3;p++)
+    {
+      t << "<p>";
+      docify(t,g_docText);
+      t << "</p>" << endl;
+    }
+    t << "</div></div>" << endl;
+  }
+  t << "</body></html>" << endl;
+}
+
+template<class F>
+static double measure(int repeat,F &&f)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int r=0;r<repeat;r++) f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0;
+}
+
+static uint writeToBuffer(int numMembers,bool buffered)
+{
+  QBuffer buf;
+  buf.open(IO_WriteOnly);
+  {
+    FTextStream t;
+    t.setBuffered(buffered);
+    t.setDevice(&buf);
+    writeClassPage(t,numMembers);
+  }
+  buf.close();
+  return buf.buffer().size();
+}
+
+static uint writeToFile(const char *fileName,int numMembers,bool buffered)
+{
+  QFile f(fileName);
+  if (!f.open(IO_WriteOnly))
+  {
+    fprintf(stderr,"Cannot open %s for writing\n",fileName);
+    exit(1);
+  }
+  {
+    FTextStream t(&f);
+    t.setBuffered(buffered);
+    writeClassPage(t,numMembers);
+  }
+  f.close();
+  return QFileInfo(fileName).size();
+}
+
+int main(int argc,char **argv)
+{
+  int numMembers = argc>1 ? atoi(argv[1]) : 5000;
+  int repeat     = argc>2 ? atoi(argv[2]) : 5;
+  const char *fileName = argc>3 ? argv[3] : "textstream_bench.out";
+  if (numMembers<1 || repeat<1)
+  {
+    fprintf(stderr,"Usage: %s [members [repeat [outputfile]]]\n",argv[0]);
+    return 1;
+  }
+
+  uint size[4] = { 0, 0, 0, 0 };
+  double ms[4];
+  ms[0] = measure(repeat,[&]() { size[0]=writeToBuffer(numMembers,false); });
+  ms[1] = measure(repeat,[&]() { size[1]=writeToBuffer(numMembers,true); });
+  ms[2] = measure(repeat,[&]() { size[2]=writeToFile(fileName,numMembers,false); });
+  ms[3] = measure(repeat,[&]() { size[3]=writeToFile(fileName,numMembers,true); });
+  QFile::remove(fileName);
+
+  printf("members=%d repeat=%d page size=%u bytes\n",numMembers,repeat,size[0]);
+  printf("%-22s %10s %10s\n","stream","ms/page","MB/s");
+  const char *names[4] = { "QBuffer unbuffered", "QBuffer buffered",
+                           "QFile unbuffered",   "QFile buffered" };
+  for (int i=0;i<4;i++)
+  {
+    double perPage = ms[i]/repeat;
+    printf("%-22s %10.3f %10.1f\n",names[i],perPage,
+           perPage>0 ? static_cast<double>(size[i])/(perPage*1000.0) : 0.0);
+  }
+  for (int i=1;i<4;i++)
+  {
+    if (size[i]!=size[0])
+    {
+      fprintf(stderr,"Output size mismatch: %s wrote %u bytes, expected %u\n",names[i],size[i],size[0]);
+      return 2;
+    }
+  }
+  return 0;
+}
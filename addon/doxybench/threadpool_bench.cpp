@@ -0,0 +1,146 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  @brief Micro benchmark comparing ThreadPool and WorkStealingThreadPool.
+ *
+ *  Usage: threadpool_bench [numThreads] [numTasks]
+ *
+ *  Two workloads are measured:
+ *  - queueing many tiny tasks using queue() and waiting for all futures,
+ *  - processing all elements of a LinkedMap, by queueing one task per element
+ *    for ThreadPool and using parallelFor() for WorkStealingThreadPool.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "threadpool.h"
+#include "linkedmap.h"
+
+struct Item
+{
+  Item(const char *n,int v) : name(n), value(v) {}
+  std::string name;
+  int value;
+};
+
+static std::atomic<long> g_sink(0);
+
+// a small amount of work, comparable to handling a single member
+static long work(int value)
+{
+  long r = value;
+  for (int i=0;i<200;i++)
+  {
+    r = (r*31+i)%1000003;
+  }
+  return r;
+}
+
+template<class F>
+static double measure(F &&f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0;
+}
+
+template<class Pool>
+static double benchQueue(std::size_t numThreads,int numTasks)
+{
+  Pool pool(numThreads);
+  return measure([&]()
+  {
+    std::vector< std::future<long> > results;
+    results.reserve(numTasks);
+    for (int i=0;i<numTasks;i++)
+    {
+      results.emplace_back(pool.queue([i]() { return work(i); }));
+    }
+    for (auto &f : results)
+    {
+      g_sink+=f.get();
+    }
+  });
+}
+
+static double benchMapThreadPool(std::size_t numThreads,const LinkedMap<Item> &map)
+{
+  ThreadPool pool(numThreads);
+  return measure([&]()
+  {
+    std::vector< std::future<long> > results;
+    results.reserve(map.size());
+    for (const auto &item : map)
+    {
+      const Item *ip = item.get();
+      results.emplace_back(pool.queue([ip]() { return work(ip->value); }));
+    }
+    for (auto &f : results)
+    {
+      g_sink+=f.get();
+    }
+  });
+}
+
+static double benchMapWorkStealing(std::size_t numThreads,const LinkedMap<Item> &map)
+{
+  WorkStealingThreadPool pool(numThreads);
+  return measure([&]()
+  {
+    pool.parallelFor(map,[](const std::unique_ptr<Item> &item)
+    {
+      g_sink+=work(item->value);
+    });
+  });
+}
+
+int main(int argc,char **argv)
+{
+  std::size_t numThreads = argc>1 ? static_cast<std::size_t>(atoi(argv[1])) : 0;
+  int numTasks = argc>2 ? atoi(argv[2]) : 100000;
+  if (numThreads==0)
+  {
+    numThreads = std::thread::hardware_concurrency();
+  }
+  if (numTasks<=0)
+  {
+    fprintf(stderr,"Usage: %s [numThreads] [numTasks]\n",argv[0]);
+    return 1;
+  }
+
+  LinkedMap<Item> map;
+  for (int i=0;i<numTasks;i++)
+  {
+    map.add(("item"+std::to_string(i)).c_str(),i);
+  }
+
+  printf("threads=%zu tasks=%d\n",numThreads,numTasks);
+  printf("%-38s %12s %12s\n","workload","ThreadPool","WorkStealing");
+  printf("%-38s %9.3f ms %9.3f ms\n","queue() tiny tasks",
+         benchQueue<ThreadPool>(numThreads,numTasks),
+         benchQueue<WorkStealingThreadPool>(numThreads,numTasks));
+  printf("%-38s %9.3f ms %9.3f ms\n","LinkedMap per element / parallelFor",
+         benchMapThreadPool(numThreads,map),
+         benchMapWorkStealing(numThreads,map));
+  return g_sink==0 ? 1 : 0;
+}
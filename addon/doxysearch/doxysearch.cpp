@@ -23,6 +23,8 @@
 #include <fstream>
 #include <string>
 #include <algorithm>
+#include <list>
+#include <map>
 
 // Xapian includes
 #include <xapian.h>
@@ -33,6 +35,13 @@
 #include <windows.h>
 #else
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
 #endif
 
 #define FIELD_TYPE 1
@@ -302,170 +311,488 @@ static std::string escapeString(const std::string &s)
   return dst.str();
 }
 
-static void showError(const std::string &callback,const std::string &error)
+/** Returns the JSONP response reporting \a error */
+static std::string errorResponse(const std::string &callback,const std::string &error)
 {
-  std::cout << callback << "({\"error\":\"" << error << "\"})";
-  exit(0);
+  return callback + "({\"error\":\"" + escapeString(error) + "\"})";
 }
 
+/** Parameters of a search request */
+struct Request
+{
+  std::string searchFor;
+  std::string callback;
+  int num  = 1;
+  int page = 0;
+};
+
+/** Parses the (URL encoded) query string \a queryString */
+static Request parseQueryString(const std::string &queryString)
+{
+  Request req;
+  std::vector<std::string> parts = split(queryString,'&');
+  for (std::vector<std::string>::const_iterator it=parts.begin();it!=parts.end();++it)
+  {
+    std::vector<std::string> kv = split(*it,'=');
+    if (kv.size()==2)
+    {
+      std::string val = uriDecode(kv[1]);
+      if      (kv[0]=="q")  req.searchFor = val;
+      else if (kv[0]=="n")  req.num       = fromString<int>(val);
+      else if (kv[0]=="p")  req.page      = fromString<int>(val);
+      else if (kv[0]=="cb") req.callback  = val;
+    }
+  }
+  return req;
+}
+
+/** Class that runs queries on the search database. The database and the query
+ *  parser are kept open between queries, and the results of the most recent
+ *  queries are cached, such that a long running process can answer repeated
+ *  queries without touching the database.
+ */
+class Searcher
+{
+  public:
+    Searcher(const std::string &indexDir,size_t cacheSize)
+      : m_db(indexDir), m_cacheSize(cacheSize)
+    {
+      m_parser.set_database(m_db);
+      m_parser.set_default_op(Xapian::Query::OP_AND);
+      m_parser.set_stemming_strategy(Xapian::QueryParser::STEM_ALL);
+      Xapian::termcount max_expansion=100;
+#if (XAPIAN_MAJOR_VERSION==1) && (XAPIAN_MINOR_VERSION==2)
+      m_parser.set_max_wildcard_expansion(max_expansion);
+#else
+      m_parser.set_max_expansion(max_expansion,Xapian::Query::WILDCARD_LIMIT_MOST_FREQUENT);
+#endif
+      m_lastDocId = m_db.get_lastdocid();
+      m_docCount  = m_db.get_doccount();
+    }
+
+    /** Returns the results of \a req in JSON format (without the callback) */
+    std::string search(const Request &req)
+    {
+      checkForUpdates();
+      std::ostringstream key;
+      key << req.num << ' ' << req.page << ' ' << req.searchFor;
+      std::map<std::string,CacheList::iterator>::iterator it = m_cacheIndex.find(key.str());
+      if (it!=m_cacheIndex.end()) // cache hit, move to the front
+      {
+        m_cache.splice(m_cache.begin(),m_cache,it->second);
+        return it->second->second;
+      }
+      std::string result = runQuery(req);
+      if (m_cacheSize>0)
+      {
+        m_cache.push_front(std::make_pair(key.str(),result));
+        m_cacheIndex[key.str()] = m_cache.begin();
+        if (m_cache.size()>m_cacheSize) // evict least recently used result
+        {
+          m_cacheIndex.erase(m_cache.back().first);
+          m_cache.pop_back();
+        }
+      }
+      return result;
+    }
+
+  private:
+    typedef std::list< std::pair<std::string,std::string> > CacheList;
+
+    /** Picks up a new version of the database written by doxyindexer,
+     *  in which case the cached results are no longer valid.
+     */
+    void checkForUpdates()
+    {
+      m_db.reopen();
+      Xapian::docid lastDocId = m_db.get_lastdocid();
+      Xapian::doccount docCount = m_db.get_doccount();
+      if (lastDocId!=m_lastDocId || docCount!=m_docCount)
+      {
+        m_cache.clear();
+        m_cacheIndex.clear();
+        m_lastDocId = lastDocId;
+        m_docCount  = docCount;
+      }
+    }
+
+    std::string runQuery(const Request &req)
+    {
+      int num  = req.num;
+      int page = req.page;
+      const std::string &searchFor = req.searchFor;
+
+      // create query
+      Xapian::Enquire enquire(m_db);
+      std::vector<std::string> words = split(searchFor,' ');
+      Xapian::Query query=m_parser.parse_query(searchFor,
+                                               Xapian::QueryParser::FLAG_DEFAULT  |
+                                               Xapian::QueryParser::FLAG_WILDCARD |
+                                               Xapian::QueryParser::FLAG_PHRASE   |
+                                               Xapian::QueryParser::FLAG_PARTIAL
+                                              );
+      enquire.set_query(query);
+
+      // get results
+      Xapian::MSet matches = enquire.get_mset(page*num,num);
+      unsigned int hits    = matches.get_matches_estimated();
+      unsigned int offset  = page*num;
+      unsigned int pages   = num>0 ? (hits+num-1)/num : 0;
+      if (offset>hits)     offset=hits;
+      if (offset+num>hits) num=hits-offset;
+
+      // write results as JSON
+      std::ostringstream out;
+      out << "{" << std::endl
+          << "  \"hits\":"   << hits   << "," << std::endl
+          << "  \"first\":"  << offset << "," << std::endl
+          << "  \"count\":"  << num    << "," << std::endl
+          << "  \"page\":"   << page   << "," << std::endl
+          << "  \"pages\":"  << pages  << "," << std::endl
+          << "  \"query\": \""  << escapeString(searchFor)  << "\"," << std::endl
+          << "  \"items\":[" << std::endl;
+      // foreach search result
+      unsigned int o = offset;
+      for (Xapian::MSetIterator i = matches.begin(); i != matches.end(); ++i,++o)
+      {
+        std::vector<Fragment> hl;
+        Xapian::Document doc = i.get_document();
+        highlighter(doc.get_value(FIELD_DOC),words,hl);
+        out << "  {\"type\": \"" << doc.get_value(FIELD_TYPE) << "\"," << std::endl
+            << "   \"name\": \"" << doc.get_value(FIELD_NAME) << escapeString(doc.get_value(FIELD_ARGS)) << "\"," << std::endl
+            << "   \"tag\": \""  << doc.get_value(FIELD_TAG) << "\"," << std::endl
+            << "   \"url\": \""  << doc.get_value(FIELD_URL) << "\"," << std::endl;
+        out << "   \"fragments\":[" << std::endl;
+        int c=0;
+        bool first=true;
+        for (std::vector<Fragment>::const_iterator it = hl.begin();it!=hl.end() && c<3;++it,++c)
+        {
+          if (!first) out << "," << std::endl;
+          out << "     \"" << escapeString((*it).text) << "\"";
+          first=false;
+        }
+        if (!first) out << std::endl;
+        out << "   ]" << std::endl;
+        out << "  }";
+        if (o<offset+num-1) out << ",";
+        out << std::endl;
+      }
+      out << " ]" << std::endl << "}";
+      return out.str();
+    }
+
+    Xapian::Database m_db;
+    Xapian::QueryParser m_parser;
+    Xapian::docid m_lastDocId;
+    Xapian::doccount m_docCount;
+    size_t m_cacheSize;
+    CacheList m_cache;
+    std::map<std::string,CacheList::iterator> m_cacheIndex;
+};
+
+/** Returns the JSONP response for the query string \a queryString */
+static std::string handleRequest(Searcher &searcher,const std::string &queryString)
+{
+  Request req = parseQueryString(queryString);
+  try
+  {
+    if (queryString=="test") // user test
+    {
+      return "Test successful.";
+    }
+    return req.callback + "(" + searcher.search(req) + ")\n";
+  }
+  catch (const Xapian::Error &e) // Xapian exception
+  {
+    return errorResponse(req.callback,e.get_description());
+  }
+  catch (...) // Any other exception
+  {
+    return errorResponse(req.callback,"Unknown Exception!");
+  }
+}
+
+/** Answers queries read from stdin, one query string per line. Each response
+ *  is written to stdout preceded by a line with its length in bytes.
+ */
+static void serveStdin(Searcher &searcher)
+{
+  std::string line;
+  while (std::getline(std::cin,line))
+  {
+    if (!line.empty() && line[line.length()-1]=='\r') line.erase(line.length()-1);
+    std::string response = handleRequest(searcher,line);
+    std::cout << response.length() << "\n" << response << std::flush;
+  }
+}
+
+#ifndef _WIN32
+/** Reads a line of at most \a maxLen bytes from socket \a fd */
+static bool readLine(int fd,std::string &line,size_t maxLen=65536)
+{
+  line.clear();
+  char c;
+  ssize_t n;
+  while ((n=read(fd,&c,1))==1 && c!='\n')
+  {
+    if (line.length()>=maxLen) return false;
+    line+=c;
+  }
+  if (n<0) return false;
+  if (!line.empty() && line[line.length()-1]=='\r') line.erase(line.length()-1);
+  return true;
+}
+
+static bool writeAll(int fd,const std::string &data)
+{
+  size_t written=0;
+  while (written<data.length())
+  {
+    ssize_t n = write(fd,data.data()+written,data.length()-written);
+    if (n<=0) return false;
+    written+=n;
+  }
+  return true;
+}
+
+/** Makes reads and writes on socket \a fd fail after \a seconds without progress */
+static bool setSocketTimeout(int fd,int seconds)
+{
+  struct timeval tv;
+  tv.tv_sec  = seconds;
+  tv.tv_usec = 0;
+  return setsockopt(fd,SOL_SOCKET,SO_RCVTIMEO,&tv,sizeof(tv))==0 &&
+         setsockopt(fd,SOL_SOCKET,SO_SNDTIMEO,&tv,sizeof(tv))==0;
+}
+
+static bool socketAddress(const std::string &path,struct sockaddr_un &addr)
+{
+  memset(&addr,0,sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.length()>=sizeof(addr.sun_path)) return false;
+  strcpy(addr.sun_path,path.c_str());
+  return true;
+}
+
+/** Answers queries sent to the local socket \a path. A client sends a query
+ *  string terminated by a newline and receives a line with the length of the
+ *  response in bytes followed by the response, after which the connection is
+ *  closed.
+ */
+static int serveSocket(Searcher &searcher,const std::string &path)
+{
+  struct sockaddr_un addr;
+  if (!socketAddress(path,addr))
+  {
+    std::cerr << "Socket path " << path << " is too long" << std::endl;
+    return 1;
+  }
+  int fd = socket(AF_UNIX,SOCK_STREAM,0);
+  if (fd<0)
+  {
+    std::cerr << "Could not create socket: " << strerror(errno) << std::endl;
+    return 1;
+  }
+  unlink(path.c_str());
+  if (bind(fd,(struct sockaddr*)&addr,sizeof(addr))!=0 || listen(fd,64)!=0)
+  {
+    std::cerr << "Could not listen on " << path << ": " << strerror(errno) << std::endl;
+    close(fd);
+    return 1;
+  }
+  signal(SIGPIPE,SIG_IGN); // a client that went away should not stop the server
+  for (;;)
+  {
+    int client = accept(fd,0,0);
+    if (client<0)
+    {
+      if (errno==EINTR) continue;
+      std::cerr << "Could not accept connection: " << strerror(errno) << std::endl;
+      break;
+    }
+    // the server handles one client at a time, so a client that stalls
+    // must not be able to block it; on a timeout the connection is dropped
+    std::string queryString;
+    if (setSocketTimeout(client,5) && readLine(client,queryString))
+    {
+      std::string response = handleRequest(searcher,queryString);
+      writeAll(client,std::to_string(response.length())+"\n"+response);
+    }
+    close(client);
+  }
+  close(fd);
+  return 1;
+}
+
+/** Forwards \a queryString to the server listening on socket \a path.
+ *  Returns false if there is no server, or it did not send a complete
+ *  response in time, so the query can be run directly.
+ */
+static bool forwardToServer(const std::string &path,const std::string &queryString,std::string &response)
+{
+  struct sockaddr_un addr;
+  if (!socketAddress(path,addr)) return false;
+  int fd = socket(AF_UNIX,SOCK_STREAM,0);
+  if (fd<0) return false;
+  std::string lengthLine;
+  if (!setSocketTimeout(fd,10) ||
+      connect(fd,(struct sockaddr*)&addr,sizeof(addr))!=0 ||
+      !writeAll(fd,queryString+"\n") ||
+      !readLine(fd,lengthLine,20) ||
+      lengthLine.empty() || lengthLine.find_first_not_of("0123456789")!=std::string::npos)
+  {
+    close(fd);
+    return false;
+  }
+  size_t length = std::stoul(lengthLine);
+  response.clear();
+  char buf[4096];
+  ssize_t n=0;
+  while (response.length()<length && (n=read(fd,buf,sizeof(buf)))>0) response.append(buf,n);
+  close(fd);
+  // a truncated response, e.g. from a server that stopped, is not used
+  return response.length()==length;
+}
+#endif
+
 static void usage(const char *name, int exitVal = 1)
 {
   std::cerr << "Usage: " << name << "[query_string]" << std::endl;
   std::cerr << "       " << "alternatively the query string can be given by the environment variable QUERY_STRING" << std::endl;
+  std::cerr << "       " << name << " --serve [--cache size]" << std::endl;
+  std::cerr << "       " << "answers query strings read from stdin, one per line, until end of input" << std::endl;
+#ifndef _WIN32
+  std::cerr << "       " << name << " --socket path [--cache size]" << std::endl;
+  std::cerr << "       " << "answers queries sent to a local socket; when the environment variable" << std::endl;
+  std::cerr << "       " << "DOXYSEARCH_SOCKET is set, the CGI binary forwards its query to that socket" << std::endl;
+#endif
   exit(exitVal);
 }
 
 /** Main routine */
 int main(int argc,char **argv)
 {
-  // process inputs that were passed to us via QUERY_STRING
-  std::string callback;
-  try
+  std::string indexDir = "doxysearch.db";
+
+  // long running server modes
+  if (argc>=2 && (std::string(argv[1])=="--serve" || std::string(argv[1])=="--socket"))
   {
-    std::string queryString;
-    if (argc == 1)
+    std::string mode = argv[1];
+    std::string socketPath;
+    size_t cacheSize = 1000;
+    int i=2;
+    if (mode=="--socket")
     {
-      const char *queryEnv = getenv("QUERY_STRING");
-      if (queryEnv)
+      if (i>=argc) usage(argv[0]);
+      socketPath = argv[i++];
+    }
+    for (;i<argc;i++)
+    {
+      if (std::string(argv[i])=="--cache" && i+1<argc)
       {
-        queryString = queryEnv;
+        cacheSize = fromString<size_t>(argv[++i]);
       }
       else
       {
         usage(argv[0]);
       }
     }
-    else if (argc == 2)
+    try
     {
-      if (std::string(argv[1])=="-h" || std::string(argv[1])=="--help")
-      {
-        usage(argv[0],0);
-      }
-      else if (std::string(argv[1])=="-v" || std::string(argv[1])=="--version")
+      Searcher searcher(indexDir,cacheSize);
+      if (mode=="--serve")
       {
-        std::cerr << argv[0] << " version: " << getFullVersion() << std::endl;
-        exit(0);
-      }
-      else
-      {
-        queryString = argv[1];
+        serveStdin(searcher);
+        return 0;
       }
+#ifndef _WIN32
+      return serveSocket(searcher,socketPath);
+#else
+      usage(argv[0]);
+#endif
+    }
+    catch (const Xapian::Error &e)
+    {
+      std::cerr << "Could not open search index " << indexDir << ": " << e.get_description() << std::endl;
+      return 1;
+    }
+  }
+
+  // process inputs that were passed to us via QUERY_STRING
+  std::string queryString;
+  if (argc == 1)
+  {
+    const char *queryEnv = getenv("QUERY_STRING");
+    if (queryEnv)
+    {
+      queryString = queryEnv;
     }
     else
     {
       usage(argv[0]);
     }
-
-    std::cout << "Content-Type:application/javascript;charset=utf-8\r\n\n";
-    // parse query string
-    std::vector<std::string> parts = split(queryString,'&');
-    std::string searchFor,callback;
-    int num=1,page=0;
-    for (std::vector<std::string>::const_iterator it=parts.begin();it!=parts.end();++it)
+  }
+  else if (argc == 2)
+  {
+    if (std::string(argv[1])=="-h" || std::string(argv[1])=="--help")
     {
-      std::vector<std::string> kv = split(*it,'=');
-      if (kv.size()==2)
-      {
-        std::string val = uriDecode(kv[1]);
-        if      (kv[0]=="q")  searchFor = val; 
-        else if (kv[0]=="n")  num       = fromString<int>(val);
-        else if (kv[0]=="p")  page      = fromString<int>(val);
-        else if (kv[0]=="cb") callback  = val;
-      }
+      usage(argv[0],0);
     }
-
-    std::string indexDir = "doxysearch.db";
-
-    if (queryString=="test") // user test
+    else if (std::string(argv[1])=="-v" || std::string(argv[1])=="--version")
     {
-      bool dbOk = dirExists(indexDir);
-      if (dbOk)
-      {
-        std::cout << "Test successful.";
-      }
-      else
-      {
-        std::cout << "Test failed: cannot find search index " << indexDir;
-      }
+      std::cerr << argv[0] << " version: " << getFullVersion() << std::endl;
       exit(0);
     }
+    else
+    {
+      queryString = argv[1];
+    }
+  }
+  else
+  {
+    usage(argv[0]);
+  }
 
-    // create query
-    Xapian::Database db(indexDir);
-    Xapian::Enquire enquire(db);
+  std::cout << "Content-Type:application/javascript;charset=utf-8\r\n\n";
 
-    std::vector<std::string> words = split(searchFor,' ');
-    Xapian::QueryParser parser;
-    parser.set_database(db);
-    parser.set_default_op(Xapian::Query::OP_AND);
-    parser.set_stemming_strategy(Xapian::QueryParser::STEM_ALL);
-    Xapian::termcount max_expansion=100;
-#if (XAPIAN_MAJOR_VERSION==1) && (XAPIAN_MINOR_VERSION==2)
-    parser.set_max_wildcard_expansion(max_expansion);
-#else
-    parser.set_max_expansion(max_expansion,Xapian::Query::WILDCARD_LIMIT_MOST_FREQUENT);
+#ifndef _WIN32
+  // let a running server with a warm index answer the query if there is one
+  const char *socketEnv = getenv("DOXYSEARCH_SOCKET");
+  std::string response;
+  if (socketEnv && forwardToServer(socketEnv,queryString,response))
+  {
+    std::cout << response;
+    return 0;
+  }
 #endif
-    Xapian::Query query=parser.parse_query(searchFor,
-                                           Xapian::QueryParser::FLAG_DEFAULT  |
-                                           Xapian::QueryParser::FLAG_WILDCARD |
-                                           Xapian::QueryParser::FLAG_PHRASE   |
-                                           Xapian::QueryParser::FLAG_PARTIAL
-                                          );
-    enquire.set_query(query);
-
-    // get results
-    Xapian::MSet matches = enquire.get_mset(page*num,num);
-    unsigned int hits    = matches.get_matches_estimated();
-    unsigned int offset  = page*num;
-    unsigned int pages   = num>0 ? (hits+num-1)/num : 0;
-    if (offset>hits)     offset=hits;
-    if (offset+num>hits) num=hits-offset;
-
-    // write results as JSONP
-    std::cout << callback.c_str() << "(";
-    std::cout << "{" << std::endl 
-              << "  \"hits\":"   << hits   << "," << std::endl
-              << "  \"first\":"  << offset << "," << std::endl
-              << "  \"count\":"  << num    << "," << std::endl
-              << "  \"page\":"   << page   << "," << std::endl
-              << "  \"pages\":"  << pages  << "," << std::endl
-              << "  \"query\": \""  << escapeString(searchFor)  << "\"," << std::endl
-              << "  \"items\":[" << std::endl;
-    // foreach search result
-    unsigned int o = offset;
-    for (Xapian::MSetIterator i = matches.begin(); i != matches.end(); ++i,++o) 
+
+  if (queryString=="test") // user test
+  {
+    bool dbOk = dirExists(indexDir);
+    if (dbOk)
     {
-      std::vector<Fragment> hl;
-      Xapian::Document doc = i.get_document();
-      highlighter(doc.get_value(FIELD_DOC),words,hl);
-      std::cout << "  {\"type\": \"" << doc.get_value(FIELD_TYPE) << "\"," << std::endl
-                << "   \"name\": \"" << doc.get_value(FIELD_NAME) << escapeString(doc.get_value(FIELD_ARGS)) << "\"," << std::endl
-                << "   \"tag\": \""  << doc.get_value(FIELD_TAG) << "\"," << std::endl
-                << "   \"url\": \""  << doc.get_value(FIELD_URL) << "\"," << std::endl;
-      std::cout << "   \"fragments\":[" << std::endl;
-      int c=0;
-      bool first=true;
-      for (std::vector<Fragment>::const_iterator it = hl.begin();it!=hl.end() && c<3;++it,++c)
-      {
-        if (!first) std::cout << "," << std::endl;
-        std::cout << "     \"" << escapeString((*it).text) << "\"";
-        first=false;
-      }
-      if (!first) std::cout << std::endl;
-      std::cout << "   ]" << std::endl;
-      std::cout << "  }";
-      if (o<offset+num-1) std::cout << ",";
-      std::cout << std::endl;
+      std::cout << "Test successful.";
     }
-    std::cout << " ]" << std::endl << "})" << std::endl;
-  } 
+    else
+    {
+      std::cout << "Test failed: cannot find search index " << indexDir;
+    }
+    exit(0);
+  }
+
+  Request req = parseQueryString(queryString);
+  try
+  {
+    Searcher searcher(indexDir,0);
+    std::cout << req.callback << "(" << searcher.search(req) << ")" << std::endl;
+  }
   catch (const Xapian::Error &e) // Xapian exception
   {
-    showError(callback,e.get_description());
-  } 
+    std::cout << errorResponse(req.callback,e.get_description());
+  }
   catch (...) // Any other exception
   {
-    showError(callback,"Unknown Exception!");
+    std::cout << errorResponse(req.callback,"Unknown Exception!");
     exit(1);
   }
   return 0;
@@ -0,0 +1,171 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  @brief Benchmark client that replays a query log against doxysearch.
+ *
+ *  Usage: doxysearch_bench --socket path querylog [repeat]
+ *         doxysearch_bench --cgi path/to/doxysearch.cgi querylog [repeat]
+ *
+ *  Each line of the query log is either a query string (e.g. q=list&n=20&p=0&cb=f)
+ *  or a line of a web server access log, from which the query string following
+ *  "doxysearch.cgi?" is taken. With --socket the queries are sent to a
+ *  doxysearch.cgi running with --socket, with --cgi the binary is started for
+ *  every query, as a web server would do. The latency distribution and the
+ *  throughput are reported.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> readQueryLog(const char *fileName)
+{
+  std::vector<std::string> result;
+  std::ifstream f(fileName);
+  if (!f)
+  {
+    fprintf(stderr,"Could not open %s\n",fileName);
+    return result;
+  }
+  std::string line;
+  while (std::getline(f,line))
+  {
+    size_t i = line.find("doxysearch.cgi?");
+    if (i!=std::string::npos) // access log line
+    {
+      line = line.substr(i+15);
+      size_t e = line.find_first_of(" \"");
+      if (e!=std::string::npos) line.resize(e);
+    }
+    if (!line.empty() && line[line.length()-1]=='\r') line.erase(line.length()-1);
+    if (!line.empty()) result.push_back(line);
+  }
+  return result;
+}
+
+static bool querySocket(const std::string &path,const std::string &queryString,std::string &response)
+{
+  struct sockaddr_un addr;
+  memset(&addr,0,sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.length()>=sizeof(addr.sun_path)) return false;
+  strcpy(addr.sun_path,path.c_str());
+  int fd = socket(AF_UNIX,SOCK_STREAM,0);
+  if (fd<0) return false;
+  std::string request = queryString+"\n";
+  if (connect(fd,(struct sockaddr*)&addr,sizeof(addr))!=0 ||
+      write(fd,request.data(),request.length())!=static_cast<ssize_t>(request.length()))
+  {
+    close(fd);
+    return false;
+  }
+  char buf[4096];
+  ssize_t n;
+  while ((n=read(fd,buf,sizeof(buf)))>0) response.append(buf,n);
+  close(fd);
+  // the response is preceded by a line with its length
+  size_t eol = response.find('\n');
+  if (n!=0 || eol==std::string::npos) return false;
+  size_t length = strtoul(response.c_str(),0,10);
+  response.erase(0,eol+1);
+  return response.length()==length;
+}
+
+static bool queryCgi(const std::string &cgi,const std::string &queryString,std::string &response)
+{
+  // pass the query as a single quoted argument
+  std::string quoted = "'";
+  for (size_t i=0;i<queryString.length();i++)
+  {
+    if (queryString[i]=='\'') quoted+="'\\''"; else quoted+=queryString[i];
+  }
+  quoted+="'";
+  std::string cmd = cgi+" "+quoted;
+  FILE *f = popen(cmd.c_str(),"r");
+  if (f==0) return false;
+  char buf[4096];
+  size_t n;
+  while ((n=fread(buf,1,sizeof(buf),f))>0) response.append(buf,n);
+  return pclose(f)==0;
+}
+
+static void usage(const char *name)
+{
+  fprintf(stderr,"Usage: %s --socket path querylog [repeat]\n",name);
+  fprintf(stderr,"       %s --cgi path/to/doxysearch.cgi querylog [repeat]\n",name);
+  exit(1);
+}
+
+int main(int argc,char **argv)
+{
+  if (argc<4 || argc>5) usage(argv[0]);
+  std::string mode   = argv[1];
+  std::string target = argv[2];
+  if (mode!="--socket" && mode!="--cgi") usage(argv[0]);
+  int repeat = argc==5 ? atoi(argv[4]) : 1;
+  if (repeat<1) repeat=1;
+
+  std::vector<std::string> queries = readQueryLog(argv[3]);
+  if (queries.empty())
+  {
+    fprintf(stderr,"No queries found\n");
+    return 1;
+  }
+
+  std::vector<double> latencies;
+  size_t numErrors=0, numBytes=0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r=0;r<repeat;r++)
+  {
+    for (const auto &q : queries)
+    {
+      std::string response;
+      auto qStart = std::chrono::steady_clock::now();
+      bool ok = mode=="--socket" ? querySocket(target,q,response) : queryCgi(target,q,response);
+      auto qEnd = std::chrono::steady_clock::now();
+      if (!ok || response.find("\"error\":")!=std::string::npos) numErrors++;
+      numBytes+=response.length();
+      latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(qEnd-qStart).count()/1000.0);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  double total = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000000.0;
+
+  std::sort(latencies.begin(),latencies.end());
+  double sum=0;
+  for (double l : latencies) sum+=l;
+  auto percentile = [&latencies](double p)
+  {
+    size_t i = static_cast<size_t>(p*static_cast<double>(latencies.size()-1)+0.5);
+    return latencies[i];
+  };
+  printf("queries=%zu errors=%zu bytes=%zu\n",latencies.size(),numErrors,numBytes);
+  printf("total %.3f s, %.1f queries/s\n",total,static_cast<double>(latencies.size())/total);
+  printf("latency ms: mean %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+         sum/static_cast<double>(latencies.size()),
+         percentile(0.5),percentile(0.95),percentile(0.99),latencies.back());
+  return numErrors==0 ? 0 : 2;
+}
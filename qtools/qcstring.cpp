@@ -27,14 +27,28 @@
 
 QCString &QCString::sprintf( const char *format, ... )
 {
-  va_list ap;
+  va_list ap,ap2;
   va_start( ap, format );
-  const int minlen=256;
-  int l = length();
-  if (l<minlen) { resize(minlen); l=minlen; }
-  int n=vsnprintf( rawData(), l, format, ap);
-  if (n<0) n=l;
-  resize(n+1);
+  va_copy( ap2, ap );
+  // format into a local buffer first, so short results do not need a
+  // heap allocation and the arguments may refer to this string itself
+  char buf[256];
+  int n=vsnprintf( buf, sizeof(buf), format, ap);
+  if (n<0)
+  {
+    m_rep.clear();
+  }
+  else if (n<(int)sizeof(buf))
+  {
+    m_rep.assign(buf,n);
+  }
+  else // result does not fit, format again with the exact size
+  {
+    std::string result(n,'\0');
+    vsnprintf( &result[0], n+1, format, ap2);
+    m_rep = std::move(result);
+  }
+  va_end( ap2 );
   va_end( ap );
   return *this;
 }
@@ -95,6 +95,60 @@ QDataStream &operator>>( QDataStream &, QByteArray & );
 #endif
 
 class QRegExp;
+class QCString;
+
+/** A read-only reference to a range of characters, usually a part of a QCString
+ *  obtained with QCString::leftRef(), QCString::rightRef() or QCString::midRef().
+ *  Comparing or appending a reference does not copy the characters.
+ *  The referenced string has to stay alive and unmodified while the reference is used.
+ *  @note the characters are not 0-terminated, so data() cannot be used as a C string.
+ */
+class QCStringRef
+{
+  public:
+    QCStringRef() : m_data(""), m_len(0) {}
+
+    /** creates a reference to the \a len characters starting at \a str. */
+    QCStringRef( const char *str, uint len ) : m_data(str?str:""), m_len(str?len:0) {}
+
+    /** creates a reference to a 0-terminated C string. */
+    QCStringRef( const char *str ) : m_data(str?str:""), m_len(qstrlen(str)) {}
+
+    /** creates a reference to \a s up to its first 0 character. */
+    QCStringRef( const QCString &s );
+
+    /** Returns a pointer to the first character, which is \e not followed by a 0-terminator. */
+    const char *data() const { return m_data; }
+
+    /** Returns the number of characters referred to. */
+    uint length() const { return m_len; }
+
+    /** Returns TRUE iff the reference is empty. */
+    bool isEmpty() const { return m_len==0; }
+
+    /** Returns the character at index \a i. */
+    char at( uint i ) const { return m_data[i]; }
+
+    /** Compares the characters with those of \a s like qstrcmp() does. */
+    int compare( const QCStringRef &s ) const
+    {
+      int r = std::memcmp(m_data,s.m_data,std::min(m_len,s.m_len));
+      return r!=0 ? r : m_len<s.m_len ? -1 : m_len>s.m_len ? 1 : 0;
+    }
+
+    /** Returns a string holding a copy of the characters. */
+    QCString toQCString() const;
+
+  private:
+    const char *m_data;
+    uint m_len;
+};
+
+inline bool operator==( const QCStringRef &s1, const QCStringRef &s2 )
+{ return s1.length()==s2.length() && std::memcmp(s1.data(),s2.data(),s1.length())==0; }
+
+inline bool operator!=( const QCStringRef &s1, const QCStringRef &s2 )
+{ return !(s1==s2); }
 
 /** This is an alternative implementation of QCString. It provides basically
  *  the same functions but uses std::string as the underlying string type
@@ -111,6 +165,9 @@ class QCString
 
     QCString( const std::string &s ) : m_rep(s) {}
 
+    /** creates a string by taking over the contents of \a s without copying. */
+    QCString( std::string &&s ) : m_rep(std::move(s)) {}
+
     /** creates a string with room for size characters
      *  @param[in] size the number of character to allocate (also counting the 0-terminator!)
      */
@@ -122,7 +179,16 @@ class QCString
     QCString( const char *str ) : m_rep(str?str:"") {}
 
     /** creates a string from \a str and copies over the first \a maxlen characters. */
-    QCString( const char *str, uint maxlen ) : m_rep(str?str:"") { m_rep.resize(maxlen); }
+    QCString( const char *str, uint maxlen )
+    {
+      if (str)
+      {
+        // do not read beyond maxlen characters, str does not need to be 0-terminated
+        const char *end = static_cast<const char *>(std::memchr(str,0,maxlen));
+        m_rep.assign(str,end ? static_cast<size_t>(end-str) : maxlen);
+      }
+      m_rep.resize(maxlen);
+    }
 
     /** replaces the contents by that of string \a s. */
 
@@ -222,6 +288,27 @@ class QCString
              QCString(m_rep.substr(index,len));
     }
 
+    /** Like left() but returns a reference to the characters instead of a copy. */
+    QCStringRef leftRef( uint len ) const
+    {
+      return makeRef(0,std::min(len,(uint)m_rep.size()));
+    }
+
+    /** Like right() but returns a reference to the characters instead of a copy. */
+    QCStringRef rightRef( uint len ) const
+    {
+      uint slen = (uint)m_rep.size();
+      return len<slen ? makeRef(slen-len,len) : makeRef(0,slen);
+    }
+
+    /** Like mid() but returns a reference to the characters instead of a copy. */
+    QCStringRef midRef( uint index, uint len=(uint)-1) const
+    {
+      uint slen = (uint)m_rep.size();
+      if (index>slen) return QCStringRef();
+      return makeRef(index,std::min(len,slen-index));
+    }
+
     QCString lower() const
     {
       std::string s = m_rep;
@@ -353,11 +440,28 @@ class QCString
       return data();
     }
 
-    std::string str() const
+    /** Returns the underlying string */
+    const std::string &str() const &
     {
       return m_rep;
     }
 
+    /** Returns the underlying string, moving it out of a temporary */
+    std::string str() &&
+    {
+      return std::move(m_rep);
+    }
+
+    /** Appends string \a str to this string and returns a reference to the result.
+     *  As for a \c const \c char* argument, \a str is only appended up to its first 0
+     *  character, which matters for strings made with QCString(size) or resize().
+     */
+    QCString &operator+=( const QCString &str )
+    {
+      m_rep.append(str.m_rep.data(),qstrlen(str.data()));
+      return *this;
+    }
+
     /** Appends string \a str to this string and returns a reference to the result. */
     QCString &operator+=( const char *str )
     {
@@ -372,6 +476,13 @@ class QCString
       return *this;
     }
 
+    /** Appends the characters referred to by \a str to this string and returns a reference to the result. */
+    QCString &operator+=( const QCStringRef &str )
+    {
+      m_rep.append(str.data(),str.length());
+      return *this;
+    }
+
     /** Returns a reference to the character at index \a i. */
     char &at( uint i) const
     {
@@ -384,10 +495,28 @@ class QCString
       return const_cast<char&>(m_rep[i]);
     }
 
+    friend QCString operator+( QCString &&s1, const QCString &s2 );
+    friend QCString operator+( QCString &&s1, char c2 );
+
   private:
+    // like operator+=(const QCString&), a reference ends at the first 0 character
+    QCStringRef makeRef( uint index, uint len ) const
+    {
+      const char *p = m_rep.data()+index;
+      const char *end = static_cast<const char *>(std::memchr(p,0,len));
+      return QCStringRef(p,end ? static_cast<uint>(end-p) : len);
+    }
+
     std::string m_rep;
 };
 
+inline QCStringRef::QCStringRef( const QCString &s ) : QCStringRef(s.leftRef(s.length())) {}
+
+inline QCString QCStringRef::toQCString() const
+{
+  return QCString(std::string(m_data,m_len));
+}
+
 /*****************************************************************************
   QCString stream functions
  *****************************************************************************/
@@ -447,7 +576,33 @@ inline bool operator>=( const char *s1, const QCString &s2 )
 
 inline QCString operator+( const QCString &s1, const QCString &s2 )
 {
-  return QCString(s1.str()+s2.str());
+  std::string tmp;
+  tmp.reserve(s1.length()+s2.length());
+  tmp+=s1.str();
+  tmp+=s2.str();
+  return tmp;
+}
+
+// The overloads below take a temporary left hand side and append to it in place,
+// so a chain like a+"::"+b+"::"+c only grows a single buffer.
+
+inline QCString operator+( QCString &&s1, const QCString &s2 )
+{
+  s1.m_rep += s2.m_rep; // like operator+(const QCString&,const QCString&), s2 is appended completely
+  return std::move(s1);
+}
+
+inline QCString operator+( QCString &&s1, const char *s2 )
+{
+  s1 += s2;
+  return std::move(s1);
+}
+
+inline QCString operator+( QCString &&s1, char c2 )
+{
+  s1.m_rep.resize(qstrlen(s1.data())); // like operator+(const QCString&,char)
+  s1.m_rep += c2;
+  return std::move(s1);
 }
 
 
@@ -457,30 +612,40 @@ inline QCString operator+( const QGString &s1, const QCString &s2 );
 
 inline QCString operator+( const QCString &s1, const char *s2 )
 {
-    QCString tmp(s1);
-    tmp += s2;
+    uint l2 = qstrlen(s2);
+    std::string tmp;
+    tmp.reserve(s1.length()+l2);
+    tmp += s1.str();
+    tmp.append(s2 ? s2 : "",l2);
     return tmp;
 }
 
 inline QCString operator+( const char *s1, const QCString &s2 )
 {
-    QCString tmp(s1);
-    tmp += s2;
+    uint l1 = qstrlen(s1);
+    std::string tmp;
+    tmp.reserve(l1+s2.length());
+    tmp.append(s1 ? s1 : "",l1);
+    tmp.append(s2.str().data(),qstrlen(s2.data())); // s2 up to its first 0 character
     return tmp;
 }
 
 inline QCString operator+( const QCString &s1, char c2 )
 {
-    QCString tmp( s1.data() );
+    uint l1 = qstrlen(s1.data()); // s1 up to its first 0 character
+    std::string tmp;
+    tmp.reserve(l1+1);
+    tmp.append(s1.str().data(),l1);
     tmp += c2;
     return tmp;
 }
 
 inline QCString operator+( char c1, const QCString &s2 )
 {
-    QCString tmp;
+    std::string tmp;
+    tmp.reserve(1+s2.length());
     tmp += c1;
-    tmp += s2;
+    tmp.append(s2.str().data(),qstrlen(s2.data())); // s2 up to its first 0 character
     return tmp;
 }
 
@@ -0,0 +1,55 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <stdio.h>
+
+#include <atomic>
+
+#include "binarystream.h"
+#include "portable.h"
+
+bool writeFileAtomically(const QCString &fileName,const std::string &data)
+{
+  // the temporary name is unique per process and call, so concurrent writers never share it
+  static std::atomic<int> tmpIndex{0};
+  QCString tmpName;
+  tmpName.sprintf("%s.%u.%d.tmp",fileName.data(),Portable::pid(),tmpIndex++);
+  FILE *f = Portable::fopen(tmpName,"wb");
+  if (f==0) return false;
+  bool success = fwrite(data.data(),1,data.size(),f)==data.size();
+  success = fclose(f)==0 && success;
+  if (!success || !Portable::rename(tmpName,fileName))
+  {
+    Portable::unlink(tmpName);
+    return false;
+  }
+  return true;
+}
+
+bool readFileToString(const QCString &fileName,std::string &data)
+{
+  FILE *f = Portable::fopen(fileName,"rb");
+  if (f==0) return false;
+  data.clear();
+  char block[4096];
+  size_t n;
+  while ((n=fread(block,1,sizeof(block),f))>0)
+  {
+    data.append(block,n);
+  }
+  bool success = !ferror(f);
+  fclose(f);
+  return success;
+}
@@ -0,0 +1,126 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef BINARYSTREAM_H
+#define BINARYSTREAM_H
+
+#include <string>
+
+#include <qcstring.h>
+
+/** @file
+ *  @brief Helpers for the binary files doxygen keeps between runs,
+ *  such as the parse cache and the tag file index.
+ */
+
+/** Writes values into a binary buffer. Integers use a variable length
+ *  encoding, strings are stored as their length followed by the characters.
+ */
+class BinaryWriter
+{
+  public:
+    BinaryWriter(std::string &buf) : m_buf(buf) {}
+
+    void writeInt(int v)        { writeUInt64(static_cast<uint64>(static_cast<unsigned int>(v))); }
+    void writeBool(bool b)      { m_buf+= b ? '\1' : '\0'; }
+    void writeUInt64(uint64 v)
+    {
+      // variable length encoding: 7 bits per byte, high bit set if more bytes follow
+      while (v>=0x80)
+      {
+        m_buf+=static_cast<char>((v&0x7f)|0x80);
+        v>>=7;
+      }
+      m_buf+=static_cast<char>(v);
+    }
+    void writeString(const char *s,size_t len)
+    {
+      writeUInt64(len);
+      m_buf.append(s,len);
+    }
+    void writeString(const std::string &s) { writeString(s.data(),s.length()); }
+    void writeString(const QCString &s)    { writeString(s.data(),s.length()); }
+
+  private:
+    std::string &m_buf;
+};
+
+/** Reads values from a binary buffer written by BinaryWriter.
+ *  All read methods check the bounds of the buffer; after an error ok()
+ *  returns FALSE and the result should be discarded.
+ */
+class BinaryReader
+{
+  public:
+    BinaryReader(const char *buf,size_t len) : m_buf(buf), m_len(len) {}
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_pos==m_len; }
+
+    uint64 readUInt64()
+    {
+      uint64 v=0;
+      int shift=0;
+      while (m_ok)
+      {
+        if (m_pos>=m_len || shift>63) { m_ok=false; break; }
+        unsigned char c = static_cast<unsigned char>(m_buf[m_pos++]);
+        v|=static_cast<uint64>(c&0x7f)<<shift;
+        if ((c&0x80)==0) break;
+        shift+=7;
+      }
+      return v;
+    }
+    int  readInt()  { return static_cast<int>(static_cast<unsigned int>(readUInt64())); }
+    bool readBool()
+    {
+      if (m_pos>=m_len) { m_ok=false; return false; }
+      return m_buf[m_pos++]!=0;
+    }
+    std::string readString()
+    {
+      uint64 len = readUInt64();
+      if (!m_ok || len>m_len-m_pos) { m_ok=false; return std::string(); }
+      std::string result(m_buf+m_pos,static_cast<size_t>(len));
+      m_pos+=static_cast<size_t>(len);
+      return result;
+    }
+    // reads a count, which can never be larger than the number of remaining bytes
+    size_t readCount()
+    {
+      uint64 n = readUInt64();
+      if (!m_ok || n>m_len-m_pos) { m_ok=false; return 0; }
+      return static_cast<size_t>(n);
+    }
+
+  private:
+    const char *m_buf;
+    size_t m_len;
+    size_t m_pos = 0;
+    bool   m_ok  = true;
+};
+
+/** Writes \a data to \a fileName via a temporary file that replaces
+ *  \a fileName only when it is complete, so a partially written file is
+ *  never picked up. Returns FALSE if the file could not be written.
+ */
+bool writeFileAtomically(const QCString &fileName,const std::string &data);
+
+/** Reads the complete contents of \a fileName into \a data.
+ *  Returns FALSE if the file could not be read.
+ */
+bool readFileToString(const QCString &fileName,std::string &data);
+
+#endif
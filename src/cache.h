@@ -18,8 +18,12 @@
 
 #include <list>
 #include <unordered_map>
+#include <vector>
+#include <memory>
 #include <mutex>
+#include <functional>
 #include <ctype.h>
+#include <stdint.h>
 
 /*! Fixed size cache for value type V using keys of type K.
  *
@@ -159,4 +163,303 @@ class Cache
     uint64_t m_misses=0;
 };
 
+/*! Fixed size cache for value type V using keys of type K that can be used
+ *  from multiple threads.
+ *
+ *  The cache is split into a number of shards, each with its own lock, so threads
+ *  looking up different keys rarely wait for each other. Each shard stores its
+ *  items in a flat open addressing table (linear probing), so no memory is allocated
+ *  per item. When a shard is full an item is evicted using the CLOCK strategy,
+ *  an approximation of LRU: items that were used since the clock hand last passed
+ *  them get a second chance.
+ *
+ *  Values are copied in and out of the cache, since a pointer into the cache could
+ *  be invalidated by another thread at any time.
+ */
+template<typename K,typename V,typename Hash=std::hash<K> >
+class ShardedCache
+{
+  public:
+    //! Statistics of a single shard
+    struct ShardStats
+    {
+      size_t size;
+      size_t capacity;
+      uint64_t hits;
+      uint64_t misses;
+    };
+
+    //! creates a cache that can hold \a capacity elements spread over \a numShards shards.
+    //! The number of shards is rounded up to a power of two.
+    ShardedCache(size_t capacity,size_t numShards=16) : m_capacity(capacity)
+    {
+      size_t n=1;
+      while (n<numShards) n<<=1;
+      m_shardMask = n-1;
+      size_t shardCapacity = (capacity+n-1)/n;
+      for (size_t i=0;i<n;i++)
+      {
+        m_shards.push_back(std::make_unique<Shard>(shardCapacity));
+      }
+    }
+
+    //! Inserts \a value under \a key in the cache, replacing any existing value
+    void insert(const K &key,const V &value)
+    {
+      size_t h = m_hash(key);
+      Shard &s = shard(h);
+      std::lock_guard<std::mutex> lock(s.mutex);
+      s.insert(key,h,value);
+    }
+
+    //! Removes entry \a key from the cache.
+    void remove(const K &key)
+    {
+      size_t h = m_hash(key);
+      Shard &s = shard(h);
+      std::lock_guard<std::mutex> lock(s.mutex);
+      size_t i;
+      if (s.lookup(key,h,i)) s.erase(i);
+    }
+
+    //! Removes all entries for which \a pred(key,value) returns true.
+    void removeIf(const std::function<bool(const K&,const V&)> &pred)
+    {
+      for (auto &sp : m_shards)
+      {
+        Shard &s = *sp;
+        std::lock_guard<std::mutex> lock(s.mutex);
+        size_t i=0;
+        while (i<s.slots.size())
+        {
+          // erase() moves a later item into slot i, so only advance when nothing was removed
+          if (s.slots[i].used && pred(s.slots[i].key,s.slots[i].value))
+          {
+            s.erase(i);
+          }
+          else
+          {
+            i++;
+          }
+        }
+      }
+    }
+
+    //! Finds a value in the cache given the corresponding \a key.
+    //! @returns TRUE and a copy of the value in \a value if the key is found.
+    //! @note The hit and miss counters are updated, see hits() and misses().
+    bool find(const K &key,V &value)
+    {
+      size_t h = m_hash(key);
+      Shard &s = shard(h);
+      std::lock_guard<std::mutex> lock(s.mutex);
+      size_t i;
+      if (s.lookup(key,h,i))
+      {
+        s.slots[i].referenced = true;
+        s.hits++;
+        value = s.slots[i].value;
+        return true;
+      }
+      s.misses++;
+      return false;
+    }
+
+    //! Returns the number of values stored in the cache.
+    size_t size() const
+    {
+      size_t result=0;
+      for (size_t i=0;i<numShards();i++) result+=shardStats(i).size;
+      return result;
+    }
+
+    //! Returns the maximum number of values that can be stored in the cache.
+    size_t capacity() const
+    {
+      return m_capacity;
+    }
+
+    //! Returns how many of the find() calls did find a value in the cache.
+    uint64_t hits() const
+    {
+      uint64_t result=0;
+      for (size_t i=0;i<numShards();i++) result+=shardStats(i).hits;
+      return result;
+    }
+
+    //! Returns how many of the find() calls did not found a value in the cache.
+    uint64_t misses() const
+    {
+      uint64_t result=0;
+      for (size_t i=0;i<numShards();i++) result+=shardStats(i).misses;
+      return result;
+    }
+
+    //! Returns the number of shards.
+    size_t numShards() const
+    {
+      return m_shards.size();
+    }
+
+    //! Returns the statistics for shard \a index.
+    ShardStats shardStats(size_t index) const
+    {
+      const Shard &s = *m_shards[index];
+      std::lock_guard<std::mutex> lock(s.mutex);
+      return ShardStats{ s.size, s.capacity, s.hits, s.misses };
+    }
+
+    //! Clears all values in the cache.
+    void clear()
+    {
+      for (auto &sp : m_shards)
+      {
+        std::lock_guard<std::mutex> lock(sp->mutex);
+        sp->clear();
+      }
+    }
+
+  private:
+    struct Slot
+    {
+      K key;
+      V value;
+      size_t hash = 0;
+      bool used = false;
+      bool referenced = false;
+    };
+
+    struct Shard
+    {
+      Shard(size_t cap) : capacity(cap==0 ? 1 : cap) {}
+
+      // finds the slot index for key, returns FALSE if not found
+      bool lookup(const K &key,size_t h,size_t &index) const
+      {
+        if (slots.empty()) return false;
+        size_t mask = slots.size()-1;
+        for (size_t i=h&mask;slots[i].used;i=(i+1)&mask)
+        {
+          if (slots[i].hash==h && slots[i].key==key)
+          {
+            index=i;
+            return true;
+          }
+        }
+        return false;
+      }
+
+      void insert(const K &key,size_t h,const V &value)
+      {
+        size_t i;
+        if (lookup(key,h,i)) // replace existing value
+        {
+          slots[i].value = value;
+          slots[i].referenced = true;
+          return;
+        }
+        if (size>=capacity) evict();
+        // keep the table at most half full; it grows on demand so that a
+        // large but mostly unused cache does not cost memory
+        if (2*(size+1)>slots.size()) grow();
+        size_t mask = slots.size()-1;
+        for (i=h&mask;slots[i].used;i=(i+1)&mask) {}
+        Slot &slot = slots[i];
+        slot.key        = key;
+        slot.value      = value;
+        slot.hash       = h;
+        slot.used       = true;
+        slot.referenced = false;
+        size++;
+      }
+
+      // removes the item in slot i, moving later items of the same probe sequence back
+      void erase(size_t i)
+      {
+        size_t mask = slots.size()-1;
+        size_t j = i;
+        while (true)
+        {
+          j=(j+1)&mask;
+          if (!slots[j].used) break;
+          size_t ideal = slots[j].hash&mask;
+          // the item at j can fill the hole at i unless its ideal slot lies cyclically in (i,j]
+          bool stays = i<=j ? (i<ideal && ideal<=j) : (i<ideal || ideal<=j);
+          if (!stays)
+          {
+            slots[i] = std::move(slots[j]);
+            i=j;
+          }
+        }
+        slots[i] = Slot();
+        size--;
+      }
+
+      // CLOCK eviction: skip (and clear) referenced items, remove the first unreferenced one
+      void evict()
+      {
+        size_t mask = slots.size()-1;
+        while (true)
+        {
+          Slot &slot = slots[hand];
+          if (slot.used)
+          {
+            if (!slot.referenced)
+            {
+              erase(hand);
+              return;
+            }
+            slot.referenced = false;
+          }
+          hand=(hand+1)&mask;
+        }
+      }
+
+      void grow()
+      {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(old.empty() ? 16 : 2*old.size());
+        size_t mask = slots.size()-1;
+        for (auto &slot : old)
+        {
+          if (slot.used)
+          {
+            size_t i;
+            for (i=slot.hash&mask;slots[i].used;i=(i+1)&mask) {}
+            slots[i] = std::move(slot);
+          }
+        }
+        hand = 0;
+      }
+
+      void clear()
+      {
+        slots.clear();
+        size = 0;
+        hand = 0;
+      }
+
+      mutable std::mutex mutex;
+      std::vector<Slot> slots;
+      size_t capacity;
+      size_t size = 0;
+      size_t hand = 0;   // position of the clock hand
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+    };
+
+    Shard &shard(size_t h)
+    {
+      // use the upper bits of the hash, the lower ones select the slot within the shard
+      uint64_t x = static_cast<uint64_t>(h)*0x9E3779B97F4A7C15ULL;
+      return *m_shards[(x>>40)&m_shardMask];
+    }
+
+    size_t m_capacity;
+    size_t m_shardMask;
+    std::vector< std::unique_ptr<Shard> > m_shards;
+    Hash m_hash;
+};
+
 #endif
@@ -19,6 +19,7 @@
 #include <iterator>
 #include <unordered_map>
 #include <string>
+#include <mutex>
 
 #include <ctype.h>
 #include <qregexp.h>
@@ -619,6 +620,7 @@ class FilterCache
     FilterCache() : m_endPos(0) { }
     bool getFileContents(const QCString &fileName,BufStr &str)
     {
+      std::lock_guard<std::mutex> lock(m_mutex);
       static bool filterSourceFiles = Config_getBool(FILTER_SOURCE_FILES);
       QCString filter = getFileFilter(fileName,TRUE);
       bool usePipe = !filter.isEmpty() && filterSourceFiles;
@@ -729,6 +731,7 @@ class FilterCache
   private:
     std::unordered_map<std::string,FilterCacheItem> m_cache;
     portable_off_t m_endPos;
+    std::mutex m_mutex;
 };
 
 static FilterCache g_filterCache;
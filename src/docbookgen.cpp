@@ -158,14 +158,14 @@ DocbookCodeGenerator::~DocbookCodeGenerator() {}
 void DocbookCodeGenerator::codify(const char *text)
 {
   Docbook_DB(("(codify \"%s\")\n",text));
-  writeDocbookCodeString(m_t,text,m_col);
+  writeDocbookCodeString(*m_t,text,m_col);
 }
 void DocbookCodeGenerator::writeCodeLink(const char *ref,const char *file,
     const char *anchor,const char *name,
     const char *tooltip)
 {
   Docbook_DB(("(writeCodeLink)\n"));
-  writeDocbookLink(m_t,ref,file,anchor,name,tooltip);
+  writeDocbookLink(*m_t,ref,file,anchor,name,tooltip);
   m_col+=(int)strlen(name);
 }
 void DocbookCodeGenerator::writeCodeLinkLine(const char *,const char *file,
@@ -173,10 +173,10 @@ void DocbookCodeGenerator::writeCodeLinkLine(const char *,const char *file,
     const char *)
 {
   Docbook_DB(("(writeCodeLinkLine)\n"));
-  m_t << "<anchor xml:id=\"_" << stripExtensionGeneral(stripPath(file),".xml");
-  m_t << "_1l";
-  writeDocbookString(m_t,name);
-  m_t << "\"/>";
+  *m_t << "<anchor xml:id=\"_" << stripExtensionGeneral(stripPath(file),".xml");
+  *m_t << "_1l";
+  writeDocbookString(*m_t,name);
+  *m_t << "\"/>";
   m_col+=(int)strlen(name);
 }
 void DocbookCodeGenerator::writeTooltip(const char *, const DocLinkInfo &, const char *,
@@ -193,7 +193,7 @@ void DocbookCodeGenerator::startCodeLine(bool)
 }
 void DocbookCodeGenerator::endCodeLine()
 {
-  if (m_insideCodeLine) m_t << endl;
+  if (m_insideCodeLine) *m_t << endl;
   Docbook_DB(("(endCodeLine)\n"));
   m_lineNumber = -1;
   m_refId.resize(0);
@@ -203,13 +203,13 @@ void DocbookCodeGenerator::endCodeLine()
 void DocbookCodeGenerator::startFontClass(const char *colorClass)
 {
   Docbook_DB(("(startFontClass)\n"));
-  m_t << "<emphasis role=\"" << colorClass << "\">";
+  *m_t << "<emphasis role=\"" << colorClass << "\">";
   m_insideSpecialHL=TRUE;
 }
 void DocbookCodeGenerator::endFontClass()
 {
   Docbook_DB(("(endFontClass)\n"));
-  m_t << "</emphasis>"; // non DocBook
+  *m_t << "</emphasis>"; // non DocBook
   m_insideSpecialHL=FALSE;
 }
 void DocbookCodeGenerator::writeCodeAnchor(const char *)
@@ -235,11 +235,11 @@ void DocbookCodeGenerator::writeLineNumber(const char *ref,const char *fileName,
     {
       codify(lineNumber);
     }
-    m_t << " ";
+    *m_t << " ";
   }
   else
   {
-    m_t << l << " ";
+    *m_t << l << " ";
   }
   m_col=0;
 }
@@ -255,17 +255,17 @@ void DocbookCodeGenerator::finish()
 }
 void DocbookCodeGenerator::startCodeFragment(const char *)
 {
-DB_GEN_C1(m_t)
-  m_t << "<programlisting>";
+DB_GEN_C1(*m_t)
+  *m_t << "<programlisting>";
 }
 
 void DocbookCodeGenerator::endCodeFragment(const char *)
 {
-DB_GEN_C1(m_t)
+DB_GEN_C1(*m_t)
   //endCodeLine checks is there is still an open code line, if so closes it.
   endCodeLine();
 
-  m_t << "</programlisting>";
+  *m_t << "</programlisting>";
 }
 
 //-------------------------------------------------------------------------------
@@ -27,7 +27,7 @@ class DocbookCodeGenerator : public CodeOutputInterface
     void setTextStream(FTextStream &t)
     {
       m_streamSet = t.device()!=0;
-      m_t.setDevice(t.device());
+      m_t = &t;
     }
     void setRelativePath(const QCString &path) { m_relPath = path; }
     void setSourceFileName(const QCString &sourceFileName) { m_sourceFileName = sourceFileName; }
@@ -57,7 +57,7 @@ class DocbookCodeGenerator : public CodeOutputInterface
     void endCodeFragment(const char *style);
 
   private:
-    FTextStream m_t;
+    FTextStream *m_t = 0;
     bool m_streamSet = false;
     QCString m_refId;
     QCString m_external;
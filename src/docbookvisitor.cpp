@@ -341,16 +341,12 @@ DB_VIS_C
       break;
     case DocVerbatim::Dot:
       {
-        static int dotindex = 1;
-        QCString baseName(4096);
-        QCString name;
+        static AtomicInt dotindex(1);
+        QCString graphName = inlineGraphName("inline_dotgraph_",dotindex);
+        QCString name = "dot_"+graphName;
+        QCString baseName = Config_getString(DOCBOOK_OUTPUT)+"/"+graphName;
         QCString stext = s->text();
         m_t << "<para>" << endl;
-        name.sprintf("%s%d", "dot_inline_dotgraph_", dotindex);
-        baseName.sprintf("%s%d",
-            (Config_getString(DOCBOOK_OUTPUT)+"/inline_dotgraph_").data(),
-            dotindex++
-            );
         QFile file(baseName+".dot");
         if (!file.open(IO_WriteOnly))
         {
@@ -365,16 +361,12 @@ DB_VIS_C
       break;
     case DocVerbatim::Msc:
       {
-        static int mscindex = 1;
-        QCString baseName(4096);
-        QCString name;
+        static AtomicInt mscindex(1);
+        QCString graphName = inlineGraphName("inline_mscgraph_",mscindex);
+        QCString name = "msc_"+graphName;
+        QCString baseName = Config_getString(DOCBOOK_OUTPUT)+"/"+graphName;
         QCString stext = s->text();
         m_t << "<para>" << endl;
-        name.sprintf("%s%d", "msc_inline_mscgraph_", mscindex);
-        baseName.sprintf("%s%d",
-            (Config_getString(DOCBOOK_OUTPUT)+"/inline_mscgraph_").data(),
-            mscindex++
-            );
         QFile file(baseName+".msc");
         if (!file.open(IO_WriteOnly))
         {
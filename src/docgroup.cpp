@@ -19,6 +19,7 @@
 #include "entry.h"
 #include "message.h"
 #include "docgroup.h"
+#include "parsecache.h"
 
 static std::atomic_int g_groupId;
 
@@ -117,6 +118,7 @@ void DocGroup::open(Entry *e,const char *,int, bool implicit)
     //printf("    membergroup id=%d %s\n",m_memberGroupId,m_memberGroupHeader.data());
     if (m_memberGroupId==DOX_NOGROUP) // no group started yet
     {
+      ParseCache::markUncacheable(); // member groups are stored globally
       auto info = std::make_unique<MemberGroupInfo>();
       info->header = m_memberGroupHeader.stripWhiteSpace();
       info->compoundName = m_compoundName;
@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <cassert>
+#include <mutex>
 
 #include <qfile.h>
 #include <qfileinfo.h>
@@ -88,35 +89,36 @@ using DefinitionStack = std::vector<const Definition *>;
 using DocNodeStack = std::stack<const DocNode *>;
 using DocStyleChangeStack = std::stack<const DocStyleChange *>;
 
-// Parser state: global variables during a call to validatingParseDoc
-static const Definition *     g_scope;
-static QCString               g_context;
-static bool                   g_inSeeBlock;
-static bool                   g_xmlComment;
-static bool                   g_insideHtmlLink;
-static DocNodeStack           g_nodeStack;
-static DocStyleChangeStack    g_styleStack;
-static DocStyleChangeStack    g_initialStyleStack;
-static DefinitionStack        g_copyStack;
-static QCString               g_fileName;
-static QCString               g_relPath;
-
-static bool                   g_hasParamCommand;
-static bool                   g_hasReturnCommand;
-static StringSet              g_retvalsFound;
-static StringSet              g_paramsFound;
-static const MemberDef *      g_memberDef;
-static bool                   g_isExample;
-static QCString               g_exampleName;
-static QCString               g_searchUrl;
-
-static QCString               g_includeFileName;
-static QCString               g_includeFileText;
-static uint                   g_includeFileOffset;
-static uint                   g_includeFileLength;
-static int                    g_includeFileLine;
-static bool                   g_includeFileShowLineNo;
-static bool                   g_markdownSupport;
+// Parser state: global variables during a call to validatingParseDoc.
+// They are thread local, so several threads can parse documentation at once.
+static THREAD_LOCAL const Definition *     g_scope;
+static THREAD_LOCAL QCString               g_context;
+static THREAD_LOCAL bool                   g_inSeeBlock;
+static THREAD_LOCAL bool                   g_xmlComment;
+static THREAD_LOCAL bool                   g_insideHtmlLink;
+static THREAD_LOCAL DocNodeStack           g_nodeStack;
+static THREAD_LOCAL DocStyleChangeStack    g_styleStack;
+static THREAD_LOCAL DocStyleChangeStack    g_initialStyleStack;
+static THREAD_LOCAL DefinitionStack        g_copyStack;
+static THREAD_LOCAL QCString               g_fileName;
+static THREAD_LOCAL QCString               g_relPath;
+
+static THREAD_LOCAL bool                   g_hasParamCommand;
+static THREAD_LOCAL bool                   g_hasReturnCommand;
+static THREAD_LOCAL StringSet              g_retvalsFound;
+static THREAD_LOCAL StringSet              g_paramsFound;
+static THREAD_LOCAL const MemberDef *      g_memberDef;
+static THREAD_LOCAL bool                   g_isExample;
+static THREAD_LOCAL QCString               g_exampleName;
+static THREAD_LOCAL QCString               g_searchUrl;
+
+static THREAD_LOCAL QCString               g_includeFileName;
+static THREAD_LOCAL QCString               g_includeFileText;
+static THREAD_LOCAL uint                   g_includeFileOffset;
+static THREAD_LOCAL uint                   g_includeFileLength;
+static THREAD_LOCAL int                    g_includeFileLine;
+static THREAD_LOCAL bool                   g_includeFileShowLineNo;
+static THREAD_LOCAL bool                   g_markdownSupport;
 
 
 /** Parser's context to store all global variables.
@@ -154,7 +156,7 @@ struct DocParserContext
   TokenInfo *token;
 };
 
-static std::stack< std::unique_ptr<DocParserContext> > g_parserStack;
+static THREAD_LOCAL std::stack< std::unique_ptr<DocParserContext> > g_parserStack;
 
 //---------------------------------------------------------------------------
 
@@ -299,6 +301,10 @@ static void unescapeCRef(QCString &s)
  * copies the image to the output directory (which depends on the \a type
  * parameter).
  */
+// serializes copying images to the output directories, since the same image
+// can be referenced from pages that are parsed by different threads
+static std::mutex g_copyImageMutex;
+
 static QCString findAndCopyImage(const char *fileName,DocImage::Type type, bool dowarn = true)
 {
   QCString result;
@@ -316,6 +322,7 @@ static QCString findAndCopyImage(const char *fileName,DocImage::Type type, bool
       warn_doc_error(g_fileName,getDoctokinizerLineNr(),"%s", text.data());
     }
 
+    std::lock_guard<std::mutex> lock(g_copyImageMutex);
     QCString inputFile = fd->absFilePath();
     QFile inImage(inputFile);
     if (inImage.open(IO_ReadOnly))
@@ -112,9 +112,8 @@ struct TokenInfo
   ParamDir paramDir = Unspecified;
 };
 
-// globals
-extern TokenInfo *g_token;
-extern FILE *doctokenizerYYin;
+// globals (one instance per thread)
+extern thread_local TokenInfo *g_token;
 
 // helper functions
 const char *tokToString(int token);
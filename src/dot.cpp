@@ -15,6 +15,7 @@
 
 #include <cstdlib>
 #include <cassert>
+#include <algorithm>
 
 #include <qdir.h>
 
@@ -22,9 +23,11 @@
 #include "dot.h"
 #include "dotrunner.h"
 #include "dotfilepatcher.h"
+#include "dotgraphcache.h"
 #include "util.h"
 #include "portable.h"
 #include "message.h"
+#include "debug.h"
 #include "ftextstream.h"
 #include "doxygen.h"
 #include "language.h"
@@ -71,6 +74,32 @@ static void unsetDotFontPath()
   g_dotFontPath="";
 }
 
+// sets the font path to the directory of the first output format that uses graphs
+static bool setDotFontPathForOutput()
+{
+  if (Config_getBool(GENERATE_HTML))
+  {
+    setDotFontPath(Config_getString(HTML_OUTPUT));
+    return TRUE;
+  }
+  else if (Config_getBool(GENERATE_LATEX))
+  {
+    setDotFontPath(Config_getString(LATEX_OUTPUT));
+    return TRUE;
+  }
+  else if (Config_getBool(GENERATE_RTF))
+  {
+    setDotFontPath(Config_getString(RTF_OUTPUT));
+    return TRUE;
+  }
+  else if (Config_getBool(GENERATE_DOCBOOK))
+  {
+    setDotFontPath(Config_getString(DOCBOOK_OUTPUT));
+    return TRUE;
+  }
+  return FALSE;
+}
+
 //--------------------------------------------------------------------
 
 DotManager *DotManager::m_theInstance = 0;
@@ -111,6 +140,8 @@ DotManager::DotManager() : m_runners(), m_filePatchers()
     }
     ASSERT(m_workers.size()>0);
   }
+  m_pipelined = Config_getBool(DOT_PIPELINE) && !m_workers.empty();
+  DotGraphCache::instance().init();
 }
 
 DotManager::~DotManager()
@@ -120,6 +151,7 @@ DotManager::~DotManager()
 
 DotRunner* DotManager::createRunner(const std::string &absDotName, const std::string& md5Hash)
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   DotRunner* rv = nullptr;
   auto const runit = m_runners.find(absDotName);
   if (runit == m_runners.end())
@@ -141,8 +173,29 @@ DotRunner* DotManager::createRunner(const std::string &absDotName, const std::st
   return rv;
 }
 
+DotRunner* DotManager::findRunner(const std::string &absDotName)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto const runit = m_runners.find(absDotName);
+  return runit==m_runners.end() ? nullptr : runit->second.get();
+}
+
+void DotManager::submitRunner(DotRunner *runner)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_pipelined || runner->isPipelined()) return;
+  if (!m_fontPathChecked)
+  {
+    m_fontPathSet = setDotFontPathForOutput();
+    m_fontPathChecked = true;
+  }
+  runner->setPipelined();
+  m_queue->enqueue(runner);
+}
+
 DotFilePatcher *DotManager::createFilePatcher(const std::string &fileName)
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   auto patcher = m_filePatchers.find(fileName);
 
   if (patcher != m_filePatchers.end()) return &(patcher->second);
@@ -169,38 +222,64 @@ bool DotManager::run() const
   }
   size_t i=1;
 
-  bool setPath=FALSE;
-  if (Config_getBool(GENERATE_HTML))
-  {
-    setDotFontPath(Config_getString(HTML_OUTPUT));
-    setPath=TRUE;
-  }
-  else if (Config_getBool(GENERATE_LATEX))
-  {
-    setDotFontPath(Config_getString(LATEX_OUTPUT));
-    setPath=TRUE;
-  }
-  else if (Config_getBool(GENERATE_RTF))
-  {
-    setDotFontPath(Config_getString(RTF_OUTPUT));
-    setPath=TRUE;
-  }
-  else if (Config_getBool(GENERATE_DOCBOOK))
+  bool setPath = m_fontPathSet;
+  if (!m_fontPathChecked)
   {
-    setDotFontPath(Config_getString(DOCBOOK_OUTPUT));
-    setPath=TRUE;
+    setPath = setDotFontPathForOutput();
   }
   Portable::sysTimerStart();
   // fill work queue with dot operations
   size_t prev=1;
   if (m_workers.size()==0) // no threads to work with
   {
+    size_t batchSize = static_cast<size_t>(Config_getInt(DOT_BATCH_SIZE));
+    std::vector<DotRunner*> batch;
     for (auto & dr : m_runners)
     {
       msg("Running dot for graph %zu/%zu\n",prev,numDotRuns);
-      dr.second->run();
+      DotRunner *runner = dr.second.get();
+      if (batchSize>1 && runner->canBatch())
+      {
+        // collect graphs with the same output formats and render them together
+        if (!batch.empty() && batch.front()->batchSignature()!=runner->batchSignature())
+        {
+          DotRunner::runBatch(batch);
+          batch.clear();
+        }
+        batch.push_back(runner);
+        if (batch.size()>=batchSize)
+        {
+          DotRunner::runBatch(batch);
+          batch.clear();
+        }
+      }
+      else
+      {
+        runner->run();
+      }
       prev++;
     }
+    DotRunner::runBatch(batch);
+  }
+  else if (m_pipelined) // most graphs are queued already while the output was generated
+  {
+    for (auto & dr: m_runners)
+    {
+      DotRunner *runner = dr.second.get();
+      if (!runner->isPipelined())
+      {
+        runner->setPipelined();
+        m_queue->enqueue(runner);
+      }
+      else if (runner->hasLateJobs())
+      {
+        // the jobs added after the runner was queued need another run
+        runner->waitUntilFinished();
+        runner->activateLateJobs();
+        m_queue->enqueue(runner);
+      }
+    }
+    msg("Waiting for %zu of %zu dot graphs...\n",m_queue->size(),numDotRuns);
   }
   else // use multiple threads to run instances of dot in parallel
   {
@@ -224,25 +303,73 @@ bool DotManager::run() const
       msg("Running dot for graph %zu/%zu\n",prev,numDotRuns);
       prev++;
     }
-    // signal the workers we are done
-    for (i=0;i<m_workers.size();i++)
+    stopWorkers();
+  }
+
+  if (!m_pipelined)
+  {
+    Portable::sysTimerStop();
+    if (setPath)
     {
-      m_queue->enqueue(0); // add terminator for each worker
+      unsetDotFontPath();
     }
-    // wait for the workers to finish
-    for (i=0;i<m_workers.size();i++)
+  }
+
+  // patch the output file and insert the maps and figures. In pipelined mode
+  // each file only waits for the graphs it includes.
+  bool result = patchFiles();
+
+  if (m_pipelined)
+  {
+    stopWorkers();
+    for (const auto &dr : m_runners)
+    {
+      dr.second->cleanUp();
+    }
+    Portable::sysTimerStop();
+    if (setPath)
     {
-      m_workers.at(i)->wait();
+      unsetDotFontPath();
     }
   }
-  Portable::sysTimerStop();
-  if (setPath)
+  if (Debug::isFlagSet(Debug::ExtCmd) && numDotRuns>0)
   {
-    unsetDotFontPath();
+    // report the graphs that took longest to render
+    std::vector<const DotRunner*> runners;
+    for (const auto &dr : m_runners) runners.push_back(dr.second.get());
+    size_t numReported = QMIN(runners.size(),static_cast<size_t>(10));
+    std::partial_sort(runners.begin(),runners.begin()+numReported,runners.end(),
+        [](const DotRunner *a,const DotRunner *b) { return a->elapsedTime()>b->elapsedTime(); });
+    Debug::print(Debug::ExtCmd,0,"Slowest dot graphs:\n");
+    for (size_t j=0;j<numReported;j++)
+    {
+      Debug::print(Debug::ExtCmd,0,"  %8.3f s  cost %6d  %s\n",runners[j]->elapsedTime(),
+          runners[j]->layoutCost(),runners[j]->fileName().c_str());
+    }
   }
+  DotGraphCache::instance().printStatistics();
 
-  // patch the output file and insert the maps and figures
-  i=1;
+  return result;
+}
+
+void DotManager::stopWorkers() const
+{
+  // signal the workers we are done
+  for (size_t i=0;i<m_workers.size();i++)
+  {
+    m_queue->enqueue(0); // add terminator for each worker
+  }
+  // wait for the workers to finish
+  for (size_t i=0;i<m_workers.size();i++)
+  {
+    m_workers.at(i)->wait();
+  }
+}
+
+bool DotManager::patchFiles() const
+{
+  size_t numFilePatchers = m_filePatchers.size();
+  size_t i=1;
   // since patching the svg files may involve patching the header of the SVG
   // (for zoomable SVGs), and patching the .html files requires reading that
   // header after the SVG is patched, we first process the .svg files and
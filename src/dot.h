@@ -18,6 +18,7 @@
 
 #include <qcstring.h>
 #include <map>
+#include <mutex>
 
 #include "dotgraph.h" // only for GraphOutputFormat
 #include "dotfilepatcher.h"
@@ -34,18 +35,30 @@ class DotManager
     static DotManager *instance();
     static void deleteInstance();
     DotRunner*      createRunner(const std::string& absDotName, const std::string& md5Hash);
+    /** Returns the runner for \a absDotName, or nullptr if there is none yet */
+    DotRunner*      findRunner(const std::string& absDotName);
+    /** Hands \a runner to the worker threads right away if DOT_PIPELINE is enabled,
+     *  otherwise it is run by run(). All jobs must have been added to it.
+     */
+    void            submitRunner(DotRunner *runner);
     DotFilePatcher *createFilePatcher(const std::string &fileName);
     bool run() const;
 
   private:
     DotManager();
     virtual ~DotManager();
+    void stopWorkers() const;
+    bool patchFiles() const;
 
     std::map<std::string, std::unique_ptr<DotRunner>>       m_runners;
     std::map<std::string, DotFilePatcher>  m_filePatchers;
     static DotManager     *m_theInstance;
     DotRunnerQueue        *m_queue;
     std::vector< std::unique_ptr<DotWorkerThread> > m_workers;
+    std::mutex            m_mutex; // protects m_runners and m_filePatchers
+    bool                  m_pipelined = false;
+    bool                  m_fontPathSet = false;
+    bool                  m_fontPathChecked = false;
 };
 
 void writeDotGraphFromFile(const char *inFile,const char *outDir,
@@ -170,7 +170,8 @@ void DotCallGraph::computeTheGraph()
     FALSE,
     m_inverse,
     m_startNode->label(),
-    m_theGraph);
+    m_theGraph,
+    m_graphSize);
 }
 
 QCString DotCallGraph::getMapLabel() const
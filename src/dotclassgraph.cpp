@@ -401,7 +401,8 @@ void DotClassGraph::computeTheGraph()
     m_graphType == Inheritance,
     TRUE,
     m_startNode->label(),
-    m_theGraph
+    m_theGraph,
+    m_graphSize
   );
 }
 
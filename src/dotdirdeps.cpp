@@ -46,7 +46,7 @@ static void drawDirectory(FTextStream &outStream, const DirDef *const directory,
   directoriesInGraph.insert(std::make_pair(directory->getOutputFileBase().str(), directory));
 }
 
-void writeDotDirDepGraph(FTextStream &t,const DirDef *dd,bool linkRelations)
+void writeDotDirDepGraph(FTextStream &t,const DirDef *dd,bool linkRelations,DotGraphSize &graphSize)
 {
   int fontSize = Config_getInt(DOT_FONTSIZE);
   QCString fontName = Config_getString(DOT_FONTNAME);
@@ -175,11 +175,13 @@ void writeDotDirDepGraph(FTextStream &t,const DirDef *dd,bool linkRelations)
           t << " headhref=\"" << relationName << Doxygen::htmlFileExtension << "\"";
         }
         t << "];\n";
+        graphSize.numEdges++;
       }
     }
   }
 
   t << "}\n";
+  graphSize.numNodes = static_cast<int>(dirsInGraph.size());
 }
 
 DotDirDeps::DotDirDeps(const DirDef *dir) : m_dir(dir)
@@ -201,7 +203,7 @@ void DotDirDeps::computeTheGraph()
   // compute md5 checksum of the graph were are about to generate
   FTextStream md5stream(&m_theGraph);
   //m_dir->writeDepGraph(md5stream);
-  writeDotDirDepGraph(md5stream,m_dir,m_linkRelations);
+  writeDotDirDepGraph(md5stream,m_dir,m_linkRelations,m_graphSize);
 }
 
 QCString DotDirDeps::getMapLabel() const
@@ -13,6 +13,8 @@
 *
 */
 
+#include <algorithm>
+
 #include "dotfilepatcher.h"
 #include "dotrunner.h"
 
@@ -296,9 +298,21 @@ int DotFilePatcher::addSVGObject(const QCString &baseName,
   return id;
 }
 
+void DotFilePatcher::addDependency(DotRunner *runner)
+{
+  if (runner && std::find(m_dependencies.begin(),m_dependencies.end(),runner)==m_dependencies.end())
+  {
+    m_dependencies.push_back(runner);
+  }
+}
+
 bool DotFilePatcher::run() const
 {
   //printf("DotFilePatcher::run(): %s\n",m_patchFile.data());
+  for (const auto &runner : m_dependencies)
+  {
+    runner->waitUntilFinished();
+  }
   bool interactiveSVG_local = Config_getBool(INTERACTIVE_SVG);
   bool isSVGFile = m_patchFile.right(4)==".svg";
   int graphId = -1;
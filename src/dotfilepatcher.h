@@ -21,6 +21,7 @@
 #include "qcstring.h"
 
 class FTextStream;
+class DotRunner;
 
 /** Helper class to insert a set of map file into an output file */
 class DotFilePatcher
@@ -39,6 +40,9 @@ class DotFilePatcher
 
     int addSVGObject(const QCString &baseName, const QCString &figureName,
                      const QCString &relPath);
+    /** Registers that the patch needs the output of \a runner */
+    void addDependency(DotRunner *runner);
+    /** Waits for the runners this file depends on and patches the file */
     bool run() const;
     bool isSVGFile() const;
 
@@ -68,6 +72,7 @@ class DotFilePatcher
       int      graphId;
     };
     std::vector<Map> m_maps;
+    std::vector<DotRunner *> m_dependencies;
     QCString m_patchFile;
 };
 
@@ -47,7 +47,7 @@ void DotGfxHierarchyTable::computeTheGraph()
   {
     if (node->subgraphId()==m_rootSubgraphNode->subgraphId())
     {
-      node->write(md5stream,Hierarchy,GOF_BITMAP,FALSE,TRUE,TRUE);
+      node->write(md5stream,Hierarchy,GOF_BITMAP,FALSE,TRUE,TRUE,&m_graphSize);
     }
   }
   writeGraphFooter(md5stream);
@@ -13,6 +13,8 @@
 *
 */
 
+#include <mutex>
+
 #include "config.h"
 #include "doxygen.h"
 #include "index.h"
@@ -25,9 +27,15 @@
 #include "dotgraph.h"
 #include "dotnode.h"
 #include "dotfilepatcher.h"
+#include "dotlayout.h"
+#include "dotgraphcache.h"
 
 #define MAP_CMD "cmapx"
 
+// serializes writing the dot files and registering the runners and file patchers
+// for graphs that are written from multiple threads.
+static std::mutex g_dotGraphMutex;
+
 //QCString DotGraph::DOT_FONTNAME; // will be initialized in initDot
 //int DotGraph::DOT_FONTSIZE;      // will be initialized in initDot
 
@@ -56,6 +64,16 @@ static bool checkMd5Signature(const QCString &baseName,
   return TRUE;
 }
 
+static void writeMd5Signature(const QCString &baseName,
+                              const QCString &md5)
+{
+  QFile f(baseName+".md5");
+  if (f.open(IO_WriteOnly))
+  {
+    f.writeBlock(md5.data(),32);
+  }
+}
+
 static bool checkDeliverables(const QCString &file1,
                               const QCString &file2=QCString())
 {
@@ -123,8 +141,11 @@ QCString DotGraph::writeGraph(
   m_absPath  = QCString(m_dir.absPath().data()) + "/";
   m_baseName = getBaseName();
 
+  m_graphSize = DotGraphSize();
   computeTheGraph();
 
+  std::lock_guard<std::mutex> lock(g_dotGraphMutex);
+
   m_regenerate = prepareDotFile();
 
   if (!m_doNotAddImageToIndex) Doxygen::indexList->addImageFile(imgName());
@@ -140,11 +161,23 @@ bool DotGraph::prepareDotFile()
   {
     term("Output dir %s does not exist!\n", m_dir.path().data());
   }
+  m_dotRunner = nullptr;
+
+  // small graphs can be laid out without running dot
+  int builtinMaxNodes = Config_getInt(DOT_BUILTIN_LAYOUT_MAX_NODES);
+  DotLayout builtinLayout;
+  bool useBuiltin = builtinMaxNodes>0 && m_graphFormat==GOF_BITMAP && getDotImageExtension()=="svg" &&
+                    builtinLayout.prepare(m_theGraph.data(),builtinMaxNodes);
 
   QCString sigStr(33);
   uchar md5_sig[16];
-  // calculate md5
-  MD5Buffer((const unsigned char*)m_theGraph.data(), m_theGraph.length(), md5_sig);
+  // calculate md5, including the renderer so the image is regenerated when that changes
+  const char *renderer = useBuiltin ? "builtin" : "dot";
+  MD5Context ctx;
+  MD5Init(&ctx);
+  MD5Update(&ctx,(const unsigned char*)m_theGraph.data(),m_theGraph.length());
+  MD5Update(&ctx,(const unsigned char*)renderer,qstrlen(renderer));
+  MD5Final(md5_sig,&ctx);
   // convert result to a string
   MD5SigToString(md5_sig, sigStr.rawData(), 33);
 
@@ -161,38 +194,75 @@ bool DotGraph::prepareDotFile()
   }
 
   // need to rebuild the image
+  DotManager *dotManager = DotManager::instance();
+  bool newRunner = dotManager->findRunner(absDotName().data())==nullptr;
+
+  // graphs rendered before, possibly by another run or project, can be taken from the cache
+  DotGraphCache &cache = DotGraphCache::instance();
+  if (newRunner && cache.isEnabled())
+  {
+    bool restored = FALSE;
+    if (m_graphFormat == GOF_BITMAP)
+    {
+      restored = cache.restore(sigStr,Config_getEnum(DOT_IMAGE_FORMAT),absImgName()) &&
+                 (!m_generateImageMap || cache.restore(sigStr,MAP_CMD,absMapName()));
+    }
+    else if (m_graphFormat == GOF_EPS)
+    {
+      restored = cache.restore(sigStr,Config_getBool(USE_PDFLATEX) ? "pdf" : "ps",absImgName());
+    }
+    if (restored)
+    {
+      writeMd5Signature(absBaseName(),sigStr);
+      return TRUE;
+    }
+  }
 
-  // write .dot file because image was new or has changed
-  QFile f(absDotName());
-  if (!f.open(IO_WriteOnly))
+  if (newRunner && useBuiltin &&
+      builtinLayout.writeSvg(absImgName(),m_generateImageMap ? absMapName() : QCString()))
   {
-    err("Could not open file %s for writing\n",f.name().data());
+    writeMd5Signature(absBaseName(),sigStr);
     return TRUE;
   }
-  FTextStream t(&f);
-  t << m_theGraph;
-  f.close();
+
+  // write .dot file because image was new or has changed. If there is a runner
+  // for it already, the file is there and dot may be reading it right now.
+  if (newRunner)
+  {
+    QFile f(absDotName());
+    if (!f.open(IO_WriteOnly))
+    {
+      err("Could not open file %s for writing\n",f.name().data());
+      return TRUE;
+    }
+    FTextStream t(&f);
+    t << m_theGraph;
+    f.close();
+  }
 
   if (m_graphFormat == GOF_BITMAP)
   {
     // run dot to create a bitmap image
-    DotRunner * dotRun = DotManager::instance()->createRunner(absDotName().data(), sigStr.data());
-    dotRun->addJob(Config_getEnum(DOT_IMAGE_FORMAT), absImgName());
-    if (m_generateImageMap) dotRun->addJob(MAP_CMD, absMapName());
+    m_dotRunner = dotManager->createRunner(absDotName().data(), sigStr.data());
+    if (newRunner) m_dotRunner->setLayoutCost(m_graphSize.numNodes+m_graphSize.numEdges);
+    m_dotRunner->addJob(Config_getEnum(DOT_IMAGE_FORMAT), absImgName());
+    if (m_generateImageMap) m_dotRunner->addJob(MAP_CMD, absMapName());
   }
   else if (m_graphFormat == GOF_EPS)
   {
     // run dot to create a .eps image
-    DotRunner *dotRun = DotManager::instance()->createRunner(absDotName().data(), sigStr.data());
+    m_dotRunner = dotManager->createRunner(absDotName().data(), sigStr.data());
+    if (newRunner) m_dotRunner->setLayoutCost(m_graphSize.numNodes+m_graphSize.numEdges);
     if (Config_getBool(USE_PDFLATEX))
     {
-      dotRun->addJob("pdf",absImgName());
+      m_dotRunner->addJob("pdf",absImgName());
     }
     else
     {
-      dotRun->addJob("ps",absImgName());
+      m_dotRunner->addJob("ps",absImgName());
     }
   }
+  if (m_dotRunner) dotManager->submitRunner(m_dotRunner);
   return TRUE;
 }
 
@@ -222,13 +292,13 @@ void DotGraph::generateCode(FTextStream &t)
       {
         if (m_regenerate)
         {
-          DotManager::instance()->
-               createFilePatcher(absImgName().data())->
-               addSVGConversion(m_relPath,FALSE,QCString(),m_zoomable,m_graphId);
+          DotFilePatcher *svgPatcher = DotManager::instance()->createFilePatcher(absImgName().data());
+          svgPatcher->addSVGConversion(m_relPath,FALSE,QCString(),m_zoomable,m_graphId);
+          svgPatcher->addDependency(m_dotRunner);
         }
-        int mapId = DotManager::instance()->
-               createFilePatcher(m_fileName.data())->
-               addSVGObject(m_baseName,absImgName(),m_relPath);
+        DotFilePatcher *patcher = DotManager::instance()->createFilePatcher(m_fileName.data());
+        int mapId = patcher->addSVGObject(m_baseName,absImgName(),m_relPath);
+        patcher->addDependency(m_dotRunner);
         t << "<!-- SVG " << mapId << " -->" << endl;
       }
       if (!m_noDivTag) t << "</div>" << endl;
@@ -241,9 +311,9 @@ void DotGraph::generateCode(FTextStream &t)
       t << endl;
       if (m_regenerate || !insertMapFile(t, absMapName(), m_relPath, correctId(getMapLabel())))
       {
-        int mapId = DotManager::instance()->
-          createFilePatcher(m_fileName.data())->
-          addMap(absMapName(), m_relPath, m_urlOnly, QCString(), getMapLabel());
+        DotFilePatcher *patcher = DotManager::instance()->createFilePatcher(m_fileName.data());
+        int mapId = patcher->addMap(absMapName(), m_relPath, m_urlOnly, QCString(), getMapLabel());
+        patcher->addDependency(m_dotRunner);
         t << "<!-- MAP " << mapId << " -->" << endl;
       }
     }
@@ -252,9 +322,9 @@ void DotGraph::generateCode(FTextStream &t)
   {
     if (m_regenerate || !DotFilePatcher::writeVecGfxFigure(t,m_baseName,absBaseName()))
     {
-      int figId = DotManager::instance()->
-                  createFilePatcher(m_fileName.data())->
-                  addFigure(m_baseName,absBaseName(),FALSE /*TRUE*/);
+      DotFilePatcher *patcher = DotManager::instance()->createFilePatcher(m_fileName.data());
+      int figId = patcher->addFigure(m_baseName,absBaseName(),FALSE /*TRUE*/);
+      patcher->addDependency(m_dotRunner);
       t << endl << "% FIG " << figId << endl;
     }
   }
@@ -304,7 +374,8 @@ void DotGraph::computeGraph(DotNode *root,
                             bool renderParents,
                             bool backArrows,
                             const QCString &title,
-                            QGString &graphStr)
+                            QGString &graphStr,
+                            DotGraphSize &graphSize)
 {
   //printf("computeMd5Signature\n");
   QGString buf;
@@ -315,7 +386,7 @@ void DotGraph::computeGraph(DotNode *root,
     md5stream << "  rankdir=\"" << rank << "\";" << endl;
   }
   root->clearWriteFlag();
-  root->write(md5stream, gt, format, gt!=CallGraph && gt!=Dependency, TRUE, backArrows);
+  root->write(md5stream, gt, format, gt!=CallGraph && gt!=Dependency, TRUE, backArrows, &graphSize);
   if (renderParents)
   {
     for (const auto &pn : root->parents())
@@ -333,13 +404,15 @@ void DotGraph::computeGraph(DotNode *root,
             FALSE,                                               // topDown?
             backArrows                                           // point back?
           );
+        graphSize.numEdges++;
       }
       pn->write(md5stream,      // stream
                 gt,             // graph type
                 format,         // output format
                 TRUE,           // topDown?
                 FALSE,          // toChildren?
-                backArrows      // backward pointing arrows?
+                backArrows,     // backward pointing arrows?
+                &graphSize      // nodes and edges written
       );
     }
   }
@@ -22,11 +22,19 @@
 
 class FTextStream;
 class DotNode;
+class DotRunner;
 
 enum GraphOutputFormat    { GOF_BITMAP, GOF_EPS };
 enum EmbeddedOutputFormat { EOF_Html, EOF_LaTeX, EOF_Rtf, EOF_DocBook };
 enum GraphType            { Dependency, Inheritance, Collaboration, Hierarchy, CallGraph };
 
+/** Number of nodes and edges written to a dot graph */
+struct DotGraphSize
+{
+  int numNodes = 0;
+  int numEdges = 0;
+};
+
 /** A dot graph */
 class DotGraph
 {
@@ -58,7 +66,8 @@ class DotGraph
                              bool renderParents,
                              bool backArrows,
                              const QCString& title,
-                             QGString& graphStr
+                             QGString& graphStr,
+                             DotGraphSize& graphSize
                             );
 
     virtual QCString getBaseName() const = 0;
@@ -86,7 +95,9 @@ class DotGraph
     QCString               m_absPath;
     QCString               m_baseName;
     QGString               m_theGraph;
+    DotGraphSize           m_graphSize;       // size of m_theGraph, to estimate the layout cost
     bool                   m_regenerate = false;
+    DotRunner             *m_dotRunner = nullptr; // runner rendering the graph, if regenerated
     bool                   m_doNotAddImageToIndex = false;
     bool                   m_noDivTag = false;
     bool                   m_zoomable = true;
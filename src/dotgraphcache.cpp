@@ -0,0 +1,143 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <stdio.h>
+#include <atomic>
+
+#include <qdir.h>
+#include <qfileinfo.h>
+
+#include "dotgraphcache.h"
+#include "config.h"
+#include "message.h"
+#include "portable.h"
+#include "md5.h"
+#include "util.h"
+
+// Increase when the way graphs are rendered changes in a way that is not
+// visible in the dot text, to invalidate existing caches.
+static const int g_cacheFormatVersion = 1;
+
+struct DotGraphCache::Private
+{
+  bool enabled = false;
+  QCString dir;
+  QCString settings;
+  std::atomic<int> numHits{0};
+  std::atomic<int> numMisses{0};
+  std::atomic<int> numStored{0};
+  std::atomic<int> tmpIndex{0};   // makes temporary names unique between dot threads
+
+  QCString fileNameFor(const char *md5,const char *format,const char *outputFile) const
+  {
+    // the key also covers the settings that are passed to dot on the command line
+    QCString keyText = settings+md5+"\n"+format;
+    uchar md5_sig[16];
+    char sigStr[33];
+    MD5Buffer((const unsigned char *)keyText.data(),keyText.length(),md5_sig);
+    MD5SigToString(md5_sig,sigStr,33);
+    QCString ext = QFileInfo(outputFile).extension(FALSE).utf8();
+    if (ext.isEmpty()) ext = format;
+    return dir+"/"+sigStr+"."+ext;
+  }
+};
+
+DotGraphCache &DotGraphCache::instance()
+{
+  static DotGraphCache cache;
+  return cache;
+}
+
+DotGraphCache::DotGraphCache() : p(std::make_unique<Private>())
+{
+}
+
+DotGraphCache::~DotGraphCache()
+{
+}
+
+void DotGraphCache::init()
+{
+  QCString dirName = Config_getString(DOT_CACHE_DIR);
+  p->enabled = false;
+  if (dirName.isEmpty()) return;
+
+  QDir dir(dirName);
+  if (!dir.exists() && !dir.mkdir(dirName,TRUE))
+  {
+    err("Could not create dot cache directory %s, the dot cache is disabled\n",dirName.data());
+    return;
+  }
+  p->dir = QFileInfo(dirName).absFilePath().utf8();
+  p->settings.sprintf("%d\n%s\n%d\n",g_cacheFormatVersion,
+      Config_getString(DOT_FONTPATH).data(),Config_getBool(DOT_TRANSPARENT));
+  p->enabled = true;
+}
+
+bool DotGraphCache::isEnabled() const
+{
+  return p->enabled;
+}
+
+bool DotGraphCache::restore(const QCString &md5,const char *format,const QCString &outputFile)
+{
+  if (!p->enabled || md5.isEmpty()) return FALSE;
+  QCString cacheFile = p->fileNameFor(md5,format,outputFile);
+  if (!QFileInfo(cacheFile).exists())
+  {
+    p->numMisses++;
+    return FALSE;
+  }
+  Portable::unlink(outputFile);
+  if (!Portable::hardLink(cacheFile,outputFile) &&
+      !copyFile(cacheFile,outputFile))
+  {
+    p->numMisses++;
+    return FALSE;
+  }
+  p->numHits++;
+  return TRUE;
+}
+
+void DotGraphCache::store(const std::string &md5,const std::string &format,const std::string &outputFile)
+{
+  if (!p->enabled || md5.empty()) return;
+  QCString cacheFile = p->fileNameFor(md5.c_str(),format.c_str(),outputFile.c_str());
+  if (QFileInfo(cacheFile).exists()) return;
+
+  // copy to a temporary file first, so a partially written file is never picked up
+  QCString tmpName;
+  tmpName.sprintf("%s.%u.%d.tmp",cacheFile.data(),Portable::pid(),p->tmpIndex++);
+  if (!copyFile(outputFile.c_str(),tmpName) || rename(tmpName.data(),cacheFile.data())!=0)
+  {
+    QDir().remove(tmpName);
+    return;
+  }
+  p->numStored++;
+}
+
+void DotGraphCache::removeOutput(const std::string &outputFile)
+{
+  // also when the cache is disabled, the file may still be linked to a cache
+  // used by an earlier run
+  Portable::unlink(outputFile.c_str());
+}
+
+void DotGraphCache::printStatistics() const
+{
+  if (!p->enabled) return;
+  msg("Dot cache: %d graphs restored, %d graphs rendered, %d graphs stored\n",
+      p->numHits.load(),p->numMisses.load(),p->numStored.load());
+}
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef DOTGRAPHCACHE_H
+#define DOTGRAPHCACHE_H
+
+#include <memory>
+#include <string>
+#include <qcstring.h>
+
+/** Content addressed store of graphs rendered by dot (see DOT_CACHE_DIR).
+ *
+ *  Files are stored under a key computed from the MD5 checksum of the dot
+ *  text that doxygen already uses to decide whether a graph needs to be
+ *  regenerated, the output format, and the settings that influence rendering
+ *  but are not part of the dot text. Files are stored before DotFilePatcher
+ *  modifies them, so the same cached image can be used by different pages.
+ *
+ *  Restored files are hard linked into the output directory when possible and
+ *  copied otherwise. As a consequence files in the output directory may share
+ *  their contents with the cache, so they must be replaced rather than
+ *  overwritten; see removeOutput().
+ */
+class DotGraphCache
+{
+  public:
+    static DotGraphCache &instance();
+
+    /** Reads the configuration, must be called before any graph is rendered */
+    void init();
+    /** Returns TRUE if the cache is enabled via DOT_CACHE_DIR */
+    bool isEnabled() const;
+
+    /** Puts the graph with checksum \a md5 rendered in \a format at \a outputFile.
+     *  Returns FALSE if the cache does not have it.
+     */
+    bool restore(const QCString &md5,const char *format,const QCString &outputFile);
+    /** Adds \a outputFile, rendered in \a format from a graph with checksum \a md5 */
+    void store(const std::string &md5,const std::string &format,const std::string &outputFile);
+    /** Removes \a outputFile before dot writes it, so a file linked to a cache
+     *  is never overwritten in place. This is done even if the cache is
+     *  disabled, as the output may have been restored by an earlier run.
+     */
+    void removeOutput(const std::string &outputFile);
+
+    /** Prints the number of hits and misses */
+    void printStatistics() const;
+
+  private:
+    DotGraphCache();
+   ~DotGraphCache();
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
@@ -219,7 +219,7 @@ void DotGroupCollaboration::computeTheGraph()
   // write other nodes.
   for (const auto &kv : m_usedNodes)
   {
-    kv.second->write(md5stream,Inheritance,m_graphFormat,TRUE,FALSE,FALSE);
+    kv.second->write(md5stream,Inheritance,m_graphFormat,TRUE,FALSE,FALSE,&m_graphSize);
   }
 
   // write edges
@@ -227,6 +227,7 @@ void DotGroupCollaboration::computeTheGraph()
   {
     edge->write( md5stream );
   }
+  m_graphSize.numEdges += static_cast<int>(m_edges.size());
 
   writeGraphFooter(md5stream);
 
@@ -0,0 +1,1225 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <stdio.h>
+#include <ctype.h>
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "dotlayout.h"
+#include "portable.h"
+
+// default sizes in points, matching those of dot
+static const double g_nodeSep     = 18.0;  // space between nodes in a rank
+static const double g_dummySep    = 8.0;   // space next to edges crossing a rank
+static const double g_rankSep     = 36.0;  // space between ranks
+static const double g_marginX     = 8.0;   // space between label and box border
+static const double g_marginY     = 4.0;
+static const double g_pad         = 4.0;   // space around the graph
+static const double g_labelSep    = 4.0;   // space between an edge and its label
+static const double g_arrowLen    = 10.0;
+static const double g_arrowWidth  = 3.5;
+static const double g_lineSpacing = 1.2;
+
+//--------------------------------------------------------------------
+
+/** Width of the printable ASCII characters of Helvetica in 1/1000 em */
+static const short g_helveticaWidths[95] =
+{
+  278, 278, 355, 556, 556, 889, 667, 191, 333, 333, 389, 584, 278, 333, 278, 278, //  !"#$%&'()*+,-./
+  556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 278, 278, 584, 584, 584, 556, // 0-9:;<=>?
+ 1015, 667, 667, 722, 722, 667, 611, 778, 722, 278, 500, 667, 556, 833, 722, 778, // @A-O
+  667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 278, 278, 278, 469, 556, // P-Z[\]^_
+  333, 556, 556, 500, 556, 556, 278, 556, 556, 222, 222, 500, 222, 833, 556, 556, // `a-o
+  556, 556, 333, 500, 278, 556, 500, 722, 500, 500, 500, 334, 260, 334, 584       // p-z{|}~
+};
+
+static double textWidth(const std::string &text,double fontSize)
+{
+  double w=0;
+  for (size_t i=0;i<text.length();i++)
+  {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    if (c>=32 && c<127)
+    {
+      w+=g_helveticaWidths[c-32];
+    }
+    else if ((c&0xC0)!=0x80) // first byte of a non-ASCII UTF-8 character
+    {
+      w+=556;
+    }
+  }
+  return w*fontSize/1000.0;
+}
+
+/** Returns the SVG color for the dot color name \a name, or an empty string if it is not known */
+static std::string svgColor(const std::string &name)
+{
+  static const std::map<std::string,std::string> colors =
+  {
+    { "black",        "black"        },
+    { "white",        "white"        },
+    { "red",          "red"          },
+    { "orange",       "orange"       },
+    { "midnightblue", "midnightblue" },
+    { "darkgreen",    "darkgreen"    },
+    { "steelblue",    "steelblue"    },
+    { "lightgrey",    "lightgrey"    },
+    { "firebrick4",   "#8b1a1a"      },
+    { "darkorchid3",  "#9a32cd"      },
+    { "transparent",  "transparent"  },
+    { "none",         "none"         }
+  };
+  if (name.length()==7 && name[0]=='#') return name;
+  auto it = colors.find(name);
+  if (it!=colors.end()) return it->second;
+  // grey0..grey100 and gray0..gray100
+  if (name.length()>4 && (name.compare(0,4,"grey")==0 || name.compare(0,4,"gray")==0))
+  {
+    int level=0;
+    for (size_t i=4;i<name.length();i++)
+    {
+      if (!isdigit(static_cast<unsigned char>(name[i]))) return std::string();
+      level = level*10+(name[i]-'0');
+    }
+    if (level>100) return std::string();
+    char buf[8];
+    int v = (level*255+50)/100;
+    snprintf(buf,sizeof(buf),"#%02x%02x%02x",v,v,v);
+    return buf;
+  }
+  if (name=="grey" || name=="gray") return "#c0c0c0";
+  return std::string();
+}
+
+/** Returns TRUE if the text at position \a i of \a s is an XML entity or character reference */
+static bool isEntity(const std::string &s,size_t i)
+{
+  size_t j=i+1;
+  if (j<s.length() && s[j]=='#')
+  {
+    j++;
+    bool hex = j<s.length() && (s[j]=='x' || s[j]=='X');
+    if (hex) j++;
+    size_t start=j;
+    while (j<s.length() && (hex ? isxdigit(static_cast<unsigned char>(s[j])) : isdigit(static_cast<unsigned char>(s[j])))) j++;
+    return j>start && j<s.length() && s[j]==';';
+  }
+  size_t start=j;
+  while (j<s.length() && isalnum(static_cast<unsigned char>(s[j]))) j++;
+  return j>start && j<s.length() && s[j]==';';
+}
+
+/** Escapes \a s for use in XML. Like dot, entities that are already in the
+ *  text are kept, since doxygen passes some strings, like the graph title,
+ *  already escaped.
+ */
+static std::string escapeXml(const std::string &s)
+{
+  std::string result;
+  result.reserve(s.length());
+  for (size_t i=0;i<s.length();i++)
+  {
+    char c = s[i];
+    switch (c)
+    {
+      case '&': result+=isEntity(s,i) ? "&" : "&amp;"; break;
+      case '<': result+="&lt;"; break;
+      case '>': result+="&gt;"; break;
+      case '"': result+="&quot;"; break;
+      default:  result+=c; break;
+    }
+  }
+  return result;
+}
+
+//--------------------------------------------------------------------
+
+/** Tokenizer for the dot text generated by doxygen */
+class DotLexer
+{
+  public:
+    enum Token { End, Id, String, LBracket, RBracket, LBrace, RBrace, Equal, Comma, Semicolon, Arrow, Error };
+    DotLexer(const char *s) : m_p(s) {}
+    Token next()
+    {
+      skipSpaceAndComments();
+      m_text.clear();
+      char c = *m_p;
+      if (c==0) return End;
+      if (c=='"')
+      {
+        m_p++;
+        while (*m_p && *m_p!='"')
+        {
+          if (*m_p=='\\' && m_p[1]) m_text+=*m_p++; // keep escapes, they are handled per attribute
+          m_text+=*m_p++;
+        }
+        if (*m_p!='"') return Error;
+        m_p++;
+        return String;
+      }
+      if (isalnum(static_cast<unsigned char>(c)) || c=='_' || c=='.')
+      {
+        while (isalnum(static_cast<unsigned char>(*m_p)) || *m_p=='_' || *m_p=='.') m_text+=*m_p++;
+        return Id;
+      }
+      m_p++;
+      switch (c)
+      {
+        case '[': return LBracket;
+        case ']': return RBracket;
+        case '{': return LBrace;
+        case '}': return RBrace;
+        case '=': return Equal;
+        case ',': return Comma;
+        case ';': return Semicolon;
+        case '-': if (*m_p=='>') { m_p++; return Arrow; } return Error;
+        default:  return Error;
+      }
+    }
+    const std::string &text() const { return m_text; }
+  private:
+    void skipSpaceAndComments()
+    {
+      for (;;)
+      {
+        while (isspace(static_cast<unsigned char>(*m_p))) m_p++;
+        if (m_p[0]=='/' && m_p[1]=='/')
+        {
+          while (*m_p && *m_p!='\n') m_p++;
+        }
+        else if (m_p[0]=='/' && m_p[1]=='*')
+        {
+          const char *e = strstr(m_p+2,"*/");
+          m_p = e ? e+2 : m_p+strlen(m_p);
+        }
+        else
+        {
+          return;
+        }
+      }
+    }
+    const char *m_p;
+    std::string m_text;
+};
+
+//--------------------------------------------------------------------
+
+using Attributes = std::map<std::string,std::string>;
+
+struct TextLine
+{
+  std::string text;
+  char        justify; // 'n' = centered, 'l' = left, 'r' = right
+};
+
+/** Splits a dot label into lines, returns FALSE if the label has record fields */
+static bool splitLabel(const std::string &label,bool isRecord,std::vector<TextLine> &lines)
+{
+  std::string cur;
+  for (size_t i=0;i<label.length();i++)
+  {
+    char c = label[i];
+    if (c=='\\' && i+1<label.length())
+    {
+      char n = label[++i];
+      if (n=='n' || n=='l' || n=='r')
+      {
+        lines.push_back({cur,n});
+        cur.clear();
+      }
+      else
+      {
+        cur+=n;
+      }
+    }
+    else if (isRecord && (c=='{' || c=='}' || c=='|' || c=='<' || c=='>'))
+    {
+      return false;
+    }
+    else
+    {
+      cur+=c;
+    }
+  }
+  if (!cur.empty() || lines.empty()) lines.push_back({cur,'n'});
+  return true;
+}
+
+static std::string unescape(const std::string &s)
+{
+  std::string result;
+  for (size_t i=0;i<s.length();i++)
+  {
+    if (s[i]=='\\' && i+1<s.length()) i++;
+    result+=s[i];
+  }
+  return result;
+}
+
+static double toDouble(const std::string &s,double defVal)
+{
+  if (s.empty()) return defVal;
+  return atof(s.c_str());
+}
+
+//--------------------------------------------------------------------
+
+/** Graph model and layered layout of a dot graph */
+class LayoutGraph
+{
+  public:
+    bool parse(const char *text);
+    bool prepare(int maxNodes);
+    void layout();
+    void writeSvg(FILE *f) const;
+    void writeMap(FILE *f) const;
+
+  private:
+    struct Node
+    {
+      std::string name;
+      Attributes  attrs;
+      std::vector<TextLine> lines;
+      std::string url;
+      std::string tooltip;
+      std::string color = "black";
+      std::string fillColor = "none";
+      std::string fontColor = "black";
+      std::string fontName;
+      double      fontSize = 14.0;
+      bool        hasBox = true;
+      bool        dummy = false;
+      bool        isLabel = false; // dummy node reserving the space of an edge label
+      double      edgeO = 0;   // position of the edge relative to o
+      double      width = 0;   // size in points
+      double      height = 0;
+      int         rank = 0;
+      int         order = 0;
+      double      o = 0;       // position along a rank
+      double      k = 0;       // position across ranks
+      std::vector<int> up;     // neighbors in the previous rank
+      std::vector<int> down;   // neighbors in the next rank
+    };
+    struct Edge
+    {
+      int from;
+      int to;
+      Attributes attrs;
+      std::string color = "black";
+      std::string style;
+      std::string dir = "forward";
+      std::string arrowHead = "normal";
+      std::string arrowTail = "normal";
+      std::vector<TextLine> label;
+      std::string fontColor = "black";
+      std::string fontName;
+      double      fontSize = 14.0;
+      bool        reversed = false;
+      std::vector<int> chain; // nodes from the top rank to the bottom rank
+      int         labelNode = -1; // node in chain holding the label
+    };
+
+    int  nodeIndex(const std::string &name);
+    bool applyNodeAttributes(Node &n,const Attributes &attrs);
+    bool applyEdgeAttributes(Edge &e,const Attributes &attrs);
+    bool readAttributes(DotLexer &lex,DotLexer::Token &tok,Attributes &attrs);
+    void breakCycles();
+    void assignRanks();
+    void insertDummies();
+    void orderNodes();
+    void assignCoordinates();
+    int  countCrossings(int r) const;
+    void placeRank(int r,const std::vector<double> &desired);
+    double orderSize(const Node &n) const { return m_rankDir=="TB" ? n.width : n.height; }
+    double rankSize(const Node &n)  const { return m_rankDir=="TB" ? n.height : n.width; }
+    void map(double o,double k,double &x,double &y) const;
+    void writeArrow(FILE *f,const std::string &shape,const std::string &color,
+                    double tipO,double tipK,double dirK) const;
+    void writeText(FILE *f,const std::vector<TextLine> &lines,double cx,double cy,double left,double right,
+                   const std::string &fontName,double fontSize,const std::string &color,
+                   const char *anchor=0) const;
+
+    std::string m_title;
+    std::string m_rankDir = "TB";
+    std::string m_bgColor = "white";
+    Attributes  m_nodeDefaults;
+    Attributes  m_edgeDefaults;
+    std::vector<Node> m_nodes;
+    std::vector<Edge> m_edges;
+    std::map<std::string,int> m_nodeIndex;
+    int  m_numRealNodes = 0;
+    std::vector< std::vector<int> > m_ranks;
+    double m_width = 0;
+    double m_height = 0;
+};
+
+int LayoutGraph::nodeIndex(const std::string &name)
+{
+  auto it = m_nodeIndex.find(name);
+  if (it!=m_nodeIndex.end()) return it->second;
+  Node n;
+  n.name = name;
+  n.attrs = m_nodeDefaults;
+  m_nodes.push_back(n);
+  int index = static_cast<int>(m_nodes.size())-1;
+  m_nodeIndex.insert(std::make_pair(name,index));
+  return index;
+}
+
+bool LayoutGraph::readAttributes(DotLexer &lex,DotLexer::Token &tok,Attributes &attrs)
+{
+  // tok is '['
+  tok = lex.next();
+  while (tok!=DotLexer::RBracket)
+  {
+    if (tok!=DotLexer::Id) return false;
+    std::string name = lex.text();
+    if (lex.next()!=DotLexer::Equal) return false;
+    tok = lex.next();
+    if (tok!=DotLexer::Id && tok!=DotLexer::String) return false;
+    attrs[name] = lex.text();
+    tok = lex.next();
+    if (tok==DotLexer::Comma) tok = lex.next();
+  }
+  tok = lex.next();
+  return true;
+}
+
+bool LayoutGraph::applyNodeAttributes(Node &n,const Attributes &attrs)
+{
+  bool isRecord=false, filled=false;
+  std::string fillColor = "lightgrey";
+  for (const auto &kv : attrs)
+  {
+    const std::string &name = kv.first, &value = kv.second;
+    if (name=="label")          { }
+    else if (name=="URL")       { n.url=unescape(value); }
+    else if (name=="tooltip")   { n.tooltip=unescape(value); }
+    else if (name=="fontname")  { n.fontName=value; }
+    else if (name=="fontsize")  { n.fontSize=toDouble(value,14.0); }
+    else if (name=="color")     { if ((n.color=svgColor(value)).empty()) return false; }
+    else if (name=="fontcolor") { if ((n.fontColor=svgColor(value)).empty()) return false; }
+    else if (name=="fillcolor") { if ((fillColor=svgColor(value)).empty()) return false; }
+    else if (name=="style")
+    {
+      if (value=="filled") filled=true;
+      else if (value!="solid") return false;
+    }
+    else if (name=="shape")
+    {
+      if (value=="record") isRecord=true;
+      else if (value=="plaintext") n.hasBox=false;
+      else if (value!="box") return false;
+    }
+    else if (name=="height")    { n.height=toDouble(value,0)*72; }
+    else if (name=="width")     { n.width=toDouble(value,0)*72; }
+    else if (name=="labelfontname" || name=="labelfontsize") { }
+    else return false;
+  }
+  n.fillColor = filled ? fillColor : std::string("none");
+  auto it = attrs.find("label");
+  // without a label dot shows the name of the node
+  return splitLabel(it!=attrs.end() ? it->second : n.name,isRecord,n.lines);
+}
+
+// the arrow shapes writeArrow() can draw
+static bool isKnownArrow(const std::string &shape)
+{
+  return shape=="normal" || shape=="empty" || shape=="onormal" || shape=="open" ||
+         shape=="vee" || shape=="diamond" || shape=="odiamond" || shape=="none";
+}
+
+bool LayoutGraph::applyEdgeAttributes(Edge &e,const Attributes &attrs)
+{
+  for (const auto &kv : attrs)
+  {
+    const std::string &name = kv.first, &value = kv.second;
+    if (name=="color")           { if ((e.color=svgColor(value)).empty()) return false; }
+    else if (name=="fontcolor")  { if ((e.fontColor=svgColor(value)).empty()) return false; }
+    else if (name=="style")
+    {
+      if (value!="solid" && value!="dashed" && value!="dotted") return false;
+      e.style=value;
+    }
+    else if (name=="dir")
+    {
+      if (value!="forward" && value!="back" && value!="both" && value!="none") return false;
+      e.dir=value;
+    }
+    else if (name=="arrowhead")  { if (!isKnownArrow(value)) return false; e.arrowHead=value; }
+    else if (name=="arrowtail")  { if (!isKnownArrow(value)) return false; e.arrowTail=value; }
+    else if (name=="label")
+    {
+      e.label.clear();
+      if (!splitLabel(value,false,e.label)) return false;
+    }
+    else if (name=="fontname")   { e.fontName=value; }
+    else if (name=="fontsize")   { e.fontSize=toDouble(value,14.0); }
+    else if (name=="labelfontname" || name=="labelfontsize" || name=="shape") {}
+    else return false;
+  }
+  return true;
+}
+
+bool LayoutGraph::parse(const char *text)
+{
+  DotLexer lex(text);
+  DotLexer::Token tok = lex.next();
+  if (tok!=DotLexer::Id || lex.text()!="digraph") return false;
+  tok = lex.next();
+  if (tok==DotLexer::Id || tok==DotLexer::String)
+  {
+    m_title = lex.text();
+    tok = lex.next();
+  }
+  if (tok!=DotLexer::LBrace) return false;
+  tok = lex.next();
+  while (tok!=DotLexer::RBrace)
+  {
+    if (tok==DotLexer::Semicolon)
+    {
+      tok = lex.next();
+      continue;
+    }
+    if (tok!=DotLexer::Id && tok!=DotLexer::String) return false;
+    std::string name = lex.text();
+    if (name=="subgraph") return false;
+    tok = lex.next();
+    if ((name=="node" || name=="edge" || name=="graph") && tok==DotLexer::LBracket)
+    {
+      Attributes attrs;
+      if (!readAttributes(lex,tok,attrs) || name=="graph") return false;
+      Attributes &defaults = name=="node" ? m_nodeDefaults : m_edgeDefaults;
+      for (const auto &kv : attrs) defaults[kv.first]=kv.second;
+    }
+    else if (tok==DotLexer::Equal) // graph attribute
+    {
+      tok = lex.next();
+      if (tok!=DotLexer::Id && tok!=DotLexer::String) return false;
+      if (name=="rankdir")
+      {
+        m_rankDir = lex.text();
+        if (m_rankDir!="TB" && m_rankDir!="LR" && m_rankDir!="RL") return false;
+      }
+      else if (name=="bgcolor")
+      {
+        if ((m_bgColor=svgColor(lex.text())).empty()) return false;
+      }
+      else
+      {
+        return false;
+      }
+      tok = lex.next();
+    }
+    else if (tok==DotLexer::Arrow)
+    {
+      tok = lex.next();
+      if (tok!=DotLexer::Id && tok!=DotLexer::String) return false;
+      Edge e;
+      e.from = nodeIndex(name);
+      e.to   = nodeIndex(lex.text());
+      e.attrs = m_edgeDefaults;
+      tok = lex.next();
+      if (tok==DotLexer::LBracket)
+      {
+        Attributes attrs;
+        if (!readAttributes(lex,tok,attrs)) return false;
+        for (const auto &kv : attrs) e.attrs[kv.first]=kv.second;
+      }
+      m_edges.push_back(e);
+    }
+    else // node statement
+    {
+      int index = nodeIndex(name);
+      if (tok==DotLexer::LBracket)
+      {
+        Attributes attrs;
+        if (!readAttributes(lex,tok,attrs)) return false;
+        for (const auto &kv : attrs) m_nodes[index].attrs[kv.first]=kv.second;
+      }
+    }
+  }
+  return lex.next()==DotLexer::End;
+}
+
+bool LayoutGraph::prepare(int maxNodes)
+{
+  m_numRealNodes = static_cast<int>(m_nodes.size());
+  if (m_numRealNodes==0 || m_numRealNodes>maxNodes) return false;
+  for (auto &n : m_nodes)
+  {
+    n.width  = 0.75*72; // dot's defaults
+    n.height = 0.5*72;
+    if (!applyNodeAttributes(n,n.attrs)) return false;
+    double lineHeight = n.fontSize*g_lineSpacing;
+    double textW = 0;
+    for (const auto &line : n.lines)
+    {
+      textW = std::max(textW,textWidth(line.text,n.fontSize));
+    }
+    n.width  = std::max(n.width,  textW+2*g_marginX);
+    n.height = std::max(n.height, static_cast<double>(n.lines.size())*lineHeight+2*g_marginY);
+  }
+  for (auto &e : m_edges)
+  {
+    // dot draws self loops as a curve next to the node, which is not supported here
+    if (e.from==e.to || !applyEdgeAttributes(e,e.attrs)) return false;
+  }
+  return true;
+}
+
+void LayoutGraph::layout()
+{
+  breakCycles();
+  assignRanks();
+  insertDummies();
+  orderNodes();
+  assignCoordinates();
+}
+
+// reverses edges such that the graph becomes acyclic
+void LayoutGraph::breakCycles()
+{
+  std::vector< std::vector<int> > outEdges(m_nodes.size());
+  for (size_t i=0;i<m_edges.size();i++)
+  {
+    if (m_edges[i].from!=m_edges[i].to) outEdges[m_edges[i].from].push_back(static_cast<int>(i));
+  }
+  std::vector<int> state(m_nodes.size(),0); // 0=unvisited, 1=on stack, 2=done
+  std::vector< std::pair<int,size_t> > stack;
+  for (size_t start=0;start<m_nodes.size();start++)
+  {
+    if (state[start]!=0) continue;
+    stack.push_back(std::make_pair(static_cast<int>(start),0));
+    state[start]=1;
+    while (!stack.empty())
+    {
+      int v = stack.back().first;
+      size_t &next = stack.back().second;
+      if (next<outEdges[v].size())
+      {
+        Edge &e = m_edges[outEdges[v][next++]];
+        if (state[e.to]==1)
+        {
+          e.reversed=true; // back edge
+        }
+        else if (state[e.to]==0)
+        {
+          state[e.to]=1;
+          stack.push_back(std::make_pair(e.to,0));
+        }
+      }
+      else
+      {
+        state[v]=2;
+        stack.pop_back();
+      }
+    }
+  }
+}
+
+// longest path layering, where sources are moved close to their successors
+void LayoutGraph::assignRanks()
+{
+  size_t numNodes = m_nodes.size();
+  std::vector< std::vector< std::pair<int,int> > > succ(numNodes); // (node,minimum length)
+  std::vector< std::vector<int> > pred(numNodes);
+  for (const auto &e : m_edges)
+  {
+    int u = e.reversed ? e.to : e.from;
+    int v = e.reversed ? e.from : e.to;
+    // like dot, a labeled edge spans at least two ranks, so its label gets a rank of its own
+    int len = e.label.empty() ? 1 : 2;
+    succ[u].push_back(std::make_pair(v,len));
+    pred[v].push_back(u);
+  }
+  std::vector<int> inDegree(numNodes), topo;
+  for (size_t i=0;i<numNodes;i++)
+  {
+    inDegree[i] = static_cast<int>(pred[i].size());
+    if (inDegree[i]==0) topo.push_back(static_cast<int>(i));
+  }
+  for (size_t i=0;i<topo.size();i++)
+  {
+    int u = topo[i];
+    for (const auto &s : succ[u])
+    {
+      int v = s.first;
+      m_nodes[v].rank = std::max(m_nodes[v].rank,m_nodes[u].rank+s.second);
+      if (--inDegree[v]==0) topo.push_back(v);
+    }
+  }
+  for (auto it=topo.rbegin();it!=topo.rend();++it)
+  {
+    Node &n = m_nodes[*it];
+    if (pred[*it].empty() && !succ[*it].empty())
+    {
+      int minRank = m_nodes[succ[*it].front().first].rank-succ[*it].front().second;
+      for (const auto &s : succ[*it]) minRank = std::min(minRank,m_nodes[s.first].rank-s.second);
+      n.rank = minRank;
+    }
+  }
+}
+
+// splits edges that span multiple ranks by adding dummy nodes
+void LayoutGraph::insertDummies()
+{
+  int maxRank = 0;
+  for (const auto &n : m_nodes) maxRank = std::max(maxRank,n.rank);
+  m_ranks.resize(maxRank+1);
+  for (int i=0;i<m_numRealNodes;i++)
+  {
+    m_ranks[m_nodes[i].rank].push_back(i);
+  }
+  for (auto &e : m_edges)
+  {
+    int u = e.reversed ? e.to : e.from;
+    int v = e.reversed ? e.from : e.to;
+    e.chain.push_back(u);
+    for (int r=m_nodes[u].rank+1;r<m_nodes[v].rank;r++)
+    {
+      Node d;
+      d.dummy  = true;
+      d.rank   = r;
+      d.width  = 0;
+      d.height = 0;
+      m_nodes.push_back(d);
+      int index = static_cast<int>(m_nodes.size())-1;
+      m_ranks[r].push_back(index);
+      e.chain.push_back(index);
+    }
+    e.chain.push_back(v);
+    if (!e.label.empty())
+    {
+      // the dummy node in the middle reserves the space of the label, next to the edge
+      e.labelNode = e.chain[e.chain.size()/2];
+      Node &d = m_nodes[e.labelNode];
+      double labelW=0;
+      for (const auto &line : e.label) labelW = std::max(labelW,textWidth(line.text,e.fontSize));
+      double labelH = static_cast<double>(e.label.size())*e.fontSize*g_lineSpacing;
+      d.isLabel = true;
+      if (m_rankDir=="TB") // label to the right of the edge
+      {
+        d.width  = labelW+g_labelSep;
+        d.height = labelH;
+        d.edgeO  = -d.width/2;
+      }
+      else // label above the edge
+      {
+        d.width  = labelW;
+        d.height = labelH+g_labelSep;
+        d.edgeO  = d.height/2;
+      }
+    }
+    for (size_t i=0;i+1<e.chain.size();i++)
+    {
+      m_nodes[e.chain[i]].down.push_back(e.chain[i+1]);
+      m_nodes[e.chain[i+1]].up.push_back(e.chain[i]);
+    }
+  }
+}
+
+int LayoutGraph::countCrossings(int r) const
+{
+  std::vector< std::pair<int,int> > segments;
+  for (int u : m_ranks[r])
+  {
+    for (int v : m_nodes[u].down)
+    {
+      segments.push_back(std::make_pair(m_nodes[u].order,m_nodes[v].order));
+    }
+  }
+  int count=0;
+  for (size_t i=0;i<segments.size();i++)
+  {
+    for (size_t j=i+1;j<segments.size();j++)
+    {
+      if ((segments[i].first-segments[j].first)*(segments[i].second-segments[j].second)<0) count++;
+    }
+  }
+  return count;
+}
+
+// reduces edge crossings using the barycenter heuristic
+void LayoutGraph::orderNodes()
+{
+  int numRanks = static_cast<int>(m_ranks.size());
+  auto updateOrder = [this]()
+  {
+    for (const auto &rank : m_ranks)
+    {
+      for (size_t i=0;i<rank.size();i++) m_nodes[rank[i]].order = static_cast<int>(i);
+    }
+  };
+  auto totalCrossings = [this,numRanks]()
+  {
+    int count=0;
+    for (int r=0;r+1<numRanks;r++) count+=countCrossings(r);
+    return count;
+  };
+  auto sortRank = [this](int r,bool useUp)
+  {
+    std::vector< std::pair<double,int> > keys;
+    for (int v : m_ranks[r])
+    {
+      const std::vector<int> &nb = useUp ? m_nodes[v].up : m_nodes[v].down;
+      double key = m_nodes[v].order;
+      if (!nb.empty())
+      {
+        double sum=0;
+        for (int w : nb) sum+=m_nodes[w].order;
+        key = sum/static_cast<double>(nb.size());
+      }
+      keys.push_back(std::make_pair(key,v));
+    }
+    std::stable_sort(keys.begin(),keys.end(),
+        [](const std::pair<double,int> &a,const std::pair<double,int> &b) { return a.first<b.first; });
+    for (size_t i=0;i<keys.size();i++)
+    {
+      m_ranks[r][i] = keys[i].second;
+      m_nodes[keys[i].second].order = static_cast<int>(i);
+    }
+  };
+
+  updateOrder();
+  std::vector< std::vector<int> > best = m_ranks;
+  int bestCrossings = totalCrossings();
+  for (int iter=0;iter<24 && bestCrossings>0;iter++)
+  {
+    if (iter%2==0)
+    {
+      for (int r=1;r<numRanks;r++) sortRank(r,true);
+    }
+    else
+    {
+      for (int r=numRanks-2;r>=0;r--) sortRank(r,false);
+    }
+    int crossings = totalCrossings();
+    if (crossings<bestCrossings)
+    {
+      bestCrossings = crossings;
+      best = m_ranks;
+    }
+  }
+  m_ranks = best;
+  updateOrder();
+}
+
+// positions the nodes of rank r as close as possible to the positions in desired
+void LayoutGraph::placeRank(int r,const std::vector<double> &desired)
+{
+  const std::vector<int> &rank = m_ranks[r];
+  size_t n = rank.size();
+  if (n==0) return;
+  std::vector<double> minDist(n,0.0), left(n), right(n);
+  for (size_t i=0;i+1<n;i++)
+  {
+    const Node &a = m_nodes[rank[i]], &b = m_nodes[rank[i+1]];
+    double gap = ((a.dummy && !a.isLabel) || (b.dummy && !b.isLabel)) ? g_dummySep : g_nodeSep;
+    minDist[i] = orderSize(a)/2+orderSize(b)/2+gap;
+  }
+  left[0] = desired[0];
+  for (size_t i=1;i<n;i++)   left[i]  = std::max(desired[i],left[i-1]+minDist[i-1]);
+  right[n-1] = desired[n-1];
+  for (size_t i=n-1;i-->0;)  right[i] = std::min(desired[i],right[i+1]-minDist[i]);
+  // the average of two valid placements is also valid
+  for (size_t i=0;i<n;i++) m_nodes[rank[i]].o = (left[i]+right[i])/2;
+}
+
+void LayoutGraph::assignCoordinates()
+{
+  int numRanks = static_cast<int>(m_ranks.size());
+  // initial placement: packed from the left
+  for (int r=0;r<numRanks;r++)
+  {
+    std::vector<double> desired(m_ranks[r].size(),0.0);
+    placeRank(r,desired);
+  }
+  // the edges pass label nodes at their side, so align that side with the neighbors
+  auto neighborMean = [this](int v,bool useUp)
+  {
+    const std::vector<int> &nb = useUp ? m_nodes[v].up : m_nodes[v].down;
+    if (nb.empty()) return m_nodes[v].o;
+    double sum=0;
+    for (int w : nb) sum+=m_nodes[w].o+m_nodes[w].edgeO;
+    return sum/static_cast<double>(nb.size())-m_nodes[v].edgeO;
+  };
+  for (int iter=0;iter<8;iter++)
+  {
+    for (int r=1;r<numRanks;r++)
+    {
+      std::vector<double> desired;
+      for (int v : m_ranks[r]) desired.push_back(neighborMean(v,true));
+      placeRank(r,desired);
+    }
+    for (int r=numRanks-2;r>=0;r--)
+    {
+      std::vector<double> desired;
+      for (int v : m_ranks[r]) desired.push_back(neighborMean(v,false));
+      placeRank(r,desired);
+    }
+  }
+
+  // normalize the positions along the ranks
+  double minO=0, maxO=0;
+  bool first=true;
+  for (const auto &n : m_nodes)
+  {
+    double lo = n.o-orderSize(n)/2, hi = n.o+orderSize(n)/2;
+    if (first || lo<minO) minO=lo;
+    if (first || hi>maxO) maxO=hi;
+    first=false;
+  }
+  for (auto &n : m_nodes) n.o-=minO;
+
+  // positions across the ranks; the label nodes make room for the edge labels
+  double k=0;
+  for (int r=0;r<numRanks;r++)
+  {
+    double breadth=0;
+    for (int v : m_ranks[r]) breadth = std::max(breadth,rankSize(m_nodes[v]));
+    for (int v : m_ranks[r]) m_nodes[v].k = k+breadth/2;
+    k+=breadth+(r+1<numRanks ? g_rankSep : 0);
+  }
+  double orderExtent = maxO-minO;
+  if (m_rankDir=="TB")
+  {
+    m_width  = orderExtent;
+    m_height = k;
+  }
+  else
+  {
+    m_width  = k;
+    m_height = orderExtent;
+  }
+}
+
+void LayoutGraph::map(double o,double k,double &x,double &y) const
+{
+  if (m_rankDir=="TB")      { x=o;         y=k; }
+  else if (m_rankDir=="LR") { x=k;         y=o; }
+  else /* RL */             { x=m_width-k; y=o; }
+  y-=m_height; // dot places the origin at the bottom left corner
+}
+
+//--------------------------------------------------------------------
+
+static std::string fontFamily(const std::string &fontName)
+{
+  if (fontName.empty() || fontName=="Helvetica") return "Helvetica,sans-Serif";
+  return escapeXml(fontName);
+}
+
+void LayoutGraph::writeText(FILE *f,const std::vector<TextLine> &lines,double cx,double top,
+                            double left,double right,const std::string &fontName,double fontSize,
+                            const std::string &color,const char *anchor) const
+{
+  double lineHeight = fontSize*g_lineSpacing;
+  for (size_t i=0;i<lines.size();i++)
+  {
+    const TextLine &line = lines[i];
+    if (line.text.empty()) continue;
+    const char *a = anchor;
+    double x = cx;
+    if (a==0)
+    {
+      switch (line.justify)
+      {
+        case 'l': a="start"; x=left+g_marginX;  break;
+        case 'r': a="end";   x=right-g_marginX; break;
+        default:  a="middle"; break;
+      }
+    }
+    double y = top+static_cast<double>(i)*lineHeight+0.6*lineHeight+0.3*fontSize;
+    fprintf(f,"<text text-anchor=\"%s\" x=\"%.2f\" y=\"%.2f\" font-family=\"%s\" font-size=\"%.2f\"",
+        a,x,y,fontFamily(fontName).c_str(),fontSize);
+    if (color!="black") fprintf(f," fill=\"%s\"",color.c_str());
+    fprintf(f,">%s</text>\n",escapeXml(line.text).c_str());
+  }
+}
+
+void LayoutGraph::writeArrow(FILE *f,const std::string &shape,const std::string &color,
+                             double tipO,double tipK,double dirK) const
+{
+  std::vector< std::pair<double,double> > points; // (o,k) pairs
+  bool filled = true;
+  if (shape=="odiamond" || shape=="diamond")
+  {
+    points = { {tipO,tipK}, {tipO-4,tipK-dirK*6}, {tipO,tipK-dirK*12}, {tipO+4,tipK-dirK*6} };
+    filled = shape=="diamond";
+  }
+  else if (shape=="open" || shape=="vee")
+  {
+    double baseK = tipK-dirK*g_arrowLen;
+    points = { {tipO,tipK}, {tipO-g_arrowWidth,baseK}, {tipO,tipK-dirK*g_arrowLen*0.6}, {tipO+g_arrowWidth,baseK} };
+  }
+  else // normal, empty, onormal
+  {
+    double baseK = tipK-dirK*g_arrowLen;
+    points = { {tipO,tipK}, {tipO-g_arrowWidth,baseK}, {tipO+g_arrowWidth,baseK} };
+    filled = shape!="empty" && shape!="onormal";
+  }
+  fprintf(f,"<polygon fill=\"%s\" stroke=\"%s\" points=\"",filled ? color.c_str() : "none",color.c_str());
+  for (size_t i=0;i<=points.size();i++)
+  {
+    double x,y;
+    map(points[i%points.size()].first,points[i%points.size()].second,x,y);
+    fprintf(f,"%s%.2f,%.2f",i>0 ? " " : "",x,y);
+  }
+  fprintf(f,"\"/>\n");
+}
+
+static double arrowLength(const std::string &shape)
+{
+  if (shape=="none") return 0;
+  if (shape=="odiamond" || shape=="diamond") return 12;
+  return g_arrowLen;
+}
+
+void LayoutGraph::writeSvg(FILE *f) const
+{
+  double svgW = ceil(m_width+2*g_pad), svgH = ceil(m_height+2*g_pad);
+  std::string title = escapeXml(unescape(m_title));
+  fprintf(f,"<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n");
+  fprintf(f,"<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\"\n"
+            " \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n");
+  fprintf(f,"<!-- Generated by doxygen's built-in graph layout -->\n");
+  fprintf(f,"<!-- Title: %s Pages: 1 -->\n",title.c_str());
+  fprintf(f,"<svg width=\"%dpt\" height=\"%dpt\"\n",static_cast<int>(svgW),static_cast<int>(svgH));
+  fprintf(f," viewBox=\"0.00 0.00 %.2f %.2f\" xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n",svgW,svgH);
+  fprintf(f,"<g id=\"graph0\" class=\"graph\" transform=\"scale(1 1) rotate(0) translate(%.0f %.2f)\">\n",g_pad,svgH-g_pad);
+  fprintf(f,"<title>%s</title>\n",title.c_str());
+  fprintf(f,"<polygon fill=\"%s\" stroke=\"transparent\" points=\"%.2f,%.2f %.2f,%.2f %.2f,%.2f %.2f,%.2f %.2f,%.2f\"/>\n",
+      m_bgColor.c_str(),-g_pad,g_pad,-g_pad,g_pad-svgH,svgW-g_pad,g_pad-svgH,svgW-g_pad,g_pad,-g_pad,g_pad);
+
+  // nodes
+  for (int i=0;i<m_numRealNodes;i++)
+  {
+    const Node &n = m_nodes[i];
+    double cx,cy;
+    map(n.o,n.k,cx,cy);
+    double x0=cx-n.width/2, x1=cx+n.width/2, y0=cy-n.height/2, y1=cy+n.height/2;
+    std::string name = escapeXml(n.name);
+    fprintf(f,"<!-- %s -->\n",name.c_str());
+    fprintf(f,"<g id=\"node%d\" class=\"node\">\n",i+1);
+    fprintf(f,"<title>%s</title>\n",name.c_str());
+    bool hasLink = !n.url.empty() || !n.tooltip.empty();
+    if (hasLink)
+    {
+      fprintf(f,"<g id=\"a_node%d\"><a",i+1);
+      if (!n.url.empty()) fprintf(f," xlink:href=\"%s\"",escapeXml(n.url).c_str());
+      fprintf(f," xlink:title=\"%s\">\n",escapeXml(n.tooltip).c_str());
+    }
+    if (n.hasBox)
+    {
+      fprintf(f,"<polygon fill=\"%s\" stroke=\"%s\" points=\"%.2f,%.2f %.2f,%.2f %.2f,%.2f %.2f,%.2f %.2f,%.2f\"/>\n",
+          n.fillColor.c_str(),n.color.c_str(),x0,y1,x0,y0,x1,y0,x1,y1,x0,y1);
+    }
+    double textH = static_cast<double>(n.lines.size())*n.fontSize*g_lineSpacing;
+    writeText(f,n.lines,cx,cy-textH/2,x0,x1,n.fontName,n.fontSize,n.fontColor);
+    if (hasLink)
+    {
+      fprintf(f,"</a>\n</g>\n");
+    }
+    fprintf(f,"</g>\n");
+  }
+
+  // ports: spread the edges leaving or entering a node over its side
+  std::vector<double> startOffset(m_edges.size(),0.0), endOffset(m_edges.size(),0.0);
+  for (int i=0;i<m_numRealNodes;i++)
+  {
+    std::vector< std::pair<double,size_t> > outgoing, incoming;
+    for (size_t j=0;j<m_edges.size();j++)
+    {
+      const Edge &e = m_edges[j];
+      if (e.chain.empty()) continue;
+      if (e.chain.front()==i) outgoing.push_back(std::make_pair(m_nodes[e.chain[1]].o,j));
+      if (e.chain.back()==i)  incoming.push_back(std::make_pair(m_nodes[e.chain[e.chain.size()-2]].o,j));
+    }
+    double side = orderSize(m_nodes[i])*0.6;
+    std::sort(outgoing.begin(),outgoing.end());
+    std::sort(incoming.begin(),incoming.end());
+    for (size_t j=0;j<outgoing.size();j++)
+    {
+      startOffset[outgoing[j].second] = side*((j+1.0)/(outgoing.size()+1.0)-0.5);
+    }
+    for (size_t j=0;j<incoming.size();j++)
+    {
+      endOffset[incoming[j].second] = side*((j+1.0)/(incoming.size()+1.0)-0.5);
+    }
+  }
+
+  // edges
+  int edgeId=1;
+  for (size_t j=0;j<m_edges.size();j++)
+  {
+    const Edge &e = m_edges[j];
+    if (e.chain.empty()) continue;
+    bool hasHead = e.dir=="forward" || e.dir=="both";
+    bool hasTail = e.dir=="back"    || e.dir=="both";
+    // the chain runs from the top rank to the bottom rank, which is from tail to head
+    // unless the edge was reversed to break a cycle.
+    std::string startArrow = (e.reversed ? hasHead : hasTail) ? (e.reversed ? e.arrowHead : e.arrowTail) : "none";
+    std::string endArrow   = (e.reversed ? hasTail : hasHead) ? (e.reversed ? e.arrowTail : e.arrowHead) : "none";
+
+    std::vector< std::pair<double,double> > points;
+    const Node &first = m_nodes[e.chain.front()], &last = m_nodes[e.chain.back()];
+    points.push_back(std::make_pair(first.o+startOffset[j],first.k+rankSize(first)/2));
+    for (size_t i=1;i+1<e.chain.size();i++)
+    {
+      const Node &d = m_nodes[e.chain[i]];
+      points.push_back(std::make_pair(d.o+d.edgeO,d.k));
+    }
+    points.push_back(std::make_pair(last.o+endOffset[j],last.k-rankSize(last)/2));
+    double startTip = points.front().second, endTip = points.back().second;
+    points.front().second += arrowLength(startArrow);
+    points.back().second  -= arrowLength(endArrow);
+
+    std::string name = escapeXml(m_nodes[e.from].name)+"&#45;&gt;"+escapeXml(m_nodes[e.to].name);
+    fprintf(f,"<!-- %s -->\n",name.c_str());
+    fprintf(f,"<g id=\"edge%d\" class=\"edge\">\n",edgeId++);
+    fprintf(f,"<title>%s</title>\n",name.c_str());
+    fprintf(f,"<path fill=\"none\" stroke=\"%s\"",e.color.c_str());
+    if (e.style=="dashed") fprintf(f," stroke-dasharray=\"5,2\"");
+    if (e.style=="dotted") fprintf(f," stroke-dasharray=\"1,5\"");
+    double x,y;
+    map(points[0].first,points[0].second,x,y);
+    fprintf(f," d=\"M%.2f,%.2f",x,y);
+    for (size_t i=0;i+1<points.size();i++)
+    {
+      double midK = (points[i].second+points[i+1].second)/2;
+      double x1,y1,x2,y2,x3,y3;
+      map(points[i].first,midK,x1,y1);
+      map(points[i+1].first,midK,x2,y2);
+      map(points[i+1].first,points[i+1].second,x3,y3);
+      fprintf(f,"C%.2f,%.2f %.2f,%.2f %.2f,%.2f",x1,y1,x2,y2,x3,y3);
+    }
+    fprintf(f,"\"/>\n");
+    if (startArrow!="none") writeArrow(f,startArrow,e.color,points.front().first,startTip,-1.0);
+    if (endArrow!="none")   writeArrow(f,endArrow,  e.color,points.back().first, endTip,   1.0);
+    if (e.labelNode!=-1)
+    {
+      // the label fills the box of its label node, apart from the side of the edge
+      const Node &d = m_nodes[e.labelNode];
+      double lx,ly;
+      if (m_rankDir=="TB")
+      {
+        map(d.o-d.width/2+g_labelSep,d.k-d.height/2,lx,ly);
+        writeText(f,e.label,lx,ly,lx,lx,e.fontName,e.fontSize,e.fontColor,"start");
+      }
+      else
+      {
+        map(d.o-d.height/2,d.k,lx,ly);
+        writeText(f,e.label,lx,ly,lx,lx,e.fontName,e.fontSize,e.fontColor,"middle");
+      }
+    }
+    fprintf(f,"</g>\n");
+  }
+  fprintf(f,"</g>\n</svg>\n");
+}
+
+void LayoutGraph::writeMap(FILE *f) const
+{
+  std::string title = escapeXml(unescape(m_title));
+  fprintf(f,"<map id=\"%s\" name=\"%s\">\n",title.c_str(),title.c_str());
+  const double scale = 96.0/72.0; // the map is in pixels
+  for (int i=0;i<m_numRealNodes;i++)
+  {
+    const Node &n = m_nodes[i];
+    if (n.url.empty()) continue;
+    double cx,cy;
+    map(n.o,n.k,cx,cy);
+    cy+=m_height;
+    fprintf(f,"<area shape=\"rect\" id=\"node%d\" href=\"%s\" title=\"%s\" alt=\"\" coords=\"%d,%d,%d,%d\"/>\n",
+        i+1,escapeXml(n.url).c_str(),escapeXml(n.tooltip).c_str(),
+        static_cast<int>((cx-n.width/2+g_pad)*scale),  static_cast<int>((cy-n.height/2+g_pad)*scale),
+        static_cast<int>((cx+n.width/2+g_pad)*scale+0.5),static_cast<int>((cy+n.height/2+g_pad)*scale+0.5));
+  }
+  fprintf(f,"</map>\n");
+}
+
+//--------------------------------------------------------------------
+
+DotLayout::DotLayout()
+{
+}
+
+DotLayout::~DotLayout()
+{
+}
+
+bool DotLayout::prepare(const char *dotText,int maxNodes)
+{
+  m_graph.reset();
+  if (dotText==0 || maxNodes<=0) return FALSE;
+  auto graph = std::make_unique<LayoutGraph>();
+  if (!graph->parse(dotText) || !graph->prepare(maxNodes)) return FALSE;
+  m_graph = std::move(graph);
+  return TRUE;
+}
+
+bool DotLayout::writeSvg(const QCString &svgFile,const QCString &mapFile)
+{
+  if (!m_graph) return FALSE;
+  LayoutGraph &graph = *m_graph;
+  graph.layout();
+
+  // write to temporary files which replace the outputs only when complete; the
+  // outputs may be hard linked to the dot cache, so they must not be overwritten
+  static std::atomic<int> tmpIndex{0};
+  int index = tmpIndex++;
+  QCString svgTmp, mapTmp;
+  svgTmp.sprintf("%s.%u.%d.tmp",svgFile.data(),Portable::pid(),index);
+  FILE *f = Portable::fopen(svgTmp,"w");
+  if (f==0) return FALSE;
+  graph.writeSvg(f);
+  bool ok = fclose(f)==0;
+  if (ok && !mapFile.isEmpty())
+  {
+    mapTmp.sprintf("%s.%u.%d.tmp",mapFile.data(),Portable::pid(),index);
+    f = Portable::fopen(mapTmp,"w");
+    ok = f!=0;
+    if (ok)
+    {
+      graph.writeMap(f);
+      ok = fclose(f)==0;
+    }
+  }
+  if (ok)
+  {
+    Portable::unlink(svgFile);
+    ok = rename(svgTmp.data(),svgFile.data())==0;
+  }
+  if (ok && !mapTmp.isEmpty())
+  {
+    Portable::unlink(mapFile);
+    ok = rename(mapTmp.data(),mapFile.data())==0;
+  }
+  if (!ok)
+  {
+    Portable::unlink(svgTmp);
+    if (!mapTmp.isEmpty()) Portable::unlink(mapTmp);
+  }
+  return ok;
+}
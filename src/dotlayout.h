@@ -0,0 +1,56 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef DOTLAYOUT_H
+#define DOTLAYOUT_H
+
+#include <memory>
+#include <qcstring.h>
+
+class LayoutGraph;
+
+/** Built-in layered (Sugiyama style) layout for small graphs, which writes
+ *  SVG output directly instead of running dot (see DOT_BUILTIN_LAYOUT_MAX_NODES).
+ *
+ *  The input is the dot text doxygen generates for its graphs, so only the
+ *  subset of the dot language used there is understood: plain boxes, edges with
+ *  colors, styles, labels and arrow shapes, and the rankdir, bgcolor, node and
+ *  edge defaults. Graphs that use anything else, like clusters, record
+ *  fields (UML_LOOK), self loops or unknown arrow shapes, are rejected and
+ *  should be rendered by dot.
+ *
+ *  The SVG output has the same structure as the one of dot, so it can be
+ *  post-processed by DotFilePatcher in the same way.
+ */
+class DotLayout
+{
+  public:
+    DotLayout();
+   ~DotLayout();
+    /** Parses the graph \a dotText and returns TRUE if it has at most
+     *  \a maxNodes nodes and can be handled. The parsed graph is kept for writeSvg().
+     */
+    bool prepare(const char *dotText,int maxNodes);
+    /** Lays out the graph passed to prepare() and writes it to \a svgFile and,
+     *  if \a mapFile is not empty, a client side image map to \a mapFile.
+     *  Returns FALSE without writing anything if prepare() did not succeed.
+     */
+    bool writeSvg(const QCString &svgFile,const QCString &mapFile);
+
+  private:
+    std::unique_ptr<LayoutGraph> m_graph;
+};
+
+#endif
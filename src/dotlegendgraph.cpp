@@ -28,9 +28,10 @@ void DotLegendGraph::writeGraph(const char *path)
 
   if (getDotImageExtension()=="svg")
   {
-    DotManager::instance()->
-      createFilePatcher((absBaseName()+Config_getString(HTML_FILE_EXTENSION)).data())->
-      addSVGObject("graph_legend", absImgName(),QCString());
+    DotFilePatcher *patcher = DotManager::instance()->
+      createFilePatcher((absBaseName()+Config_getString(HTML_FILE_EXTENSION)).data());
+    patcher->addSVGObject("graph_legend", absImgName(),QCString());
+    patcher->addDependency(m_dotRunner);
   }
 }
 
@@ -63,6 +64,8 @@ void DotLegendGraph::computeTheGraph()
   md5stream << "  Node18 -> Node9 [dir=\"back\",color=\"darkorchid3\",fontsize=\"" << fontSize << "\",style=\"dashed\",label=\"m_usedClass\",fontname=\"" << fontName << "\"];\n";
   md5stream << "  Node18 [shape=\"box\",label=\"Used\",fontsize=\"" << fontSize << "\",height=0.2,width=0.4,fontname=\"" << fontName << "\",color=\"black\"];\n";
   writeGraphFooter(md5stream);
+  m_graphSize.numNodes = 9;
+  m_graphSize.numEdges = 8;
 }
 
 QCString DotLegendGraph::getMapLabel() const
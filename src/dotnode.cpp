@@ -557,13 +557,15 @@ void DotNode::write(FTextStream &t,
                     GraphOutputFormat format,
                     bool topDown,
                     bool toChildren,
-                    bool backArrows) const
+                    bool backArrows,
+                    DotGraphSize *graphSize) const
 {
   //printf("DotNode::write(%d) name=%s this=%p written=%d visible=%d\n",m_distance,m_label.data(),this,m_written,m_visible);
   if (m_written) return; // node already written to the output
   if (!m_visible) return; // node is not visible
   writeBox(t,gt,format,m_truncated==Truncated);
   m_written=TRUE;
+  if (graphSize) graphSize->numNodes++;
   if (toChildren)
   {
     auto it = m_edgeInfo.begin();
@@ -573,8 +575,9 @@ void DotNode::write(FTextStream &t,
       {
         //printf("write arrow %s%s%s\n",label().data(),backArrows?"<-":"->",cn->label().data());
         writeArrow(t,gt,format,cn,&(*it),topDown,backArrows);
+        if (graphSize) graphSize->numEdges++;
       }
-      cn->write(t,gt,format,topDown,toChildren,backArrows);
+      cn->write(t,gt,format,topDown,toChildren,backArrows,graphSize);
       ++it;
     }
   }
@@ -596,8 +599,9 @@ void DotNode::write(FTextStream &t,
           FALSE,
           backArrows
         );
+        if (graphSize) graphSize->numEdges++;
       }
-      pn->write(t,gt,format,TRUE,FALSE,backArrows);
+      pn->write(t,gt,format,TRUE,FALSE,backArrows,graphSize);
     }
   }
   //printf("end DotNode::write(%d) name=%s\n",distance,m_label.data());
@@ -76,7 +76,8 @@ class DotNode
     int  findParent( DotNode *n );
 
     void write(FTextStream &t,GraphType gt,GraphOutputFormat f,
-               bool topDown,bool toChildren,bool backArrows) const;
+               bool topDown,bool toChildren,bool backArrows,
+               DotGraphSize *graphSize=0) const;
     void writeXML(FTextStream &t,bool isClassGraph) const;
     void writeDocbook(FTextStream &t,bool isClassGraph) const;
     void writeDEF(FTextStream &t) const;
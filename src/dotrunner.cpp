@@ -14,6 +14,8 @@
 */
 
 #include <cassert>
+#include <algorithm>
+#include <chrono>
 
 #include "dotrunner.h"
 
@@ -24,6 +26,8 @@
 #include "message.h"
 #include "ftextstream.h"
 #include "config.h"
+#include "debug.h"
+#include "dotgraphcache.h"
 
 // the graphicx LaTeX has a limitation of maximum size of 16384
 // To be on the save side we take it a little bit smaller i.e. 150 inch * 72 dpi
@@ -159,7 +163,7 @@ DotRunner::DotRunner(const std::string& absDotName, const std::string& md5Hash)
 
 void DotRunner::addJob(const char *format, const char *output)
 {
-
+  std::lock_guard<std::mutex> lock(m_jobsMutex);
   for (auto& s: m_jobs)
   {
     if (s.format != format) continue;
@@ -167,8 +171,66 @@ void DotRunner::addJob(const char *format, const char *output)
     // we have this job already
     return;
   }
+  for (auto& s: m_lateJobs)
+  {
+    if (s.format != format) continue;
+    if (s.output != output) continue;
+    // we have this job already
+    return;
+  }
   auto args = std::string ("-T") + format + " -o \"" + output + "\"";
-  m_jobs.emplace_back(format, output, args);
+  // the jobs of a pipelined runner may be in use by a worker thread
+  (m_pipelined ? m_lateJobs : m_jobs).emplace_back(format, output, args);
+}
+
+void DotRunner::setPipelined()
+{
+  std::lock_guard<std::mutex> lock(m_jobsMutex);
+  m_pipelined = true;
+}
+
+bool DotRunner::isPipelined() const
+{
+  std::lock_guard<std::mutex> lock(m_jobsMutex);
+  return m_pipelined;
+}
+
+bool DotRunner::hasLateJobs() const
+{
+  std::lock_guard<std::mutex> lock(m_jobsMutex);
+  return !m_lateJobs.empty();
+}
+
+void DotRunner::activateLateJobs()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_jobsMutex);
+    m_jobs = std::move(m_lateJobs);
+    m_lateJobs.clear();
+  }
+  std::lock_guard<std::mutex> lock(m_finishedMutex);
+  m_finished = false;
+}
+
+void DotRunner::setFinished()
+{
+  std::lock_guard<std::mutex> lock(m_finishedMutex);
+  m_finished = true;
+  m_finishedCond.notify_all();
+}
+
+void DotRunner::waitUntilFinished()
+{
+  std::unique_lock<std::mutex> lock(m_finishedMutex);
+  m_finishedCond.wait(lock, [this]() { return m_finished; });
+}
+
+void DotRunner::cleanUp()
+{
+  if (m_cleanUp)
+  {
+    Portable::unlink(m_file.data());
+  }
 }
 
 QCString getBaseNameOfOutput(const QCString &output)
@@ -179,11 +241,29 @@ QCString getBaseNameOfOutput(const QCString &output)
 }
 
 bool DotRunner::run()
+{
+  auto startTime = std::chrono::steady_clock::now();
+  bool result = runDot();
+  m_elapsedTime = std::chrono::duration<double>(std::chrono::steady_clock::now()-startTime).count();
+  Debug::print(Debug::ExtCmd,0,"Dot graph %s (layout cost %d) took %.3f seconds\n",
+      m_file.c_str(),m_layoutCost,m_elapsedTime);
+  setFinished();
+  return result;
+}
+
+bool DotRunner::runDot()
 {
   int exitCode=0;
 
   QCString dotArgs;
 
+  // outputs restored from the dot cache may be linked to it, so never let dot overwrite them
+  DotGraphCache &cache = DotGraphCache::instance();
+  for (auto& s : m_jobs)
+  {
+    cache.removeOutput(s.output);
+  }
+
   // create output
   if (Config_getBool(DOT_MULTI_TARGETS))
   {
@@ -204,19 +284,31 @@ bool DotRunner::run()
     }
   }
 
-  // check output
+  if (!checkResults(dotArgs,exitCode)) goto error;
+  return TRUE;
+error:
+  err("Problems running dot: exit code=%d, command='%s', arguments='%s'\n",
+    exitCode,m_dotExe.data(),dotArgs.data());
+  return FALSE;
+}
+
+/** Checks the generated output, removes the dot file and writes the checksum file.
+ *  If dot needs to be run again, \a dotArgs and \a exitCode are updated.
+ */
+bool DotRunner::checkResults(QCString &dotArgs,int &exitCode)
+{
   // As there should be only one pdf file be generated, we don't need code for regenerating multiple pdf files in one call
   for (auto& s : m_jobs)
   {
     if (s.format.compare(0, 3, "pdf") == 0)
     {
       int width=0,height=0;
-      if (!readBoundingBox(s.output.data(),&width,&height,FALSE)) goto error;
+      if (!readBoundingBox(s.output.data(),&width,&height,FALSE)) return FALSE;
       if ((width > MAX_LATEX_GRAPH_SIZE) || (height > MAX_LATEX_GRAPH_SIZE))
       {
-        if (!resetPDFSize(width,height,getBaseNameOfOutput(s.output.data()))) goto error;
+        if (!resetPDFSize(width,height,getBaseNameOfOutput(s.output.data()))) return FALSE;
         dotArgs=QCString("\"")+m_file.data()+"\" "+s.args.data();
-        if ((exitCode=Portable::system(m_dotExe.data(),dotArgs,FALSE))!=0) goto error;
+        if ((exitCode=Portable::system(m_dotExe.data(),dotArgs,FALSE))!=0) return FALSE;
       }
     }
 
@@ -226,8 +318,15 @@ bool DotRunner::run()
     }
   }
 
-  // remove .dot files
-  if (m_cleanUp)
+  // keep a copy of the unpatched output for later runs
+  DotGraphCache &cache = DotGraphCache::instance();
+  for (const auto& s : m_jobs)
+  {
+    cache.store(m_md5Hash,s.format,s.output);
+  }
+
+  // remove .dot files, pipelined runners may still need them for late jobs
+  if (m_cleanUp && !isPipelined())
   {
     //printf("removing dot file %s\n",m_file.data());
     Portable::unlink(m_file.data());
@@ -245,19 +344,153 @@ bool DotRunner::run()
     }
   }
   return TRUE;
-error:
-  err("Problems running dot: exit code=%d, command='%s', arguments='%s'\n",
-    exitCode,m_dotExe.data(),dotArgs.data());
-  return FALSE;
+}
+
+// Returns the name of the file dot writes the output in format \a format to, when
+// called with option -O for input file \a file. The name consists of the input name
+// followed by the parts of the format in reverse order, e.g. "a.dot" with format
+// "png:cairo" results in "a.dot.cairo.png".
+static std::string autoOutputName(const std::string &file,const std::string &format)
+{
+  std::string result = file;
+  std::string fmt = format;
+  size_t i;
+  while ((i=fmt.rfind(':'))!=std::string::npos)
+  {
+    result += "." + fmt.substr(i+1);
+    fmt.resize(i);
+  }
+  return result + "." + fmt;
+}
+
+static std::string dirPart(const std::string &fileName)
+{
+  size_t i = fileName.find_last_of("/\\");
+  return i==std::string::npos ? std::string() : fileName.substr(0,i);
+}
+
+bool DotRunner::canBatch() const
+{
+  if (!Config_getBool(DOT_MULTI_TARGETS) || m_jobs.empty()) return false;
+  std::string dir = dirPart(m_file);
+  for (size_t i=0;i<m_jobs.size();i++)
+  {
+    // with -O the output is written next to the dot file, so only allow
+    // outputs in the same directory, such that they can be renamed in place.
+    if (dirPart(m_jobs[i].output)!=dir) return false;
+    // every format can be used only once in a batch run
+    for (size_t j=0;j<i;j++)
+    {
+      if (m_jobs[j].format==m_jobs[i].format) return false;
+    }
+  }
+  return true;
+}
+
+std::string DotRunner::batchSignature() const
+{
+  std::string result;
+  for (const auto &s : m_jobs)
+  {
+    result += s.format;
+    result += ' ';
+  }
+  return result;
+}
+
+void DotRunner::runBatch(const std::vector<DotRunner*> &runners)
+{
+  if (runners.empty()) return;
+  if (runners.size()==1)
+  {
+    runners.front()->run();
+    return;
+  }
+
+  // render all graphs with one dot invocation and let it name the output files
+  const DotRunner *first = runners.front();
+  QCString dotArgs;
+  for (const auto &s : first->m_jobs)
+  {
+    dotArgs+="-T";
+    dotArgs+=s.format.c_str();
+    dotArgs+=' ';
+  }
+  dotArgs+="-O";
+  for (const auto &runner : runners)
+  {
+    dotArgs+=" \"";
+    dotArgs+=runner->m_file.c_str();
+    dotArgs+='"';
+  }
+  auto startTime = std::chrono::steady_clock::now();
+  int exitCode = Portable::system(first->m_dotExe.data(),dotArgs,FALSE);
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now()-startTime).count();
+  Debug::print(Debug::ExtCmd,0,"Dot batch of %zu graphs took %.3f seconds\n",runners.size(),elapsed);
+
+  QDir dir;
+  for (const auto &runner : runners)
+  {
+    // move the output files to the names requested by the jobs
+    bool ok = exitCode==0;
+    for (const auto &s : runner->m_jobs)
+    {
+      std::string autoName = autoOutputName(runner->m_file,s.format);
+      if (ok)
+      {
+        dir.remove(s.output.c_str());
+        ok = dir.rename(autoName.c_str(),s.output.c_str());
+      }
+      if (!ok)
+      {
+        dir.remove(autoName.c_str());
+      }
+    }
+    if (!ok) // batch run did not work out for this graph, fall back to a normal run
+    {
+      runner->run();
+    }
+    else
+    {
+      // the time of the batch cannot be attributed exactly, divide it by the layout cost
+      int totalCost = 0;
+      for (const auto &r : runners) totalCost+=r->m_layoutCost;
+      runner->m_elapsedTime = totalCost>0 ? elapsed*runner->m_layoutCost/totalCost : elapsed/runners.size();
+      QCString args = dotArgs;
+      int code = exitCode;
+      if (!runner->checkResults(args,code))
+      {
+        err("Problems running dot: exit code=%d, command='%s', arguments='%s'\n",
+            code,runner->m_dotExe.data(),args.data());
+      }
+      runner->setFinished();
+    }
+  }
 }
 
 
 //--------------------------------------------------------------------
 
+// returns TRUE if item a should be run after item b.
+// Terminators (null runners) are only handed out when no real work is left.
+bool DotRunnerQueue::lessUrgent(const Item &a,const Item &b)
+{
+  if (a.runner==0 || b.runner==0)
+  {
+    return a.runner==0 && (b.runner!=0 || a.seqNr>b.seqNr);
+  }
+  if (a.runner->layoutCost()!=b.runner->layoutCost())
+  {
+    return a.runner->layoutCost()<b.runner->layoutCost();
+  }
+  return a.seqNr>b.seqNr;
+}
+
 void DotRunnerQueue::enqueue(DotRunner *runner)
 {
   std::lock_guard<std::mutex> locker(m_mutex);
-  m_queue.push(runner);
+  m_queue.push_back({runner,m_seqNr++});
+  std::push_heap(m_queue.begin(),m_queue.end(),lessUrgent);
   m_bufferNotEmpty.notify_all();
 }
 
@@ -268,8 +501,42 @@ DotRunner *DotRunnerQueue::dequeue()
   // wait until something is added to the queue
   m_bufferNotEmpty.wait(locker, [this]() { return !m_queue.empty(); });
 
-  DotRunner *result = m_queue.front();
-  m_queue.pop();
+  std::pop_heap(m_queue.begin(),m_queue.end(),lessUrgent);
+  DotRunner *result = m_queue.back().runner;
+  m_queue.pop_back();
+  return result;
+}
+
+std::vector<DotRunner *> DotRunnerQueue::dequeueBatchable(const DotRunner *runner,size_t maxCount)
+{
+  std::vector<DotRunner *> result;
+  std::vector<Item> skipped;
+  std::lock_guard<std::mutex> locker(m_mutex);
+  std::string signature = runner->batchSignature();
+  // take matches from the top of the heap, looking only at a limited number of
+  // other items so the queue is not held up; batching is an optimization only
+  size_t maxSkipped = 4*maxCount;
+  while (!m_queue.empty() && result.size()<maxCount && skipped.size()<maxSkipped)
+  {
+    std::pop_heap(m_queue.begin(),m_queue.end(),lessUrgent);
+    Item item = m_queue.back();
+    m_queue.pop_back();
+    if (item.runner && item.runner->canBatch() && item.runner->batchSignature()==signature)
+    {
+      result.push_back(item.runner);
+    }
+    else
+    {
+      skipped.push_back(item);
+      if (item.runner==0) break; // only stop markers remain
+    }
+  }
+  // put the other items back, they keep their sequence numbers
+  for (const auto &item : skipped)
+  {
+    m_queue.push_back(item);
+    std::push_heap(m_queue.begin(),m_queue.end(),lessUrgent);
+  }
   return result;
 }
 
@@ -296,10 +563,20 @@ DotWorkerThread::~DotWorkerThread()
 
 void DotWorkerThread::run()
 {
+  size_t batchSize = static_cast<size_t>(Config_getInt(DOT_BATCH_SIZE));
   DotRunner *runner;
   while ((runner=m_queue->dequeue()))
   {
-    runner->run();
+    if (batchSize>1 && runner->canBatch())
+    {
+      std::vector<DotRunner*> batch = m_queue->dequeueBatchable(runner,batchSize-1);
+      batch.insert(batch.begin(),runner);
+      DotRunner::runBatch(batch);
+    }
+    else
+    {
+      runner->run();
+    }
   }
 }
 
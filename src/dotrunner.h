@@ -19,11 +19,13 @@
 #include <string>
 #include <thread>
 #include <list>
-#include <queue>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
 #include <memory>
 
+#include <qcstring.h>
+
 /** Helper class to run dot from doxygen from multiple threads.  */
 class DotRunner
 {
@@ -48,33 +50,102 @@ class DotRunner
     /** Prevent cleanup of the dot file (for user provided dot files) */
     void preventCleanUp() { m_cleanUp = false; }
 
+    /** Sets the estimated cost of laying out the graph, used to run
+     *  expensive graphs first.
+     */
+    void setLayoutCost(int cost) { m_layoutCost = cost; }
+    int layoutCost() const { return m_layoutCost; }
+
+    /** Returns the time in seconds it took to render the graph(s) of this runner */
+    double elapsedTime() const { return m_elapsedTime; }
+    const std::string &fileName() const { return m_file; }
+
     /** Runs dot for all jobs added. */
     bool run();
 
+    /** Marks the runner as handed to the worker threads while the output is
+     *  still being generated. From then on the jobs of the runner are fixed;
+     *  jobs added later are kept apart until activateLateJobs() is called.
+     *  Removal of the dot file is left to cleanUp().
+     */
+    void setPipelined();
+    bool isPipelined() const;
+    /** Returns TRUE if jobs were added after the runner was pipelined */
+    bool hasLateJobs() const;
+    /** Replaces the jobs of a finished runner by the jobs added after it was
+     *  pipelined, such that it can be run again.
+     */
+    void activateLateJobs();
+    /** Blocks until a (pipelined) run of this runner has finished */
+    void waitUntilFinished();
+    /** Removes the dot file if requested, for pipelined runners */
+    void cleanUp();
+
+    /** Returns TRUE if this runner can be rendered together with other runners
+     *  with the same batchSignature() in a single dot invocation.
+     */
+    bool canBatch() const;
+
+    /** Returns a string identifying the output formats of this runner */
+    std::string batchSignature() const;
+
+    /** Runs dot once for all \a runners, which should have the same
+     *  batchSignature(). Runners for which this fails are run one by one.
+     */
+    static void runBatch(const std::vector<DotRunner*> &runners);
+
     //  DotConstString const& getFileName() { return m_file; }
     std::string const & getMd5Hash() { return m_md5Hash; }
 
     static bool readBoundingBox(const char* fileName, int* width, int* height, bool isEps);
 
   private:
+    bool runDot();
+    bool checkResults(QCString &dotArgs,int &exitCode);
+    void setFinished();
+
     std::string m_file;
     std::string m_md5Hash;
     std::string m_dotExe;
     bool        m_cleanUp;
+    int         m_layoutCost = 0;
+    double      m_elapsedTime = 0.0;
+    // m_jobsMutex guards m_pipelined, m_lateJobs and changes to m_jobs. Once the
+    // runner is pipelined m_jobs only changes in activateLateJobs(), after the
+    // run has finished, so the worker running it can read m_jobs without locking.
+    mutable std::mutex   m_jobsMutex;
     std::vector<DotJob>  m_jobs;
+    bool        m_pipelined = false;
+    std::vector<DotJob>  m_lateJobs;
+    bool        m_finished = false;
+    std::mutex  m_finishedMutex;
+    std::condition_variable m_finishedCond;
 };
 
-/** Queue of dot jobs to run. */
+/** Queue of dot jobs to run. Runners with the highest layout cost are
+ *  dequeued first, runners with equal cost in the order they were added.
+ */
 // all methods are thread save
 class DotRunnerQueue
 {
   public:
     void enqueue(DotRunner *runner);
     DotRunner *dequeue();
+    /** Removes up to \a maxCount queued runners that can be batched with \a runner
+     *  (without waiting) and returns them. Only the most urgent runners are considered.
+     */
+    std::vector<DotRunner *> dequeueBatchable(const DotRunner *runner,size_t maxCount);
     size_t size() const;
   private:
+    struct Item
+    {
+      DotRunner *runner;
+      size_t     seqNr;
+    };
+    static bool lessUrgent(const Item &a,const Item &b);
     std::condition_variable m_bufferNotEmpty;
-    std::queue<DotRunner *> m_queue;
+    std::vector<Item>     m_queue; // binary heap, most urgent item first
+    size_t                m_seqNr = 0;
     mutable std::mutex    m_mutex;
 };
 
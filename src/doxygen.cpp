@@ -28,6 +28,10 @@
 #include <qtextstream.h>
 
 #include <algorithm>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <memory>
 #include <cinttypes>
@@ -70,6 +74,7 @@
 #include "cmdmapper.h"
 #include "searchindex.h"
 #include "parserintf.h"
+#include "parsecache.h"
 #include "htags.h"
 #include "pycode.h"
 #include "pyscanner.h"
@@ -137,19 +142,19 @@ StringMap             Doxygen::tagDestinationMap;            // all tag location
 StringUnorderedSet    Doxygen::expandAsDefinedSet;           // all macros that should be expanded
 MemberGroupInfoMap    Doxygen::memberGroupInfoMap;           // dictionary of the member groups heading
 std::unique_ptr<PageDef> Doxygen::mainPage;
-bool                  Doxygen::insideMainPage = FALSE; // are we generating docs for the main page?
+THREAD_LOCAL bool     Doxygen::insideMainPage = FALSE; // are we generating docs for the main page?
 NamespaceDefMutable  *Doxygen::globalScope = 0;
 bool                  Doxygen::parseSourcesNeeded = FALSE;
 SearchIndexIntf      *Doxygen::searchIndex=0;
 SymbolMap<Definition> Doxygen::symbolMap;
 ClangUsrMap          *Doxygen::clangUsrMap = 0;
 bool                  Doxygen::outputToWizard=FALSE;
-Cache<std::string,LookupInfo> *Doxygen::lookupCache;
+ShardedCache<std::string,LookupInfo> *Doxygen::lookupCache;
 DirLinkedMap         *Doxygen::dirLinkedMap;
 DirRelationLinkedMap  Doxygen::dirRelations;
 ParserManager        *Doxygen::parserManager = 0;
 QCString              Doxygen::htmlFileExtension;
-bool                  Doxygen::suppressDocWarnings = FALSE;
+THREAD_LOCAL bool     Doxygen::suppressDocWarnings = FALSE;
 QCString              Doxygen::filterDBFileName;
 IndexList            *Doxygen::indexList;
 int                   Doxygen::subpageNestingLevel = 0;
@@ -7717,99 +7722,206 @@ static void generateFileSources()
     else
 #endif
     {
-#define MULTITHREADED_SOURCE_GENERATOR 0 // not ready to be enabled yet
-#if MULTITHREADED_SOURCE_GENERATOR
       std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
       if (numThreads==0)
       {
         numThreads = std::thread::hardware_concurrency();
       }
-      msg("Generating code files using %zu threads.\n",numThreads);
-      struct SourceContext
-      {
-        SourceContext(FileDef *fd_,bool gen_,OutputList ol_)
-          : fd(fd_), generateSourceFile(gen_), ol(ol_) {}
-        FileDef *fd;
-        bool generateSourceFile;
-        OutputList ol;
-      };
-      ThreadPool threadPool(numThreads);
-      std::vector< std::future< std::shared_ptr<SourceContext> > > results;
-      for (const auto &fn : *Doxygen::inputNameLinkedMap)
-      {
-        for (const auto &fd : *fn)
-        {
-          bool generateSourceFile = fd->generateSourceFile() && !Htags::useHtags && !g_useOutputTemplate;
-          auto ctx = std::make_shared<SourceContext>(fd.get(),generateSourceFile,*g_outputList);
-          if (generateSourceFile)
+      if (numThreads>1 && Config_getBool(PARALLEL_SOURCE_GENERATION)) // multi threaded version
+      {
+        msg("Generating code files using %zu threads.\n",numThreads);
+        // The header and footer of each source file are written by the main thread in input
+        // order, only the body is generated by the worker threads. Together with the
+        // recorded search index updates this makes the output identical to that of the
+        // single threaded version. The number of files in flight is bounded to keep the
+        // number of open output files within limits.
+        struct SourceContext
+        {
+          SourceContext(FileDef *fd_,bool gen_,OutputList ol_)
+            : fd(fd_), generateSourceFile(gen_), ol(ol_) {}
+          FileDef *fd;
+          bool generateSourceFile;
+          OutputList ol;
+          SearchIndexRecorder searchRecorder;
+        };
+        const std::size_t maxFilesInFlight = 4*numThreads;
+        WorkStealingThreadPool threadPool(numThreads);
+        std::deque< std::future< std::shared_ptr<SourceContext> > > results;
+        auto finishFile = [&results]()
+        {
+          auto ctx = results.front().get();
+          results.pop_front();
+          ctx->searchRecorder.replay(Doxygen::searchIndex);
+          if (ctx->generateSourceFile)
           {
-            msg("Generating code for file %s...\n",fd->docName().data());
-            fd->writeSourceHeader(ctx->ol);
+            ctx->fd->writeSourceFooter(ctx->ol);
           }
-          else
+        };
+        for (const auto &fn : *Doxygen::inputNameLinkedMap)
+        {
+          for (const auto &fd : *fn)
           {
-            msg("Parsing code for file %s...\n",fd->docName().data());
-          }
-          auto processFile = [ctx]() {
-            StringVector filesInSameTu;
-            ctx->fd->getAllIncludeFilesRecursively(filesInSameTu);
-            if (ctx->generateSourceFile) // sources need to be shown in the output
+            bool generateSourceFile = fd->generateSourceFile() && !Htags::useHtags && !g_useOutputTemplate;
+            bool parseSource = !generateSourceFile && !fd->isReference() && Doxygen::parseSourcesNeeded;
+            if (!generateSourceFile && !parseSource) continue;
+            if (results.size()>=maxFilesInFlight)
             {
-              ctx->fd->writeSourceBody(ctx->ol,nullptr);
+              finishFile();
             }
-            else if (!ctx->fd->isReference() && Doxygen::parseSourcesNeeded)
-              // we needed to parse the sources even if we do not show them
+            auto ctx = std::make_shared<SourceContext>(fd.get(),generateSourceFile,*g_outputList);
+            if (generateSourceFile)
+            {
+              msg("Generating code for file %s...\n",fd->docName().data());
+              fd->writeSourceHeader(ctx->ol);
+            }
+            else
             {
-              ctx->fd->parseSource(nullptr);
+              msg("Parsing code for file %s...\n",fd->docName().data());
             }
-            return ctx;
-          };
-          results.emplace_back(threadPool.queue(processFile));
+            auto processFile = [ctx]()
+            {
+              SearchIndexRecorder::setActive(&ctx->searchRecorder);
+              if (ctx->generateSourceFile) // sources need to be shown in the output
+              {
+                ctx->fd->writeSourceBody(ctx->ol,nullptr);
+              }
+              else // we needed to parse the sources even if we do not show them
+              {
+                ctx->fd->parseSource(nullptr);
+              }
+              SearchIndexRecorder::setActive(0);
+              return ctx;
+            };
+            results.emplace_back(threadPool.queue(processFile));
+          }
         }
-      }
-      for (auto &f : results)
-      {
-        auto ctx = f.get();
-        if (ctx->generateSourceFile)
+        while (!results.empty())
         {
-          ctx->fd->writeSourceFooter(ctx->ol);
+          finishFile();
         }
       }
-#else // single threaded version
-      for (const auto &fn : *Doxygen::inputNameLinkedMap)
+      else // single threaded version
       {
-        for (const auto &fd : *fn)
+        for (const auto &fn : *Doxygen::inputNameLinkedMap)
         {
-          StringVector filesInSameTu;
-          fd->getAllIncludeFilesRecursively(filesInSameTu);
-          if (fd->generateSourceFile() && !Htags::useHtags && !g_useOutputTemplate) // sources need to be shown in the output
+          for (const auto &fd : *fn)
           {
-            msg("Generating code for file %s...\n",fd->docName().data());
-            fd->writeSourceHeader(*g_outputList);
-            fd->writeSourceBody(*g_outputList,nullptr);
-            fd->writeSourceFooter(*g_outputList);
-          }
-          else if (!fd->isReference() && Doxygen::parseSourcesNeeded)
-            // we needed to parse the sources even if we do not show them
-          {
-            msg("Parsing code for file %s...\n",fd->docName().data());
-            fd->parseSource(nullptr);
+            StringVector filesInSameTu;
+            fd->getAllIncludeFilesRecursively(filesInSameTu);
+            if (fd->generateSourceFile() && !Htags::useHtags && !g_useOutputTemplate) // sources need to be shown in the output
+            {
+              msg("Generating code for file %s...\n",fd->docName().data());
+              fd->writeSourceHeader(*g_outputList);
+              fd->writeSourceBody(*g_outputList,nullptr);
+              fd->writeSourceFooter(*g_outputList);
+            }
+            else if (!fd->isReference() && Doxygen::parseSourcesNeeded)
+              // we needed to parse the sources even if we do not show them
+            {
+              msg("Parsing code for file %s...\n",fd->docName().data());
+              fd->parseSource(nullptr);
+            }
           }
         }
       }
-#endif
     }
   }
 }
 
 //----------------------------------------------------------------------------
 
+/** Generates the documentation of a sequence of compounds, either directly
+ *  on the calling thread, or using a pool of worker threads when
+ *  NUM_PROC_THREADS is larger than one.
+ *
+ *  Each job gets its own copy of the output list. The updates a job makes to
+ *  Doxygen::indexList and Doxygen::searchIndex are recorded and applied in the
+ *  order in which the jobs were added, so the indices do not depend on the order
+ *  in which the threads finish.
+ */
+class CompoundDocGenerator
+{
+  public:
+    using Job = std::function<void(OutputList &)>;
+
+    CompoundDocGenerator()
+    {
+      std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+      if (numThreads==0)
+      {
+        numThreads = std::thread::hardware_concurrency();
+      }
+      // the VHDL documentation generator still keeps its state in globals
+      if (numThreads>1 && !Config_getBool(OPTIMIZE_OUTPUT_VHDL))
+      {
+        m_jobs = std::make_unique< OrderedJobQueue< std::shared_ptr<Context> > >(numThreads,
+            [](std::shared_ptr<Context> &ctx)
+            {
+              ctx->indexRecorder.replay(*Doxygen::indexList);
+              ctx->searchRecorder.replay(Doxygen::searchIndex);
+            });
+      }
+    }
+
+    /** Runs \a job now (single threaded) or queues it for one of the worker threads.
+     *  In the latter case inline graphs generated by the job are named after
+     *  \a scope, so the names do not depend on the order in which the jobs are run.
+     */
+    void add(const QCString &scope,Job &&job)
+    {
+      if (!m_jobs) // single threaded version, keeps the global graph numbering
+      {
+        job(*g_outputList);
+        return;
+      }
+      auto ctx = std::make_shared<Context>(*g_outputList,scope,std::move(job));
+      auto processJob = [ctx]()
+      {
+        IndexRecorder::setActive(&ctx->indexRecorder);
+        SearchIndexRecorder::setActive(&ctx->searchRecorder);
+        {
+          InlineGraphScope graphScope(ctx->scope);
+          ctx->job(ctx->ol);
+        }
+        SearchIndexRecorder::setActive(0);
+        IndexRecorder::setActive(0);
+        return ctx;
+      };
+      m_jobs->queue(processJob);
+    }
+
+    /** Waits for all queued jobs and applies their index updates.
+     *  Must be called before the generator goes out of scope.
+     */
+    void finish()
+    {
+      if (m_jobs) m_jobs->finish();
+    }
+
+  private:
+    struct Context
+    {
+      Context(const OutputList &ol_,const QCString &scope_,Job &&job_)
+        : ol(ol_), scope(scope_), job(std::move(job_)) {}
+      OutputList ol;
+      QCString scope;
+      Job job;
+      IndexRecorder indexRecorder;
+      SearchIndexRecorder searchRecorder;
+    };
+
+    std::unique_ptr< OrderedJobQueue< std::shared_ptr<Context> > > m_jobs;
+};
+
+//----------------------------------------------------------------------------
+
 static void generateFileDocs()
 {
   if (documentedHtmlFiles==0) return;
 
   if (!Doxygen::inputNameLinkedMap->empty())
   {
+    CompoundDocGenerator docGen;
     for (const auto &fn : *Doxygen::inputNameLinkedMap)
     {
       for (const auto &fd : *fn)
@@ -7818,10 +7930,12 @@ static void generateFileDocs()
         if (doc)
         {
           msg("Generating docs for file %s...\n",fd->docName().data());
-          fd->writeDocumentation(*g_outputList);
+          FileDef *fdp = fd.get();
+          docGen.add(fdp->getOutputFileBase(),[fdp](OutputList &ol) { fdp->writeDocumentation(ol); });
         }
       }
     }
+    docGen.finish();
   }
 }
 
@@ -8046,7 +8160,7 @@ static void countMembers()
 //----------------------------------------------------------------------------
 // generate the documentation of all classes
 
-static void generateClassList(const ClassLinkedMap &classList)
+static void generateClassList(CompoundDocGenerator &docGen,const ClassLinkedMap &classList)
 {
   for (const auto &cdi : classList)
   {
@@ -8061,23 +8175,31 @@ static void generateClassList(const ClassLinkedMap &classList)
     {
       // skip external references, anonymous compounds and
       // template instances
-      if ( cd->isLinkableInProject() && cd->templateMaster()==0)
+      bool writeDoc = cd->isLinkableInProject() && cd->templateMaster()==0;
+      if (writeDoc)
       {
         msg("Generating docs for compound %s...\n",cd->name().data());
-
-        cd->writeDocumentation(*g_outputList);
-        cd->writeMemberList(*g_outputList);
       }
-      // even for undocumented classes, the inner classes can be documented.
-      cd->writeDocumentationForInnerClasses(*g_outputList);
+      docGen.add(cd->getOutputFileBase(),[cd,writeDoc](OutputList &ol)
+      {
+        if (writeDoc)
+        {
+          cd->writeDocumentation(ol);
+          cd->writeMemberList(ol);
+        }
+        // even for undocumented classes, the inner classes can be documented.
+        cd->writeDocumentationForInnerClasses(ol);
+      });
     }
   }
 }
 
 static void generateClassDocs()
 {
-  generateClassList(*Doxygen::classLinkedMap);
-  generateClassList(*Doxygen::hiddenClassLinkedMap);
+  CompoundDocGenerator docGen;
+  generateClassList(docGen,*Doxygen::classLinkedMap);
+  generateClassList(docGen,*Doxygen::hiddenClassLinkedMap);
+  docGen.finish();
 }
 
 //----------------------------------------------------------------------------
@@ -8263,19 +8385,10 @@ static void flushCachedTemplateRelations()
   // as there can be new template instances in the inheritance path
   // to this class. Optimization: only remove those classes that
   // have inheritance instances as direct or indirect sub classes.
-  StringVector elementsToRemove;
-  for (const auto &ci : *Doxygen::lookupCache)
-  {
-    const LookupInfo &li = ci.second;
-    if (li.classDef)
-    {
-      elementsToRemove.push_back(ci.first);
-    }
-  }
-  for (const auto &k : elementsToRemove)
+  Doxygen::lookupCache->removeIf([](const std::string &,const LookupInfo &li)
   {
-    Doxygen::lookupCache->remove(k);
-  }
+    return li.classDef!=0;
+  });
 
   // remove all cached typedef resolutions whose target is a
   // template class as this may now be a template instance
@@ -8323,19 +8436,10 @@ static void flushUnresolvedRelations()
   // class B : public A {};
   // class C : public B::I {};
 
-  StringVector elementsToRemove;
-  for (const auto &ci : *Doxygen::lookupCache)
-  {
-    const LookupInfo &li = ci.second;
-    if (li.classDef==0 && li.typeDef==0)
-    {
-      elementsToRemove.push_back(ci.first);
-    }
-  }
-  for (const auto &k : elementsToRemove)
+  Doxygen::lookupCache->removeIf([](const std::string &,const LookupInfo &li)
   {
-    Doxygen::lookupCache->remove(k);
-  }
+    return li.classDef==0 && li.typeDef==0;
+  });
 
   // for each global function name
   for (const auto &fn : *Doxygen::functionNameLinkedMap)
@@ -8682,6 +8786,30 @@ static void computePageRelations(Entry *root)
   for (const auto &e : root->children()) computePageRelations(e.get());
 }
 
+/** Removes the entries below \a root that are not needed anymore once the
+ *  members and their documentation have been processed. The remaining steps
+ *  that walk the entry tree only look at pages, the main page and groups, so
+ *  only those and the scopes that contain them are kept. The entries of an
+ *  input file share one arena, so the memory of a file whose entries are all
+ *  removed is released as a whole.
+ *  Returns the number of entries that were removed.
+ */
+static int releaseProcessedEntries(Entry *root)
+{
+  int numRemoved=0;
+  root->removeSubEntries([&numRemoved](Entry *e)
+  {
+    numRemoved+=releaseProcessedEntries(e);
+    bool keep = e->section==Entry::PAGEDOC_SEC ||
+                e->section==Entry::MAINPAGEDOC_SEC ||
+                e->section==Entry::GROUPDOC_SEC ||
+                !e->children().empty();
+    if (!keep) numRemoved++;
+    return !keep;
+  });
+  return numRemoved;
+}
+
 static void checkPageRelations()
 {
   for (const auto &pd : *Doxygen::pageLinkedMap)
@@ -8774,16 +8902,22 @@ static void generatePageDocs()
 {
   //printf("documentedPages=%d real=%d\n",documentedPages,Doxygen::pageLinkedMap->count());
   if (documentedPages==0) return;
+  CompoundDocGenerator docGen;
   for (const auto &pd : *Doxygen::pageLinkedMap)
   {
     if (!pd->getGroupDef() && !pd->isReference())
     {
       msg("Generating docs for page %s...\n",pd->name().data());
-      Doxygen::insideMainPage=TRUE;
-      pd->writeDocumentation(*g_outputList);
-      Doxygen::insideMainPage=FALSE;
+      PageDef *pdp = pd.get();
+      docGen.add(pdp->getOutputFileBase(),[pdp](OutputList &ol)
+      {
+        Doxygen::insideMainPage=TRUE;
+        pdp->writeDocumentation(ol);
+        Doxygen::insideMainPage=FALSE;
+      });
     }
   }
+  docGen.finish();
 }
 
 //----------------------------------------------------------------------------
@@ -8882,19 +9016,22 @@ static void generateExampleDocs()
 
 static void generateGroupDocs()
 {
+  CompoundDocGenerator docGen;
   for (const auto &gd : *Doxygen::groupLinkedMap)
   {
     if (!gd->isReference())
     {
-      gd->writeDocumentation(*g_outputList);
+      GroupDef *gdp = gd.get();
+      docGen.add(gdp->getOutputFileBase(),[gdp](OutputList &ol) { gdp->writeDocumentation(ol); });
     }
   }
+  docGen.finish();
 }
 
 //----------------------------------------------------------------------------
 // generate module pages
 
-static void generateNamespaceClassDocs(const ClassLinkedRefMap &classList)
+static void generateNamespaceClassDocs(CompoundDocGenerator &docGen,const ClassLinkedRefMap &classList)
 {
   // for each class in the namespace...
   for (const auto &cd : classList)
@@ -8902,19 +9039,24 @@ static void generateNamespaceClassDocs(const ClassLinkedRefMap &classList)
     ClassDefMutable *cdm = toClassDefMutable(cd);
     if (cdm)
     {
-      if ( ( cd->isLinkableInProject() &&
-             cd->templateMaster()==0
-           ) // skip external references, anonymous compounds and
-          // template instances and nested classes
-          && !cd->isHidden() && !cd->isEmbeddedInOuterScope()
-         )
+      bool writeDoc = ( cd->isLinkableInProject() &&
+                        cd->templateMaster()==0
+                      ) // skip external references, anonymous compounds and
+                      // template instances and nested classes
+                      && !cd->isHidden() && !cd->isEmbeddedInOuterScope();
+      if (writeDoc)
       {
         msg("Generating docs for compound %s...\n",cd->name().data());
-
-        cdm->writeDocumentation(*g_outputList);
-        cdm->writeMemberList(*g_outputList);
       }
-      cdm->writeDocumentationForInnerClasses(*g_outputList);
+      docGen.add(cdm->getOutputFileBase(),[cdm,writeDoc](OutputList &ol)
+      {
+        if (writeDoc)
+        {
+          cdm->writeDocumentation(ol);
+          cdm->writeMemberList(ol);
+        }
+        cdm->writeDocumentationForInnerClasses(ol);
+      });
     }
   }
 }
@@ -8925,6 +9067,7 @@ static void generateNamespaceDocs()
 
   //writeNamespaceIndex(*g_outputList);
 
+  CompoundDocGenerator docGen;
   // for each namespace...
   for (const auto &nd : *Doxygen::namespaceLinkedMap)
   {
@@ -8934,18 +9077,19 @@ static void generateNamespaceDocs()
       if (ndm)
       {
         msg("Generating docs for namespace %s\n",nd->name().data());
-        ndm->writeDocumentation(*g_outputList);
+        docGen.add(ndm->getOutputFileBase(),[ndm](OutputList &ol) { ndm->writeDocumentation(ol); });
       }
     }
 
-    generateNamespaceClassDocs(nd->getClasses());
+    generateNamespaceClassDocs(docGen,nd->getClasses());
     if (sliceOpt)
     {
-      generateNamespaceClassDocs(nd->getInterfaces());
-      generateNamespaceClassDocs(nd->getStructs());
-      generateNamespaceClassDocs(nd->getExceptions());
+      generateNamespaceClassDocs(docGen,nd->getInterfaces());
+      generateNamespaceClassDocs(docGen,nd->getStructs());
+      generateNamespaceClassDocs(docGen,nd->getExceptions());
     }
   }
+  docGen.finish();
 }
 
 #if defined(_WIN32)
@@ -9334,14 +9478,44 @@ static std::shared_ptr<Entry> parseFile(OutlineParserInterface &parser,
 
   convBuf.addChar('\0');
 
-  std::shared_ptr<Entry> fileRoot = std::make_shared<Entry>();
-  // use language parse to parse the file
-  if (clangParser)
+  // allocate the entries for this file from their own arena, it is released
+  // when the last entry of the file is destroyed
+  EntryArena::Scope arenaScope;
+  std::shared_ptr<Entry> fileRoot;
+  ParseCache &parseCache = ParseCache::instance();
+  QCString cacheKey;
+  if (parseCache.isEnabled() && clangParser==0 && parser.supportsParseCache())
+  {
+    cacheKey = parseCache.computeKey(fileName,convBuf.data(),convBuf.curPos());
+    fileRoot = parseCache.load(cacheKey);
+    if (fileRoot)
+    {
+      parser.skipInput(fileName);
+    }
+  }
+  if (!fileRoot)
   {
-    if (newTU) clangParser->parse();
-    clangParser->switchToFile(fd);
+    fileRoot = Entry::create();
+    // use language parse to parse the file
+    if (clangParser)
+    {
+      if (newTU) clangParser->parse();
+      clangParser->switchToFile(fd);
+    }
+    if (!cacheKey.isEmpty())
+    {
+      ParseCache::startRecording();
+      parser.parseInput(fileName,convBuf.data(),fileRoot,clangParser);
+      if (ParseCache::stopRecording())
+      {
+        parseCache.store(cacheKey,fileRoot.get());
+      }
+    }
+    else
+    {
+      parser.parseInput(fileName,convBuf.data(),fileRoot,clangParser);
+    }
   }
-  parser.parseInput(fileName,convBuf.data(),fileRoot,clangParser);
   fileRoot->setFileDef(fd);
   return fileRoot;
 }
@@ -9369,7 +9543,7 @@ static void parseFilesMultiThreading(const std::shared_ptr<Entry> &root)
       numThreads = std::thread::hardware_concurrency();
     }
     msg("Processing input using %zu threads.\n",numThreads);
-    ThreadPool threadPool(numThreads);
+    WorkStealingThreadPool threadPool(numThreads);
     using FutureType = std::vector< std::shared_ptr<Entry> >;
     std::vector< std::future< FutureType > > results;
     for (const auto &s : g_inputFiles)
@@ -9462,29 +9636,93 @@ static void parseFilesMultiThreading(const std::shared_ptr<Entry> &root)
   else // normal processing
 #endif
   {
-    std::size_t numThreads = std::thread::hardware_concurrency();
+    std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+    if (numThreads==0)
+    {
+      numThreads = std::thread::hardware_concurrency();
+    }
     msg("Processing input using %zu threads.\n",numThreads);
-    ThreadPool threadPool(numThreads);
-    using FutureType = std::shared_ptr<Entry>;
-    std::vector< std::future< FutureType > > results;
+
+    // Queue the largest files first, so that a big file does not end up at the
+    // end of the queue keeping one thread busy while the others are idle.
+    // The results are still added to the root in input order.
+    struct InputFile
+    {
+      InputFile(const std::string &n,std::size_t i) : name(n), index(i), size(QFileInfo(n.c_str()).size()) {}
+      std::string name;
+      std::size_t index;
+      uint size;
+    };
+    std::vector<InputFile> inputFiles;
+    inputFiles.reserve(g_inputFiles.size());
     for (const auto &s : g_inputFiles)
+    {
+      inputFiles.emplace_back(s,inputFiles.size());
+    }
+    std::stable_sort(inputFiles.begin(),inputFiles.end(),
+                     [](const InputFile &f1,const InputFile &f2) { return f1.size>f2.size; });
+
+    // time spent by each worker thread on parsing, reported with -d time
+    struct ThreadStats
+    {
+      double busy = 0;
+      int numFiles = 0;
+    };
+    std::mutex threadStatsLock;
+    std::map<std::thread::id,ThreadStats> threadStats;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    WorkStealingThreadPool threadPool(numThreads);
+    using FutureType = std::shared_ptr<Entry>;
+    std::vector< std::future< FutureType > > results(inputFiles.size());
+    for (const auto &f : inputFiles)
     {
       // lambda representing the work to executed by a thread
-      auto processFile = [s]() {
+      auto processFile = [s=f.name,&threadStatsLock,&threadStats]() {
+        std::chrono::steady_clock::time_point fileStartTime = std::chrono::steady_clock::now();
         bool ambig;
         FileDef *fd=findFileDef(Doxygen::inputNameLinkedMap,s.c_str(),ambig);
         auto parser = getParserForFile(s.c_str());
         auto fileRoot = parseFile(*parser.get(),fd,s.c_str(),nullptr,true);
+        std::chrono::steady_clock::time_point fileEndTime = std::chrono::steady_clock::now();
+        {
+          std::lock_guard<std::mutex> lock(threadStatsLock);
+          ThreadStats &stats = threadStats[std::this_thread::get_id()];
+          stats.busy += std::chrono::duration_cast<
+                          std::chrono::microseconds>(fileEndTime - fileStartTime).count()/1000000.0;
+          stats.numFiles++;
+        }
         return fileRoot;
       };
       // dispatch the work and collect the future results
-      results.emplace_back(threadPool.queue(processFile));
+      results[f.index] = threadPool.queue(processFile);
     }
     // synchronise with the Entry results produced and add them to the root
     for (auto &f : results)
     {
       root->moveToSubEntryAndKeep(f.get());
     }
+
+    if (Debug::isFlagSet(Debug::Time))
+    {
+      std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+      double elapsed = std::chrono::duration_cast<
+                         std::chrono::microseconds>(endTime - startTime).count()/1000000.0;
+      std::lock_guard<std::mutex> lock(threadStatsLock);
+      int threadIndex=0;
+      for (const auto &kv : threadStats)
+      {
+        const ThreadStats &stats = kv.second;
+        Debug::print(Debug::Time,0,"Parser thread %d: parsed %d files, busy %.6f seconds, idle %.6f seconds\n",
+                     ++threadIndex,stats.numFiles,stats.busy,elapsed-stats.busy);
+      }
+      // threads that did not get any work to do
+      while (threadIndex<static_cast<int>(numThreads))
+      {
+        Debug::print(Debug::Time,0,"Parser thread %d: parsed 0 files, busy 0.000000 seconds, idle %.6f seconds\n",
+                     ++threadIndex,elapsed);
+      }
+    }
   }
 }
 
@@ -11002,7 +11240,7 @@ void parseInput()
   if (cacheSize<0) cacheSize=0;
   if (cacheSize>9) cacheSize=9;
   uint lookupSize = 65536 << cacheSize;
-  Doxygen::lookupCache = new Cache<std::string,LookupInfo>(lookupSize);
+  Doxygen::lookupCache = new ShardedCache<std::string,LookupInfo>(lookupSize);
 
 #ifdef HAS_SIGNALS
   signal(SIGINT, stopDoxygen);
@@ -11178,6 +11416,7 @@ void parseInput()
   addSTLSupport(root);
 
   g_s.begin("Parsing files\n");
+  ParseCache::instance().init();
   if (Config_getInt(NUM_PROC_THREADS)==1)
   {
     parseFilesSingleThreading(root);
@@ -11186,6 +11425,7 @@ void parseInput()
   {
     parseFilesMultiThreading(root);
   }
+  ParseCache::instance().printStatistics();
   g_s.end();
 
   /**************************************************************************
@@ -11340,6 +11580,14 @@ void parseInput()
   transferFunctionDocumentation();
   g_s.end();
 
+  g_s.begin("Releasing entries that are no longer needed...\n");
+  int numReleased = releaseProcessedEntries(root.get());
+  if (Debug::isFlagSet(Debug::Time))
+  {
+    msg("Released %d entries, %d remaining\n",numReleased,Entry::count());
+  }
+  g_s.end();
+
   // moved to after finding and copying documentation,
   // as this introduces new members see bug 722654
   g_s.begin("Creating members for template instances...\n");
@@ -11364,6 +11612,20 @@ void parseInput()
   findGroupScope(root.get());
   g_s.end();
 
+  // The entry tree is not used by any of the steps below, so release what is left
+  // of it (see releaseProcessedEntries()). This does not lower the peak during
+  // parsing: the member passes need the entries of all files.
+  // Destroying a large tree takes a while, so this is done in the background.
+  std::thread entryTreeReleaser;
+  if (Config_getInt(NUM_PROC_THREADS)==1)
+  {
+    root.reset();
+  }
+  else
+  {
+    entryTreeReleaser = std::thread([tree=std::move(root)]() mutable { tree.reset(); });
+  }
+
   auto memberNameComp = [](const MemberNameLinkedMap::Ptr &n1,const MemberNameLinkedMap::Ptr &n2)
   {
     return qstricmp(n1->memberName()+getPrefixIndex(n1->memberName()),
@@ -11527,6 +11789,10 @@ void parseInput()
     }
   }
 
+  if (entryTreeReleaser.joinable())
+  {
+    entryTreeReleaser.join();
+  }
 }
 
 void generateOutput()
@@ -11872,6 +12138,15 @@ void generateOutput()
       Doxygen::lookupCache->capacity(),
       Doxygen::lookupCache->hits(),
       Doxygen::lookupCache->misses());
+  if (Debug::isFlagSet(Debug::Time))
+  {
+    for (size_t i=0;i<Doxygen::lookupCache->numShards();i++)
+    {
+      auto stats = Doxygen::lookupCache->shardStats(i);
+      msg("  shard %2zu used %zu/%zu hits=%" PRIu64 " misses=%" PRIu64 "\n",
+          i,stats.size,stats.capacity,stats.hits,stats.misses);
+    }
+  }
   cacheParam = computeIdealCacheParam(Doxygen::lookupCache->misses()*2/3); // part of the cache is flushed, hence the 2/3 correction factor
   if (cacheParam>Config_getInt(LOOKUP_CACHE_SIZE))
   {
@@ -83,7 +83,7 @@ class Doxygen
     static PageLinkedMap            *exampleLinkedMap;
     static PageLinkedMap            *pageLinkedMap;
     static std::unique_ptr<PageDef>  mainPage;
-    static bool                      insideMainPage;
+    static THREAD_LOCAL bool         insideMainPage;
     static FileNameLinkedMap        *includeNameLinkedMap;
     static FileNameLinkedMap        *exampleNameLinkedMap;
     static StringSet                 inputPaths;
@@ -108,11 +108,11 @@ class Doxygen
     static SymbolMap<Definition>     symbolMap;
     static ClangUsrMap              *clangUsrMap;
     static bool                      outputToWizard;
-    static Cache<std::string,LookupInfo> *lookupCache;
+    static ShardedCache<std::string,LookupInfo> *lookupCache;
     static DirLinkedMap             *dirLinkedMap;
     static DirRelationLinkedMap      dirRelations;
     static ParserManager            *parserManager;
-    static bool                      suppressDocWarnings;
+    static THREAD_LOCAL bool         suppressDocWarnings;
     static QCString                  filterDBFileName;
     static bool                      userComments;
     static IndexList                *indexList;
@@ -13,6 +13,8 @@
  *
  */
 
+#include <mutex>
+
 #include "emoji.h"
 #include "message.h"
 #include "ftextstream.h"
@@ -1518,6 +1520,7 @@ static struct emojiEntityInfo
 static const int g_numEmojiEntities = (int)(sizeof(g_emojiEntities)/sizeof(*g_emojiEntities));
 
 EmojiEntityMapper *EmojiEntityMapper::s_instance = 0;
+static std::mutex g_instanceMutex;
 
 EmojiEntityMapper::EmojiEntityMapper()
 {
@@ -1535,6 +1538,7 @@ EmojiEntityMapper::~EmojiEntityMapper()
 /** Returns the one and only instance of the Emoji entity mapper */
 EmojiEntityMapper *EmojiEntityMapper::instance()
 {
+  std::lock_guard<std::mutex> lock(g_instanceMutex);
   if (s_instance==0)
   {
     s_instance = new EmojiEntityMapper;
@@ -1545,6 +1549,7 @@ EmojiEntityMapper *EmojiEntityMapper::instance()
 /** Deletes the one and only instance of the Emoji entity mapper */
 void EmojiEntityMapper::deleteInstance()
 {
+  std::lock_guard<std::mutex> lock(g_instanceMutex);
   delete s_instance;
   s_instance=0;
 }
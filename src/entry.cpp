@@ -16,6 +16,8 @@
  */
 
 #include <algorithm>
+#include <cstddef>
+#include <new>
 #include <stdlib.h>
 #include <qfile.h>
 #include "entry.h"
@@ -27,8 +29,116 @@
 
 //------------------------------------------------------------------
 
+// blocks start small, so files with few entries need little memory, and
+// double in size up to a maximum as more entries are allocated
+static const size_t g_arenaMinBlockSize = 8*1024;
+static const size_t g_arenaMaxBlockSize = 256*1024;
+static const size_t g_arenaAlignment = alignof(std::max_align_t);
+
+static THREAD_LOCAL std::shared_ptr<EntryArena> g_activeArena;
+
+EntryArena::~EntryArena()
+{
+  for (char *block : m_blocks)
+  {
+    free(block);
+  }
+}
+
+void *EntryArena::allocate(size_t size)
+{
+  size = (size+g_arenaAlignment-1) & ~(g_arenaAlignment-1);
+  if (size>g_arenaMaxBlockSize/4) // large request, give it a block of its own
+  {
+    char *block = static_cast<char*>(malloc(size));
+    if (block==0) throw std::bad_alloc();
+    m_blocks.push_back(block);
+    return block;
+  }
+  if (size>m_left)
+  {
+    size_t blockSize = m_blockSize==0 ? g_arenaMinBlockSize :
+                       std::min(m_blockSize*2,g_arenaMaxBlockSize);
+    while (blockSize<size) blockSize*=2;
+    char *block = static_cast<char*>(malloc(blockSize));
+    if (block==0) throw std::bad_alloc();
+    m_blocks.push_back(block);
+    m_ptr       = block;
+    m_left      = blockSize;
+    m_blockSize = blockSize;
+  }
+  void *result = m_ptr;
+  m_ptr  += size;
+  m_left -= size;
+  return result;
+}
+
+std::shared_ptr<EntryArena> EntryArena::active()
+{
+  return g_activeArena;
+}
+
+EntryArena::Scope::Scope() : m_prev(g_activeArena)
+{
+  g_activeArena = std::make_shared<EntryArena>();
+}
+
+EntryArena::Scope::~Scope()
+{
+  g_activeArena = m_prev;
+}
+
+/** Allocator handing out memory from an EntryArena. Every copy keeps the arena alive. */
+template<class T>
+class EntryArenaAllocator
+{
+  public:
+    using value_type = T;
+    explicit EntryArenaAllocator(std::shared_ptr<EntryArena> arena) : m_arena(std::move(arena)) {}
+    template<class U>
+    EntryArenaAllocator(const EntryArenaAllocator<U> &other) : m_arena(other.arena()) {}
+
+    T *allocate(size_t n)         { return static_cast<T*>(m_arena->allocate(n*sizeof(T))); }
+    void deallocate(T *,size_t)   {} // memory is released together with the arena
+
+    const std::shared_ptr<EntryArena> &arena() const { return m_arena; }
+
+    template<class U>
+    bool operator==(const EntryArenaAllocator<U> &other) const { return m_arena==other.arena(); }
+    template<class U>
+    bool operator!=(const EntryArenaAllocator<U> &other) const { return m_arena!=other.arena(); }
+
+  private:
+    std::shared_ptr<EntryArena> m_arena;
+};
+
+std::shared_ptr<Entry> Entry::create()
+{
+  if (g_activeArena)
+  {
+    return std::allocate_shared<Entry>(EntryArenaAllocator<Entry>(g_activeArena));
+  }
+  return std::make_shared<Entry>();
+}
+
+std::shared_ptr<Entry> Entry::create(const Entry &e)
+{
+  if (g_activeArena)
+  {
+    return std::allocate_shared<Entry>(EntryArenaAllocator<Entry>(g_activeArena),e);
+  }
+  return std::make_shared<Entry>(e);
+}
+
+//------------------------------------------------------------------
+
 static AtomicInt g_num;
 
+int Entry::count()
+{
+  return g_num;
+}
+
 Entry::Entry()
 {
   //printf("Entry::Entry(%p)\n",this);
@@ -114,7 +224,7 @@ Entry::Entry(const Entry &e)
   m_sublist.reserve(e.m_sublist.size());
   for (const auto &cur : e.m_sublist)
   {
-    m_sublist.push_back(std::make_shared<Entry>(*cur));
+    m_sublist.push_back(Entry::create(*cur));
   }
 }
 
@@ -138,7 +248,7 @@ void Entry::moveToSubEntryAndRefresh(std::shared_ptr<Entry> &current)
 {
   current->m_parent=this;
   m_sublist.push_back(current);
-  current = std::make_shared<Entry>();
+  current = Entry::create();
 }
 
 void Entry::moveToSubEntryAndKeep(Entry *current)
@@ -155,14 +265,14 @@ void Entry::moveToSubEntryAndKeep(std::shared_ptr<Entry> current)
 
 void Entry::copyToSubEntry(Entry *current)
 {
-  Entry *copy = new Entry(*current);
+  std::shared_ptr<Entry> copy = Entry::create(*current);
   copy->m_parent=this;
-  m_sublist.emplace_back(copy);
+  m_sublist.push_back(copy);
 }
 
 void Entry::copyToSubEntry(const std::shared_ptr<Entry> &current)
 {
-  std::shared_ptr<Entry> copy = std::make_shared<Entry>(*current);
+  std::shared_ptr<Entry> copy = Entry::create(*current);
   copy->m_parent=this;
   m_sublist.push_back(copy);
 }
@@ -177,6 +287,13 @@ void Entry::removeSubEntry(const Entry *e)
   }
 }
 
+void Entry::removeSubEntries(const std::function<bool(Entry *)> &remove)
+{
+  m_sublist.erase(std::remove_if(m_sublist.begin(),m_sublist.end(),
+      [&remove](const std::shared_ptr<Entry> &elem) { return remove(elem.get()); }),
+      m_sublist.end());
+}
+
 
 void Entry::reset()
 {
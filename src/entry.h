@@ -22,6 +22,7 @@
 
 #include <vector>
 #include <memory>
+#include <functional>
 
 #include "types.h"
 #include "arguments.h"
@@ -194,6 +195,16 @@ class Entry
     Entry(const Entry &);
    ~Entry();
 
+    /*! Creates a new entry. If an EntryArena is active for the calling
+     *  thread the entry is allocated from it.
+     */
+    static std::shared_ptr<Entry> create();
+    /*! Creates a (deep) copy of \a e, allocated like create() */
+    static std::shared_ptr<Entry> create(const Entry &e);
+
+    /*! Returns the number of entries that currently exist */
+    static int count();
+
     /*! Returns the parent for this Entry or 0 if this entry has no parent. */
     Entry *parent() const { return m_parent; }
 
@@ -223,6 +234,9 @@ class Entry
      */
     void removeSubEntry(const Entry *e);
 
+    /*! Removes (and deletes) all children for which \a remove returns TRUE. */
+    void removeSubEntries(const std::function<bool(Entry *)> &remove);
+
     /*! Restore the state of this Entry to the default value it has
      *  at construction time.
      */
@@ -332,4 +346,42 @@ class Entry
 
 typedef std::vector< std::shared_ptr<Entry> > EntryList;
 
+/** Memory pool from which the Entry objects for an input file are allocated.
+ *
+ *  Memory is handed out in blocks that grow as more entries are allocated and
+ *  is never released for an individual entry. The arena (and all its blocks)
+ *  is freed in one go when the last entry allocated from it is destroyed, so
+ *  it is safe for entries to outlive the Scope that activated the arena.
+ */
+class EntryArena
+{
+  public:
+    EntryArena() = default;
+   ~EntryArena();
+    EntryArena(const EntryArena &) = delete;
+    EntryArena &operator=(const EntryArena &) = delete;
+
+    /** Returns memory for \a size bytes, aligned for any type */
+    void *allocate(size_t size);
+
+    /** Returns the arena that is active for the calling thread or nullptr if there is none */
+    static std::shared_ptr<EntryArena> active();
+
+    /** Activates a new arena for the calling thread for the lifetime of this object */
+    class Scope
+    {
+      public:
+        Scope();
+       ~Scope();
+      private:
+        std::shared_ptr<EntryArena> m_prev;
+    };
+
+  private:
+    std::vector<char *> m_blocks;
+    char *m_ptr  = 0;
+    size_t m_left = 0;
+    size_t m_blockSize = 0; // size of the block m_ptr points into
+};
+
 #endif
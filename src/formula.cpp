@@ -20,6 +20,9 @@
 #include "util.h"
 #include "portable.h"
 #include "image.h"
+#include "md5.h"
+#include "threadpool.h"
+#include "binarystream.h"
 
 #include <qfile.h>
 #include <qtextstream.h>
@@ -28,6 +31,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <thread>
 #include <utility>
 
 // TODO: remove these dependencies
@@ -40,6 +44,9 @@ static int determineInkscapeVersion(QDir &thisDir);
 #define RM_TMP_FILES (true)
 //#define RM_TMP_FILES (false)
 
+// Increase when the way formulas are rendered changes, to invalidate existing caches.
+static const int g_formulaCacheVersion = 1;
+
 struct FormulaManager::Private
 {
   void storeDisplaySize(int id,int w,int h)
@@ -55,9 +62,78 @@ struct FormulaManager::Private
     }
     return DisplaySize(-1,-1);
   }
+  /** Returns the cache key for formula \a text rendered with settings \a keyPrefix */
+  QCString computeKey(const QCString &keyPrefix,const std::string &text) const
+  {
+    QCString keyText = keyPrefix+"\n"+text.c_str();
+    uchar md5_sig[16];
+    char sigStr[33];
+    MD5Buffer((const unsigned char *)keyText.data(),keyText.length(),md5_sig);
+    MD5SigToString(md5_sig,sigStr,33);
+    return sigStr;
+  }
+  /** Puts the image for \a key at \a fileName if it was generated before,
+   *  either during this run for another output format or in an earlier run
+   *  that used the same FORMULA_CACHE_DIR.
+   */
+  bool restoreImage(const QCString &key,const QCString &fileName,int &w,int &h)
+  {
+    auto it = renderedImages.find(key.str());
+    if (it!=renderedImages.end() && linkOrCopy(it->second.fileName,fileName))
+    {
+      w = it->second.width;
+      h = it->second.height;
+      return true;
+    }
+    if (cacheDir.isEmpty()) return false;
+    QCString cacheBase = cacheDir+"/"+key;
+    FILE *f = Portable::fopen(cacheBase+".size","r");
+    if (f==0) return false;
+    bool ok = fscanf(f,"%d %d",&w,&h)==2;
+    fclose(f);
+    QCString cacheFile = cacheBase+"."+QFileInfo(fileName).extension(FALSE).utf8();
+    if (!ok || !QFileInfo(cacheFile).exists() || !linkOrCopy(cacheFile,fileName)) return false;
+    renderedImages.insert(std::make_pair(key.str(),RenderedImage(QFileInfo(fileName).absFilePath().utf8(),w,h)));
+    return true;
+  }
+  /** Records the image \a fileName generated for \a key, so it can be reused */
+  void storeImage(const QCString &key,const QCString &fileName,int w,int h)
+  {
+    QCString absName = QFileInfo(fileName).absFilePath().utf8();
+    renderedImages.insert(std::make_pair(key.str(),RenderedImage(absName,w,h)));
+    if (cacheDir.isEmpty()) return;
+    // restoreImage() only looks for the image once the size file exists, so the
+    // image is put in place first; both files are written under a temporary name
+    // and then renamed, so a partially written file is never picked up
+    QCString cacheBase = cacheDir+"/"+key;
+    std::string image;
+    if (!readFileToString(absName,image) ||
+        !writeFileAtomically(cacheBase+"."+QFileInfo(fileName).extension(FALSE).utf8(),image))
+    {
+      return;
+    }
+    QCString size;
+    size.sprintf("%d %d\n",w,h);
+    writeFileAtomically(cacheBase+".size",size.str());
+  }
+  static bool linkOrCopy(const QCString &src,const QCString &dst)
+  {
+    // images of formulas are never modified after they have been written
+    return Portable::hardLink(src,dst) || copyFile(src,dst);
+  }
+
+  struct RenderedImage
+  {
+    RenderedImage(const QCString &f,int w,int h) : fileName(f), width(w), height(h) {}
+    QCString fileName;
+    int width;
+    int height;
+  };
   StringVector  formulas;
   IntMap formulaMap;
   std::map<int,DisplaySize> displaySizeMap;
+  QCString cacheDir;
+  std::map<std::string,RenderedImage> renderedImages;
 };
 
 FormulaManager::FormulaManager() : p(new Private)
@@ -142,32 +218,220 @@ void FormulaManager::readFormulas(const char *dir,bool doCompare)
   }
 }
 
-void FormulaManager::generateImages(const char *path,Format format,HighDPI hd) const
+/** Settings shared by all formulas that are rendered for one output directory */
+struct FormulaRenderSettings
 {
-  QDir d(path);
-  // store the original directory
-  if (!d.exists())
+  FormulaManager::Format format;
+  FormulaManager::HighDPI hd;
+  QCString macroFile;     // name of the copy of the macro file, or empty
+  bool usePdf2Svg;
+  int inkscapeVersion;
+};
+
+/** Result of rendering a single formula */
+struct FormulaRenderResult
+{
+  int id;
+  int width;
+  int height;
+};
+
+// Converts page \a pageIndex of the dvi file \a dviName into image form_<id>.{png,svg}.
+// The size to display the image with is returned in \a width and \a height.
+static bool convertFormulaPage(const FormulaRenderSettings &rs,const QCString &dviName,
+                               int pageIndex,int id,int &width,int &height)
+{
+  QDir thisDir;
+  bool vector = rs.format==FormulaManager::Format::Vector;
+  msg("Generating image form_%d.%s for formula\n",id,vector ? "svg" : "png");
+  QCString formBase;
+  formBase.sprintf("_form%d",id);
+  char args[4096];
+  // run dvips to convert the page with number pageIndex to an
+  // postscript file.
+  sprintf(args,"-q -D 600 -n 1 -p %d -o %s_tmp.ps %s",
+      pageIndex,formBase.data(),dviName.data());
+  if (Portable::system("dvips",args)!=0)
   {
-    term("Output directory '%s' does not exist!\n",path);
+    err("Problems running dvips. Check your installation!\n");
+    return false;
   }
-  QCString oldDir = QDir::currentDirPath().utf8();
-  QCString macroFile = Config_getString(FORMULA_MACROFILE);
-  QCString stripMacroFile;
-  if (!macroFile.isEmpty())
+
+  // extract the bounding box for the postscript file
+  sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=bbox %s_tmp.ps 2>%s_tmp.epsi",
+      formBase.data(),formBase.data());
+  if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
   {
-    QFileInfo fi(macroFile);
-    macroFile=fi.absFilePath().utf8();
-    stripMacroFile = fi.fileName().data();
+    err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
+    return false;
   }
 
-  // go to the html output directory (i.e. path)
-  QDir::setCurrent(d.absPath());
+  // extract the bounding box info from the generate .epsi file
+  int x1=0,y1=0,x2=0,y2=0;
+  QFileInfo fi(formBase+"_tmp.epsi");
+  if (fi.exists())
+  {
+    QString eps = fileToString(formBase+"_tmp.epsi");
+    int i = eps.find("%%BoundingBox:");
+    if (i!=-1)
+    {
+      sscanf(eps.data()+i,"%%%%BoundingBox:%d %d %d %d",&x1,&y1,&x2,&y2);
+    }
+    else
+    {
+      err("Couldn't extract bounding box from %s_tmp.epsi",formBase.data());
+    }
+  }
+  //printf("Bounding box [%d %d %d %d]\n",x1,y1,x2,y2);
+
+  // convert the corrected EPS to a bitmap
+  double scaleFactor = 1.25;
+  int zoomFactor = Config_getInt(FORMULA_FONTSIZE);
+  if (zoomFactor<8 || zoomFactor>50) zoomFactor=10;
+  scaleFactor *= zoomFactor/10.0;
+
+  width  = (int)((x2-x1)*scaleFactor+0.5);
+  height = (int)((y2-y1)*scaleFactor+0.5);
+
+  if (vector)
+  {
+    // crop the image to its bounding box
+    sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=pdfwrite"
+                 " -o %s_tmp.pdf -c \"[/CropBox [%d %d %d %d] /PAGES pdfmark\" -f %s_tmp.ps",
+                 formBase.data(),x1,y1,x2,y2,formBase.data());
+    if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
+    {
+      err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
+      return false;
+    }
+
+    // if we have pdf2svg available use it to create a SVG image
+    if (rs.usePdf2Svg)
+    {
+      sprintf(args,"%s_tmp.pdf form_%d.svg",formBase.data(),id);
+      if (Portable::system("pdf2svg",args)!=0)
+      {
+        err("Problems running pdf2svg. Check your installation!\n");
+        return false;
+      }
+    }
+    else // alternative is to use inkscape
+    {
+      if (rs.inkscapeVersion == 0)
+      {
+        sprintf(args,"-l form_%d.svg -z %s_tmp.pdf 2>%s",id,formBase.data(),Portable::devNull());
+      }
+      else // inkscapeVersion >= 1
+      {
+        sprintf(args,"--export-type=svg --export-filename=form_%d.svg %s_tmp.pdf 2>%s",id,formBase.data(),Portable::devNull());
+      }
+      if (Portable::system("inkscape",args)!=0)
+      {
+        err("Problems running inkscape. Check your installation!\n");
+        return false;
+      }
+    }
+
+    if (RM_TMP_FILES)
+    {
+      thisDir.remove(formBase+"_tmp.pdf");
+    }
+  }
+  else // format==Format::Bitmap
+  {
+    // crop the image to its bounding box
+    sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=eps2write"
+                 " -o %s_tmp.eps -f %s_tmp.ps",formBase.data(),formBase.data());
+    if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
+    {
+      err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
+      return false;
+    }
+
+    // read back %s_tmp.eps and replace
+    // bounding box values with x1,y1,x2,y2 and remove the HiResBoundingBox
+    QFile epsIn(formBase+"_tmp.eps");
+    QFile epsOut(formBase+"_tmp_corr.eps");
+    if (epsIn.open(IO_ReadOnly) && epsOut.open(IO_WriteOnly))
+    {
+      int maxLineLen=100*1024;
+      while (!epsIn.atEnd())
+      {
+        QCString buf(maxLineLen);
+        FTextStream t(&epsOut);
+        int numBytes = epsIn.readLine(buf.rawData(),maxLineLen);
+        if (numBytes>0)
+        {
+          buf.resize(numBytes+1);
+          if (buf.startsWith("%%BoundingBox"))
+          {
+            t << "%%BoundingBox: " << x1 << " " << y1 << " " << x2 << " " << y2 << endl;
+          }
+          else if (buf.startsWith("%%HiResBoundingBox")) // skip this one
+          {
+          }
+          else
+          {
+            t << buf;
+          }
+        }
+      }
+      epsIn.close();
+      epsOut.close();
+    }
+    else
+    {
+      err("Problems correcting the eps files from %s_tmp.eps to %s_tmp_corr.eps\n",
+          formBase.data(),formBase.data());
+      return false;
+    }
+
+    if (rs.hd==FormulaManager::HighDPI::On) // for high DPI display it looks much better if the
+                                            // image resolution is higher than the display resolution
+    {
+      scaleFactor*=2;
+    }
+
+    sprintf(args,"-q -dNOSAFER -dBATCH -dNOPAUSE -dEPSCrop -sDEVICE=pnggray -dGraphicsAlphaBits=4 -dTextAlphaBits=4 "
+        "-r%d -sOutputFile=form_%d.png %s_tmp_corr.eps",(int)(scaleFactor*72),id,formBase.data());
+    if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
+    {
+      err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
+      return false;
+    }
+
+    if (RM_TMP_FILES)
+    {
+      thisDir.remove(formBase+"_tmp.eps");
+      thisDir.remove(formBase+"_tmp_corr.eps");
+    }
+  }
+
+  // remove intermediate image files
+  if (RM_TMP_FILES)
+  {
+    thisDir.remove(formBase+"_tmp.ps");
+    thisDir.remove(formBase+"_tmp.epsi");
+  }
+  return true;
+}
+
+// Renders the formulas \a ids, with texts \a texts, using one latex run with one
+// formula per page. The files of batch \a batchNr are named _formulas_<batchNr>.*
+static std::vector<FormulaRenderResult> renderFormulaBatch(const FormulaRenderSettings &rs,int batchNr,
+                                                           const std::vector<int> &ids,
+                                                           const StringVector &texts)
+{
+  std::vector<FormulaRenderResult> results;
   QDir thisDir;
-  // generate a latex file containing one formula per page.
-  QCString texName="_formulas.tex";
-  IntVector formulasToGenerate;
-  QFile f(texName);
-  if (f.open(IO_WriteOnly))
+  QCString baseName;
+  baseName.sprintf("_formulas_%d",batchNr);
+  QFile f(baseName+".tex");
+  if (!f.open(IO_WriteOnly))
+  {
+    err("Could not open file %s for writing\n",f.name().data());
+    return results;
+  }
   {
     FTextStream t(&f);
     if (Config_getBool(LATEX_BATCHMODE)) t << "\\batchmode" << endl;
@@ -177,280 +441,205 @@ void FormulaManager::generateImages(const char *path,Format format,HighDPI hd) c
     t << "\\usepackage[utf8]{inputenc}" << endl; // looks like some older distributions with newunicode package 1.1 need this option.
     writeExtraLatexPackages(t);
     writeLatexSpecialFormulaChars(t);
-    if (!macroFile.isEmpty())
+    if (!rs.macroFile.isEmpty())
     {
-      copyFile(macroFile,stripMacroFile);
-      t << "\\input{" << stripMacroFile << "}" << endl;
+      t << "\\input{" << rs.macroFile << "}" << endl;
     }
     t << "\\pagestyle{empty}" << endl;
     t << "\\begin{document}" << endl;
-    for (int i=0; i<(int)p->formulas.size(); i++)
+    for (const auto &text : texts)
     {
-      QCString resultName;
-      resultName.sprintf("form_%d.%s",i,format==Format::Vector?"svg":"png");
-      // only formulas for which no image exists are generated
-      QFileInfo fi(resultName);
-      if (!fi.exists())
-      {
-        // we force a pagebreak after each formula
-        t << p->formulas[i].c_str() << endl << "\\pagebreak\n\n";
-        formulasToGenerate.push_back(i);
-      }
-      Doxygen::indexList->addImageFile(resultName);
+      // we force a pagebreak after each formula
+      t << text.c_str() << endl << "\\pagebreak\n\n";
     }
     t << "\\end{document}" << endl;
-    f.close();
   }
-  if (!formulasToGenerate.empty()) // there are new formulas
+  f.close();
+
+  QCString args = "-interaction=batchmode "+baseName+".tex >"+Portable::devNull();
+  if (Portable::system("latex",args)!=0)
   {
-    //printf("Running latex...\n");
-    //system("latex _formulas.tex </dev/null >/dev/null");
-    QCString latexCmd = "latex";
-    Portable::sysTimerStart();
-    char args[4096];
-    sprintf(args,"-interaction=batchmode _formulas.tex >%s",Portable::devNull());
-    if (Portable::system(latexCmd,args)!=0)
+    err("Problems running latex. Check your installation or look "
+        "for typos in %s.tex and check %s.log!\n",baseName.data(),baseName.data());
+    return results;
+  }
+  int pageIndex=1;
+  for (int id : ids)
+  {
+    int width=-1,height=-1;
+    if (!convertFormulaPage(rs,baseName+".dvi",pageIndex,id,width,height)) break;
+    results.push_back({id,width,height});
+    pageIndex++;
+  }
+  // remove intermediate files produced by latex
+  if (RM_TMP_FILES)
+  {
+    thisDir.remove(baseName+".dvi");
+    thisDir.remove(baseName+".log"); // keep file in case of errors
+    thisDir.remove(baseName+".aux");
+    thisDir.remove(baseName+".tex");
+  }
+  return results;
+}
+
+void FormulaManager::generateImages(const char *path,Format format,HighDPI hd) const
+{
+  QDir d(path);
+  // store the original directory
+  if (!d.exists())
+  {
+    term("Output directory '%s' does not exist!\n",path);
+  }
+  QCString oldDir = QDir::currentDirPath().utf8();
+  QCString macroFile = Config_getString(FORMULA_MACROFILE);
+  QCString stripMacroFile;
+  if (!macroFile.isEmpty())
+  {
+    QFileInfo fi(macroFile);
+    macroFile=fi.absFilePath().utf8();
+    stripMacroFile = fi.fileName().data();
+  }
+
+  p->cacheDir = Config_getString(FORMULA_CACHE_DIR);
+  if (!p->cacheDir.isEmpty())
+  {
+    QDir cacheDir(p->cacheDir);
+    if (!cacheDir.exists() && !cacheDir.mkdir(p->cacheDir,TRUE))
     {
-      err("Problems running latex. Check your installation or look "
-          "for typos in _formulas.tex and check _formulas.log!\n");
-      Portable::sysTimerStop();
-      QDir::setCurrent(oldDir);
-      return;
+      err("Could not create formula cache directory %s, the formula cache is disabled\n",p->cacheDir.data());
+      p->cacheDir.resize(0);
     }
-    Portable::sysTimerStop();
-    //printf("Running dvips...\n");
-    int pageIndex=1;
-    for (int pageNum : formulasToGenerate)
-    {
-      msg("Generating image form_%d.%s for formula\n",pageNum,(format==Format::Vector) ? "svg" : "png");
-      QCString formBase;
-      formBase.sprintf("_form%d",pageNum);
-      // run dvips to convert the page with number pageIndex to an
-      // postscript file.
-      sprintf(args,"-q -D 600 -n 1 -p %d -o %s_tmp.ps _formulas.dvi",
-          pageIndex,formBase.data());
-      Portable::sysTimerStart();
-      if (Portable::system("dvips",args)!=0)
+    else
+    {
+      p->cacheDir = QFileInfo(p->cacheDir).absFilePath().utf8();
+    }
+  }
+
+  // go to the html output directory (i.e. path)
+  QDir::setCurrent(d.absPath());
+  QDir thisDir;
+
+  // the cache key of a formula covers everything that influences its image
+  QCString keyPrefix;
+  keyPrefix.sprintf("%d\n%s\n%s\n%d\n",g_formulaCacheVersion,
+      format==Format::Vector ? "svg" : "png",hd==HighDPI::On ? "hd" : "",
+      Config_getInt(FORMULA_FONTSIZE));
+  for (const auto &pkg : Config_getList(EXTRA_PACKAGES))
+  {
+    keyPrefix+=pkg.c_str();
+    keyPrefix+='\n';
+  }
+  if (!macroFile.isEmpty())
+  {
+    keyPrefix+=fileToString(macroFile);
+  }
+
+  // images that exist already or that can be taken from the cache are not generated
+  std::vector<int> formulasToGenerate;
+  StringVector keys(p->formulas.size());
+  for (int i=0; i<(int)p->formulas.size(); i++)
+  {
+    QCString resultName;
+    resultName.sprintf("form_%d.%s",i,format==Format::Vector?"svg":"png");
+    QFileInfo fi(resultName);
+    if (!fi.exists())
+    {
+      keys[i] = p->computeKey(keyPrefix,p->formulas[i]);
+      int w=-1,h=-1;
+      if (p->restoreImage(keys[i],resultName,w,h))
       {
-        err("Problems running dvips. Check your installation!\n");
-        Portable::sysTimerStop();
-        QDir::setCurrent(oldDir);
-        return;
+        p->storeDisplaySize(i,w,h);
       }
-      Portable::sysTimerStop();
-
-      // extract the bounding box for the postscript file
-      sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=bbox %s_tmp.ps 2>%s_tmp.epsi",
-          formBase.data(),formBase.data());
-      Portable::sysTimerStart();
-      if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
+      else
       {
-        err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
-        Portable::sysTimerStop();
-        QDir::setCurrent(oldDir);
-        return;
+        formulasToGenerate.push_back(i);
       }
-      Portable::sysTimerStop();
+    }
+    Doxygen::indexList->addImageFile(resultName);
+  }
 
-      // extract the bounding box info from the generate .epsi file
-      int x1=0,y1=0,x2=0,y2=0;
-      QFileInfo fi(formBase+"_tmp.epsi");
-      if (fi.exists())
+  FormulaRenderSettings rs;
+  rs.format          = format;
+  rs.hd              = hd;
+  rs.usePdf2Svg      = false;
+  rs.inkscapeVersion = -1;
+  bool toolsFound    = true;
+  if (!formulasToGenerate.empty() && format==Format::Vector)
+  {
+    if (Portable::checkForExecutable("pdf2svg"))
+    {
+      rs.usePdf2Svg = true;
+    }
+    else if (Portable::checkForExecutable("inkscape")) // alternative is to use inkscape
+    {
+      rs.inkscapeVersion = determineInkscapeVersion(thisDir);
+      if (rs.inkscapeVersion == -1)
       {
-        QString eps = fileToString(formBase+"_tmp.epsi");
-        int i = eps.find("%%BoundingBox:");
-        if (i!=-1)
-        {
-          sscanf(eps.data()+i,"%%%%BoundingBox:%d %d %d %d",&x1,&y1,&x2,&y2);
-        }
-        else
-        {
-          err("Couldn't extract bounding box from %s_tmp.epsi",formBase.data());
-        }
+        err("Problems determining the version of inkscape. Check your installation!\n");
+        toolsFound = false;
       }
-      //printf("Bounding box [%d %d %d %d]\n",x1,y1,x2,y2);
+    }
+    else
+    {
+      err("Neither 'pdf2svg' nor 'inkscape' present for conversion of formula to 'svg'\n");
+      toolsFound = false;
+    }
+  }
 
-      // convert the corrected EPS to a bitmap
-      double scaleFactor = 1.25;
-      int zoomFactor = Config_getInt(FORMULA_FONTSIZE);
-      if (zoomFactor<8 || zoomFactor>50) zoomFactor=10;
-      scaleFactor *= zoomFactor/10.0;
+  if (!formulasToGenerate.empty() && toolsFound) // there are new formulas
+  {
+    if (!macroFile.isEmpty())
+    {
+      copyFile(macroFile,stripMacroFile);
+      rs.macroFile = stripMacroFile;
+    }
 
-      int width  = (int)((x2-x1)*scaleFactor+0.5);
-      int height = (int)((y2-y1)*scaleFactor+0.5);
-      p->storeDisplaySize(pageNum,width,height);
+    // split the formulas in one batch per thread, each processed by its own latex run
+    std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+    if (numThreads==0)
+    {
+      numThreads = std::thread::hardware_concurrency();
+    }
+    std::size_t numBatches = QMAX(QMIN(numThreads,formulasToGenerate.size()),static_cast<size_t>(1));
+    std::size_t batchSize  = (formulasToGenerate.size()+numBatches-1)/numBatches;
 
-      if (format==Format::Vector)
+    Portable::sysTimerStart();
+    std::vector< std::future< std::vector<FormulaRenderResult> > > results;
+    {
+      WorkStealingThreadPool threadPool(numBatches);
+      for (std::size_t b=0; b<numBatches; b++)
       {
-        // crop the image to its bounding box
-        sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=pdfwrite"
-                     " -o %s_tmp.pdf -c \"[/CropBox [%d %d %d %d] /PAGES pdfmark\" -f %s_tmp.ps",
-                     formBase.data(),x1,y1,x2,y2,formBase.data());
-        Portable::sysTimerStart();
-        if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
-        {
-          err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
-          Portable::sysTimerStop();
-          QDir::setCurrent(oldDir);
-          return;
-        }
-        Portable::sysTimerStop();
-
-        // if we have pdf2svg available use it to create a SVG image
-        if (Portable::checkForExecutable("pdf2svg"))
-        {
-          sprintf(args,"%s_tmp.pdf form_%d.svg",formBase.data(),pageNum);
-          Portable::sysTimerStart();
-          if (Portable::system("pdf2svg",args)!=0)
-          {
-            err("Problems running pdf2svg. Check your installation!\n");
-            Portable::sysTimerStop();
-            QDir::setCurrent(oldDir);
-            return;
-          }
-          Portable::sysTimerStop();
-        }
-        else if (Portable::checkForExecutable("inkscape")) // alternative is to use inkscape
-        {
-          int inkscapeVersion = determineInkscapeVersion(thisDir);
-          if (inkscapeVersion == -1)
-          {
-            err("Problems determining the version of inkscape. Check your installation!\n");
-            QDir::setCurrent(oldDir);
-            return;
-          }
-          else if (inkscapeVersion == 0)
-          {
-            sprintf(args,"-l form_%d.svg -z %s_tmp.pdf 2>%s",pageNum,formBase.data(),Portable::devNull());
-          }
-          else // inkscapeVersion >= 1
-          {
-            sprintf(args,"--export-type=svg --export-filename=form_%d.svg %s_tmp.pdf 2>%s",pageNum,formBase.data(),Portable::devNull());
-          }
-          Portable::sysTimerStart();
-          if (Portable::system("inkscape",args)!=0)
-          {
-            err("Problems running inkscape. Check your installation!\n");
-            Portable::sysTimerStop();
-            QDir::setCurrent(oldDir);
-            return;
-          }
-          Portable::sysTimerStop();
-        }
-        else
+        std::vector<int> ids;
+        StringVector texts;
+        for (std::size_t j=b*batchSize; j<formulasToGenerate.size() && j<(b+1)*batchSize; j++)
         {
-          err("Neither 'pdf2svg' nor 'inkscape' present for conversion of formula to 'svg'\n");
-          return;
-        }
-
-        if (RM_TMP_FILES)
-        {
-          thisDir.remove(formBase+"_tmp.pdf");
+          ids.push_back(formulasToGenerate[j]);
+          texts.push_back(p->formulas[formulasToGenerate[j]]);
         }
+        if (ids.empty()) break;
+        int batchNr = static_cast<int>(b);
+        results.emplace_back(threadPool.queue([&rs,batchNr,ids,texts]()
+              { return renderFormulaBatch(rs,batchNr,ids,texts); }));
       }
-      else // format==Format::Bitmap
+      for (auto &f : results)
       {
-        // crop the image to its bounding box
-        sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=eps2write"
-                     " -o %s_tmp.eps -f %s_tmp.ps",formBase.data(),formBase.data());
-        Portable::sysTimerStart();
-        if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
-        {
-          err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
-          Portable::sysTimerStop();
-          QDir::setCurrent(oldDir);
-          return;
-        }
-
-        // read back %s_tmp.eps and replace
-        // bounding box values with x1,y1,x2,y2 and remove the HiResBoundingBox
-        QFile epsIn(formBase+"_tmp.eps");
-        QFile epsOut(formBase+"_tmp_corr.eps");
-        if (epsIn.open(IO_ReadOnly) && epsOut.open(IO_WriteOnly))
-        {
-          int maxLineLen=100*1024;
-          while (!epsIn.atEnd())
-          {
-            QCString buf(maxLineLen);
-            FTextStream t(&epsOut);
-            int numBytes = epsIn.readLine(buf.rawData(),maxLineLen);
-            if (numBytes>0)
-            {
-              buf.resize(numBytes+1);
-              if (buf.startsWith("%%BoundingBox"))
-              {
-                t << "%%BoundingBox: " << x1 << " " << y1 << " " << x2 << " " << y2 << endl;
-              }
-              else if (buf.startsWith("%%HiResBoundingBox")) // skip this one
-              {
-              }
-              else
-              {
-                t << buf;
-              }
-            }
-          }
-          epsIn.close();
-          epsOut.close();
-        }
-        else
+        for (const auto &r : f.get())
         {
-          err("Problems correcting the eps files from %s_tmp.eps to %s_tmp_corr.eps\n",
-              formBase.data(),formBase.data());
-          QDir::setCurrent(oldDir);
-          return;
-        }
-
-        if (hd==HighDPI::On) // for high DPI display it looks much better if the
-                             // image resolution is higher than the display resolution
-        {
-          scaleFactor*=2;
-        }
-
-        Portable::sysTimerStop();
-        sprintf(args,"-q -dNOSAFER -dBATCH -dNOPAUSE -dEPSCrop -sDEVICE=pnggray -dGraphicsAlphaBits=4 -dTextAlphaBits=4 "
-            "-r%d -sOutputFile=form_%d.png %s_tmp_corr.eps",(int)(scaleFactor*72),pageNum,formBase.data());
-        Portable::sysTimerStart();
-        if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
-        {
-          err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
-          Portable::sysTimerStop();
-          QDir::setCurrent(oldDir);
-          return;
-        }
-        Portable::sysTimerStop();
-
-        if (RM_TMP_FILES)
-        {
-          thisDir.remove(formBase+"_tmp.eps");
-          thisDir.remove(formBase+"_tmp_corr.eps");
+          p->storeDisplaySize(r.id,r.width,r.height);
+          QCString resultName;
+          resultName.sprintf("form_%d.%s",r.id,format==Format::Vector?"svg":"png");
+          p->storeImage(keys[r.id],resultName,r.width,r.height);
         }
       }
-
-      // remove intermediate image files
-      if (RM_TMP_FILES)
-      {
-        thisDir.remove(formBase+"_tmp.ps");
-        thisDir.remove(formBase+"_tmp.epsi");
-      }
-      pageIndex++;
-    }
-    // remove intermediate files produced by latex
-    if (RM_TMP_FILES)
-    {
-      thisDir.remove("_formulas.dvi");
-      thisDir.remove("_formulas.log"); // keep file in case of errors
-      thisDir.remove("_formulas.aux");
     }
+    Portable::sysTimerStop();
   }
-  // remove the latex file itself
-  if (RM_TMP_FILES) thisDir.remove("_formulas.tex");
 
   // write/update the formula repository so we know what text the
   // generated images represent (we use this next time to avoid regeneration
   // of the images, and to avoid forcing the user to delete all images in order
   // to let a browser refresh the images).
-  f.setName("formula.repository");
+  QFile f("formula.repository");
   if (f.open(IO_WriteOnly))
   {
     FTextStream t(&f);
@@ -170,6 +170,8 @@ FTextStream::FTextStream( FILE *fh )
 
 FTextStream::~FTextStream()
 {
+  flush();
+  delete[] m_buf;
   if (m_owndev) delete m_dev;
   m_dev = 0;
 }
@@ -181,12 +183,14 @@ QIODevice *FTextStream::device() const
 
 void FTextStream::setDevice( QIODevice *dev )
 {
+  flush();
   if (m_owndev) 
   {
     delete m_dev;
     m_owndev = FALSE;
   }
   m_dev = dev;
+  m_bufEnd = m_buf && m_dev ? m_buf+BufferSize : m_buf;
 }
 
 void FTextStream::unsetDevice()
@@ -194,6 +198,54 @@ void FTextStream::unsetDevice()
   setDevice(0);
 }
 
+void FTextStream::setBuffered( bool enable )
+{
+  if (enable && m_buf==0)
+  {
+    m_buf    = new char[BufferSize];
+    m_bufPos = m_buf;
+    m_bufEnd = m_dev ? m_buf+BufferSize : m_buf;
+  }
+  else if (!enable && m_buf)
+  {
+    flush();
+    delete[] m_buf;
+    m_buf = m_bufPos = m_bufEnd = 0;
+  }
+}
+
+void FTextStream::flush()
+{
+  if (m_bufPos!=m_buf)
+  {
+    if (m_dev) m_dev->writeBlock( m_buf, static_cast<uint>(m_bufPos-m_buf) );
+    m_bufPos = m_buf;
+  }
+}
+
+void FTextStream::putSlow( char c )
+{
+  // buffer is full or there is no device
+  flush();
+  if (m_bufPos<m_bufEnd) *m_bufPos++ = c;
+}
+
+void FTextStream::writeSlow( const char *s, uint len )
+{
+  // string does not fit in the remaining part of the buffer
+  flush();
+  if (m_dev==0) return;
+  if (len>=BufferSize)
+  {
+    m_dev->writeBlock( s, len );
+  }
+  else
+  {
+    memcpy(m_bufPos,s,len);
+    m_bufPos+=len;
+  }
+}
+
 FTextStream &FTextStream::output_int( ulong n, bool neg )
 {
   char buf[20];
@@ -2,6 +2,7 @@
 #define FTEXTSTREAM_H
 
 #include <stdio.h>
+#include <string.h>
 
 #include <qiodevice.h>
 #include <qstring.h>
@@ -21,6 +22,16 @@ class FTextStream
     void	 setDevice( QIODevice * );
     void	 unsetDevice();
 
+    /** Enables or disables the write buffer of the stream. When enabled,
+     *  characters and strings are collected in memory and passed to the
+     *  device in large blocks, avoiding a virtual call per character.
+     *  Pending output is written by flush(), setDevice(), unsetDevice() and
+     *  the destructor, so the device should not be accessed directly while
+     *  the stream is in use.
+     */
+    void	 setBuffered( bool );
+    void	 flush();
+
     FTextStream &operator<<( char );
     FTextStream &operator<<( const char *);
     FTextStream &operator<<( const QCString & );
@@ -34,9 +45,16 @@ class FTextStream
     FTextStream &operator<<( double );
 
   private:
+    static const uint BufferSize = 64*1024;
     QIODevice *m_dev;
     bool m_owndev;
+    char *m_buf = 0;      // write buffer, or 0 if the stream is unbuffered
+    char *m_bufPos = 0;   // next free position in m_buf
+    char *m_bufEnd = 0;   // end of m_buf, equal to m_buf if there is no device
     FTextStream &output_int( ulong n, bool neg );
+    void write( const char *s, uint len );
+    void putSlow( char c );
+    void writeSlow( const char *s, uint len );
 
   private:	// Disabled copy constructor and operator=
 #if defined(Q_DISABLE_COPY)
@@ -45,22 +63,49 @@ class FTextStream
 #endif
 };
 
+inline void FTextStream::write( const char *s, uint len )
+{
+  if (m_buf==0)
+  {
+    if (m_dev) m_dev->writeBlock( s, len );
+  }
+  else if (len<=static_cast<uint>(m_bufEnd-m_bufPos))
+  {
+    memcpy(m_bufPos,s,len);
+    m_bufPos+=len;
+  }
+  else
+  {
+    writeSlow( s, len );
+  }
+}
+
 inline FTextStream &FTextStream::operator<<( char c)
 {
-  if (m_dev) m_dev->putch(c);
+  if (m_bufPos<m_bufEnd)
+  {
+    *m_bufPos++ = c;
+  }
+  else if (m_buf==0)
+  {
+    if (m_dev) m_dev->putch(c);
+  }
+  else
+  {
+    putSlow(c);
+  }
   return *this;
 }
 
 inline FTextStream &FTextStream::operator<<( const char* s)
 {
-  uint len = qstrlen( s );
-  if (m_dev) m_dev->writeBlock( s, len );
+  write( s, qstrlen( s ) );
   return *this;
 }
 
 inline FTextStream &FTextStream::operator<<( const QCString &s)
 {
-  if (m_dev) m_dev->writeBlock( s, s.length() );
+  write( s.data(), s.length() );
   return *this;
 }
 
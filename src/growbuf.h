@@ -46,6 +46,12 @@ class GrowBuf
                           m_pos+=l;
                         }
                       }
+    void addStr(const QCStringRef &s) {
+                        uint l=s.length();
+                        if (m_pos+l>=m_len) { m_len+=l+GROW_AMOUNT; m_str = (char*)realloc(m_str,m_len); }
+                        memcpy(&m_str[m_pos],s.data(),l);
+                        m_pos+=l;
+                      }
     const char *get()     { return m_str; }
     uint getPos() const   { return m_pos; }
     void setPos(uint newPos) { m_pos = newPos; }
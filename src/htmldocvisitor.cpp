@@ -549,15 +549,9 @@ void HtmlDocVisitor::visit(DocVerbatim *s)
 
     case DocVerbatim::Dot:
       {
-        static int dotindex = 1;
-        QCString fileName(4096);
-
+        static AtomicInt dotindex(1);
         forceEndParagraph(s);
-        fileName.sprintf("%s%d%s",
-            (Config_getString(HTML_OUTPUT)+"/inline_dotgraph_").data(),
-            dotindex++,
-            ".dot"
-           );
+        QCString fileName = Config_getString(HTML_OUTPUT)+"/"+inlineGraphName("inline_dotgraph_",dotindex)+".dot";
         QFile file(fileName);
         if (!file.open(IO_WriteOnly))
         {
@@ -584,13 +578,8 @@ void HtmlDocVisitor::visit(DocVerbatim *s)
       {
         forceEndParagraph(s);
 
-        static int mscindex = 1;
-        QCString baseName(4096);
-
-        baseName.sprintf("%s%d",
-            (Config_getString(HTML_OUTPUT)+"/inline_mscgraph_").data(),
-            mscindex++
-            );
+        static AtomicInt mscindex(1);
+        QCString baseName = Config_getString(HTML_OUTPUT)+"/"+inlineGraphName("inline_mscgraph_",mscindex);
         QFile file(baseName+".msc");
         if (!file.open(IO_WriteOnly))
         {
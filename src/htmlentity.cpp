@@ -13,6 +13,8 @@
  *
  */
 
+#include <mutex>
+
 #include "htmlentity.h"
 #include "message.h"
 #include "ftextstream.h"
@@ -322,6 +324,7 @@ static struct htmlEntityInfo
 static const int g_numHtmlEntities = (int)(sizeof(g_htmlEntities)/ sizeof(*g_htmlEntities));
 
 HtmlEntityMapper *HtmlEntityMapper::s_instance = 0;
+static std::mutex g_instanceMutex;
 
 HtmlEntityMapper::HtmlEntityMapper()
 {
@@ -340,6 +343,7 @@ HtmlEntityMapper::~HtmlEntityMapper()
 /** Returns the one and only instance of the HTML entity mapper */
 HtmlEntityMapper *HtmlEntityMapper::instance()
 {
+  std::lock_guard<std::mutex> lock(g_instanceMutex);
   if (s_instance==0)
   {
     s_instance = new HtmlEntityMapper;
@@ -350,6 +354,7 @@ HtmlEntityMapper *HtmlEntityMapper::instance()
 /** Deletes the one and only instance of the HTML entity mapper */
 void HtmlEntityMapper::deleteInstance()
 {
+  std::lock_guard<std::mutex> lock(g_instanceMutex);
   delete s_instance;
   s_instance=0;
 }
@@ -524,7 +524,7 @@ HtmlCodeGenerator::HtmlCodeGenerator(FTextStream &t,const QCString &relPath)
 void HtmlCodeGenerator::setTextStream(FTextStream &t)
 {
   m_streamSet = t.device()!=0;
-  m_t.setDevice(t.device());
+  m_t = &t;
 }
 
 void HtmlCodeGenerator::setRelativePath(const QCString &path)
@@ -547,33 +547,33 @@ void HtmlCodeGenerator::codify(const char *str)
       {
         case '\t': spacesToNextTabStop =
                          tabSize - (m_col%tabSize);
-                   m_t << Doxygen::spaces.left(spacesToNextTabStop);
+                   *m_t << Doxygen::spaces.left(spacesToNextTabStop);
                    m_col+=spacesToNextTabStop;
                    break;
-        case '\n': m_t << "\n"; m_col=0;
+        case '\n': *m_t << "\n"; m_col=0;
                    break;
         case '\r': break;
-        case '<':  m_t << "&lt;"; m_col++;
+        case '<':  *m_t << "&lt;"; m_col++;
                    break;
-        case '>':  m_t << "&gt;"; m_col++;
+        case '>':  *m_t << "&gt;"; m_col++;
                    break;
-        case '&':  m_t << "&amp;"; m_col++;
+        case '&':  *m_t << "&amp;"; m_col++;
                    break;
-        case '\'': m_t << "&#39;"; m_col++; // &apos; is not valid XHTML
+        case '\'': *m_t << "&#39;"; m_col++; // &apos; is not valid XHTML
                    break;
-        case '"':  m_t << "&quot;"; m_col++;
+        case '"':  *m_t << "&quot;"; m_col++;
                    break;
         case '\\':
                    if (*p=='<')
-                     { m_t << "&lt;"; p++; }
+                     { *m_t << "&lt;"; p++; }
                    else if (*p=='>')
-                     { m_t << "&gt;"; p++; }
+                     { *m_t << "&gt;"; p++; }
 		   else if (*p=='(')
-                     { m_t << "\\&zwj;("; m_col++;p++; }
+                     { *m_t << "\\&zwj;("; m_col++;p++; }
                    else if (*p==')')
-                     { m_t << "\\&zwj;)"; m_col++;p++; }
+                     { *m_t << "\\&zwj;)"; m_col++;p++; }
                    else
-                     m_t << "\\";
+                     *m_t << "\\";
                    m_col++;
                    break;
         default:
@@ -581,12 +581,12 @@ void HtmlCodeGenerator::codify(const char *str)
             uchar uc = static_cast<uchar>(c);
             if (uc<32)
             {
-              m_t << "&#x24" << hex[uc>>4] << hex[uc&0xF] << ";";
+              *m_t << "&#x24" << hex[uc>>4] << hex[uc&0xF] << ";";
               m_col++;
             }
             else
             {
-              p=writeUtf8Char(m_t,p-1);
+              p=writeUtf8Char(*m_t,p-1);
               m_col++;
             }
           }
@@ -598,7 +598,7 @@ void HtmlCodeGenerator::codify(const char *str)
 
 void HtmlCodeGenerator::docify(const char *str)
 {
-  //m_t << getHtmlDirEmbeddingChar(getTextDirByConfig(str));
+  //*m_t << getHtmlDirEmbeddingChar(getTextDirByConfig(str));
 
   if (str && m_streamSet)
   {
@@ -609,32 +609,32 @@ void HtmlCodeGenerator::docify(const char *str)
       c=*p++;
       switch(c)
       {
-        case '<':  m_t << "&lt;"; break;
-        case '>':  m_t << "&gt;"; break;
-        case '&':  m_t << "&amp;"; break;
-        case '"':  m_t << "&quot;"; break;
+        case '<':  *m_t << "&lt;"; break;
+        case '>':  *m_t << "&gt;"; break;
+        case '&':  *m_t << "&amp;"; break;
+        case '"':  *m_t << "&quot;"; break;
         case '\\':
           if (*p=='<')
-            { m_t << "&lt;"; p++; }
+            { *m_t << "&lt;"; p++; }
           else if (*p=='>')
-            { m_t << "&gt;"; p++; }
+            { *m_t << "&gt;"; p++; }
 	  else if (*p=='(')
-            { m_t << "\\&zwj;("; p++; }
+            { *m_t << "\\&zwj;("; p++; }
           else if (*p==')')
-            { m_t << "\\&zwj;)"; p++; }
+            { *m_t << "\\&zwj;)"; p++; }
           else
-            m_t << "\\";
+            *m_t << "\\";
           break;
         default:
           {
             uchar uc = static_cast<uchar>(c);
             if (uc<32 && !isspace(c))
             {
-              m_t << "&#x24" << hex[uc>>4] << hex[uc&0xF] << ";";
+              *m_t << "&#x24" << hex[uc>>4] << hex[uc&0xF] << ";";
             }
             else
             {
-              m_t << c;
+              *m_t << c;
             }
           }
           break;
@@ -655,11 +655,11 @@ void HtmlCodeGenerator::writeLineNumber(const char *ref,const char *filename,
 
   if (!m_lineOpen)
   {
-    m_t << "<div class=\"line\">";
+    *m_t << "<div class=\"line\">";
     m_lineOpen = TRUE;
   }
 
-  m_t << "<a name=\"" << lineAnchor << "\"></a><span class=\"lineno\">";
+  *m_t << "<a name=\"" << lineAnchor << "\"></a><span class=\"lineno\">";
   if (filename)
   {
     _writeCodeLink("line",ref,filename,anchor,lineNumber,0);
@@ -668,8 +668,8 @@ void HtmlCodeGenerator::writeLineNumber(const char *ref,const char *filename,
   {
     codify(lineNumber);
   }
-  m_t << "</span>";
-  m_t << "&#160;";
+  *m_t << "</span>";
+  *m_t << "&#160;";
   m_col=0;
 }
 
@@ -689,22 +689,22 @@ void HtmlCodeGenerator::_writeCodeLink(const char *className,
 {
   if (ref)
   {
-    m_t << "<a class=\"" << className << "Ref\" ";
-    m_t << externalLinkTarget();
+    *m_t << "<a class=\"" << className << "Ref\" ";
+    *m_t << externalLinkTarget();
   }
   else
   {
-    m_t << "<a class=\"" << className << "\" ";
+    *m_t << "<a class=\"" << className << "\" ";
   }
-  m_t << "href=\"";
-  m_t << externalRef(m_relPath,ref,TRUE);
-  if (f) m_t << addHtmlExtensionIfMissing(f);
-  if (anchor) m_t << "#" << anchor;
-  m_t << "\"";
-  if (tooltip) m_t << " title=\"" << convertToHtml(tooltip) << "\"";
-  m_t << ">";
+  *m_t << "href=\"";
+  *m_t << externalRef(m_relPath,ref,TRUE);
+  if (f) *m_t << addHtmlExtensionIfMissing(f);
+  if (anchor) *m_t << "#" << anchor;
+  *m_t << "\"";
+  if (tooltip) *m_t << " title=\"" << convertToHtml(tooltip) << "\"";
+  *m_t << ">";
   docify(name);
-  m_t << "</a>";
+  *m_t << "</a>";
   m_col+=qstrlen(name);
 }
 
@@ -713,80 +713,80 @@ void HtmlCodeGenerator::writeTooltip(const char *id, const DocLinkInfo &docInfo,
                                      const SourceLinkInfo &defInfo,
                                      const SourceLinkInfo &declInfo)
 {
-  m_t << "<div class=\"ttc\" id=\"" << id << "\">";
-  m_t << "<div class=\"ttname\">";
+  *m_t << "<div class=\"ttc\" id=\"" << id << "\">";
+  *m_t << "<div class=\"ttname\">";
   if (!docInfo.url.isEmpty())
   {
-    m_t << "<a href=\"";
-    m_t << externalRef(m_relPath,docInfo.ref,TRUE);
-    m_t << addHtmlExtensionIfMissing(docInfo.url);
+    *m_t << "<a href=\"";
+    *m_t << externalRef(m_relPath,docInfo.ref,TRUE);
+    *m_t << addHtmlExtensionIfMissing(docInfo.url);
     if (!docInfo.anchor.isEmpty())
     {
-      m_t << "#" << docInfo.anchor;
+      *m_t << "#" << docInfo.anchor;
     }
-    m_t << "\">";
+    *m_t << "\">";
   }
   docify(docInfo.name);
   if (!docInfo.url.isEmpty())
   {
-    m_t << "</a>";
+    *m_t << "</a>";
   }
-  m_t << "</div>";
+  *m_t << "</div>";
   if (decl)
   {
-    m_t << "<div class=\"ttdeci\">";
+    *m_t << "<div class=\"ttdeci\">";
     docify(decl);
-    m_t << "</div>";
+    *m_t << "</div>";
   }
   if (desc)
   {
-    m_t << "<div class=\"ttdoc\">";
+    *m_t << "<div class=\"ttdoc\">";
     docify(desc);
-    m_t << "</div>";
+    *m_t << "</div>";
   }
   if (!defInfo.file.isEmpty())
   {
-    m_t << "<div class=\"ttdef\"><b>Definition:</b> ";
+    *m_t << "<div class=\"ttdef\"><b>Definition:</b> ";
     if (!defInfo.url.isEmpty())
     {
-      m_t << "<a href=\"";
-      m_t << externalRef(m_relPath,defInfo.ref,TRUE);
-      m_t << addHtmlExtensionIfMissing(defInfo.url);
+      *m_t << "<a href=\"";
+      *m_t << externalRef(m_relPath,defInfo.ref,TRUE);
+      *m_t << addHtmlExtensionIfMissing(defInfo.url);
       if (!defInfo.anchor.isEmpty())
       {
-        m_t << "#" << defInfo.anchor;
+        *m_t << "#" << defInfo.anchor;
       }
-      m_t << "\">";
+      *m_t << "\">";
     }
-    m_t << defInfo.file << ":" << defInfo.line;
+    *m_t << defInfo.file << ":" << defInfo.line;
     if (!defInfo.url.isEmpty())
     {
-      m_t << "</a>";
+      *m_t << "</a>";
     }
-    m_t << "</div>";
+    *m_t << "</div>";
   }
   if (!declInfo.file.isEmpty())
   {
-    m_t << "<div class=\"ttdecl\"><b>Declaration:</b> ";
+    *m_t << "<div class=\"ttdecl\"><b>Declaration:</b> ";
     if (!declInfo.url.isEmpty())
     {
-      m_t << "<a href=\"";
-      m_t << externalRef(m_relPath,declInfo.ref,TRUE);
-      m_t << addHtmlExtensionIfMissing(declInfo.url);
+      *m_t << "<a href=\"";
+      *m_t << externalRef(m_relPath,declInfo.ref,TRUE);
+      *m_t << addHtmlExtensionIfMissing(declInfo.url);
       if (!declInfo.anchor.isEmpty())
       {
-        m_t << "#" << declInfo.anchor;
+        *m_t << "#" << declInfo.anchor;
       }
-      m_t << "\">";
+      *m_t << "\">";
     }
-    m_t << declInfo.file << ":" << declInfo.line;
+    *m_t << declInfo.file << ":" << declInfo.line;
     if (!declInfo.url.isEmpty())
     {
-      m_t << "</a>";
+      *m_t << "</a>";
     }
-    m_t << "</div>";
+    *m_t << "</div>";
   }
-  m_t << "</div>" << endl;
+  *m_t << "</div>" << endl;
 }
 
 
@@ -797,7 +797,7 @@ void HtmlCodeGenerator::startCodeLine(bool)
     m_col=0;
     if (!m_lineOpen)
     {
-      m_t << "<div class=\"line\">";
+      *m_t << "<div class=\"line\">";
       m_lineOpen = TRUE;
     }
   }
@@ -809,12 +809,12 @@ void HtmlCodeGenerator::endCodeLine()
   {
     if (m_col == 0)
     {
-      m_t << " ";
+      *m_t << " ";
       m_col++;
     }
     if (m_lineOpen)
     {
-      m_t << "</div>\n";
+      *m_t << "</div>\n";
       m_lineOpen = FALSE;
     }
   }
@@ -822,22 +822,22 @@ void HtmlCodeGenerator::endCodeLine()
 
 void HtmlCodeGenerator::startFontClass(const char *s)
 {
-  if (m_streamSet) m_t << "<span class=\"" << s << "\">";
+  if (m_streamSet) *m_t << "<span class=\"" << s << "\">";
 }
 
 void HtmlCodeGenerator::endFontClass()
 {
-  if (m_streamSet) m_t << "</span>";
+  if (m_streamSet) *m_t << "</span>";
 }
 
 void HtmlCodeGenerator::writeCodeAnchor(const char *anchor)
 {
-  if (m_streamSet) m_t << "<a name=\"" << anchor << "\"></a>";
+  if (m_streamSet) *m_t << "<a name=\"" << anchor << "\"></a>";
 }
 
 void HtmlCodeGenerator::startCodeFragment(const char *)
 {
-  if (m_streamSet) m_t << "<div class=\"fragment\">";
+  if (m_streamSet) *m_t << "<div class=\"fragment\">";
 }
 
 void HtmlCodeGenerator::endCodeFragment(const char *)
@@ -845,7 +845,7 @@ void HtmlCodeGenerator::endCodeFragment(const char *)
   //endCodeLine checks is there is still an open code line, if so closes it.
   endCodeLine();
 
-  if (m_streamSet) m_t << "</div><!-- fragment -->";
+  if (m_streamSet) *m_t << "</div><!-- fragment -->";
 }
 
 
@@ -59,7 +59,7 @@ class HtmlCodeGenerator : public CodeOutputInterface
                         const char *tooltip);
     void docify(const char *str);
     bool m_streamSet = false;
-    FTextStream m_t;
+    FTextStream *m_t = 0;
     int m_col = 0;
     QCString m_relPath;
     bool m_lineOpen = false;
@@ -80,6 +80,30 @@ int documentedHtmlFiles;
 int documentedPages;
 int documentedDirs;
 
+//----------------------------------------------------------------------------
+
+static THREAD_LOCAL IndexRecorder *g_activeIndexRecorder = 0;
+
+void IndexRecorder::replay(IndexList &il) const
+{
+  for (const auto &call : m_calls)
+  {
+    call(il);
+  }
+}
+
+void IndexRecorder::setActive(IndexRecorder *recorder)
+{
+  g_activeIndexRecorder = recorder;
+}
+
+IndexRecorder *IndexRecorder::active()
+{
+  return g_activeIndexRecorder;
+}
+
+//----------------------------------------------------------------------------
+
 static int countClassHierarchy(ClassDef::CompoundType ct);
 static void countFiles(int &htmlFiles,int &files);
 static int countGroups();
@@ -19,6 +19,7 @@
 #include <utility>
 #include <vector>
 #include <memory>
+#include <functional>
 
 #include <qcstring.h>
 
@@ -27,6 +28,7 @@ class DefinitionMutable;
 class MemberDef;
 class OutputList;
 class FTextStream;
+class IndexList;
 
 /** \brief Abstract interface for index generators. */
 class IndexIntf
@@ -47,6 +49,29 @@ class IndexIntf
     virtual void addStyleSheetFile(const char *name) = 0;
 };
 
+/** \brief Records the calls made to an IndexList by a thread, so they can
+ *  be applied to the index later on in a fixed order.
+ *
+ *  While a recorder is active for a thread, the IndexList methods that add
+ *  items store the call in the recorder instead of forwarding it.
+ */
+class IndexRecorder
+{
+  public:
+    using Call = std::function<void(IndexList &)>;
+    void record(Call &&call) { m_calls.push_back(std::move(call)); }
+    /** Applies all recorded calls to \a il in the order they were recorded */
+    void replay(IndexList &il) const;
+
+    /** Makes \a recorder the active recorder for the calling thread, pass 0 to deactivate */
+    static void setActive(IndexRecorder *recorder);
+    /** Returns the recorder that is active for the calling thread or 0 if there is none */
+    static IndexRecorder *active();
+
+  private:
+    std::vector<Call> m_calls;
+};
+
 /** \brief A list of index interfaces.
  *
  *  This class itself implements all methods of IndexIntf and
@@ -57,6 +82,18 @@ class IndexList : public IndexIntf
   private:
     std::vector< std::unique_ptr<IndexIntf> > m_intfs;
 
+    // Copy of a string argument for a recorded call, which keeps a null pointer distinct
+    // from an empty string.
+    class StrArg
+    {
+      public:
+        StrArg(const char *s) : m_str(s), m_isNull(s==0) {}
+        operator const char *() const { return m_isNull ? 0 : m_str.data(); }
+      private:
+        QCString m_str;
+        bool m_isNull;
+    };
+
     // For each index format we forward the method call.
     // We use C++11 variadic templates and perfect forwarding to implement foreach() generically,
     // and split the types of the methods from the arguments passed to allow implicit conversions.
@@ -91,21 +128,64 @@ class IndexList : public IndexIntf
     void finalize()
     { foreach(&IndexIntf::finalize); }
     void incContentsDepth()
-    { if (m_enabled) foreach(&IndexIntf::incContentsDepth); }
+    {
+      if (!m_enabled) return;
+      if (IndexRecorder *r=IndexRecorder::active())
+      { r->record([](IndexList &il) { il.incContentsDepth(); }); return; }
+      foreach(&IndexIntf::incContentsDepth);
+    }
     void decContentsDepth()
-    { if (m_enabled) foreach(&IndexIntf::decContentsDepth); }
+    {
+      if (!m_enabled) return;
+      if (IndexRecorder *r=IndexRecorder::active())
+      { r->record([](IndexList &il) { il.decContentsDepth(); }); return; }
+      foreach(&IndexIntf::decContentsDepth);
+    }
     void addContentsItem(bool isDir, const char *name, const char *ref,
                          const char *file, const char *anchor,bool separateIndex=FALSE,bool addToNavIndex=FALSE,
                          const Definition *def=0)
-    { if (m_enabled) foreach(&IndexIntf::addContentsItem,isDir,name,ref,file,anchor,separateIndex,addToNavIndex,def); }
+    {
+      if (!m_enabled) return;
+      if (IndexRecorder *r=IndexRecorder::active())
+      {
+        StrArg n(name),rf(ref),f(file),a(anchor);
+        r->record([=](IndexList &il) { il.addContentsItem(isDir,n,rf,f,a,separateIndex,addToNavIndex,def); });
+        return;
+      }
+      foreach(&IndexIntf::addContentsItem,isDir,name,ref,file,anchor,separateIndex,addToNavIndex,def);
+    }
     void addIndexItem(const Definition *context,const MemberDef *md,const char *sectionAnchor=0,const char *title=0)
-    { if (m_enabled) foreach(&IndexIntf::addIndexItem,context,md,sectionAnchor,title); }
+    {
+      if (!m_enabled) return;
+      if (IndexRecorder *r=IndexRecorder::active())
+      {
+        StrArg sa(sectionAnchor),t(title);
+        r->record([=](IndexList &il) { il.addIndexItem(context,md,sa,t); });
+        return;
+      }
+      foreach(&IndexIntf::addIndexItem,context,md,sectionAnchor,title);
+    }
     void addIndexFile(const char *name)
-    { if (m_enabled) foreach(&IndexIntf::addIndexFile,name); }
+    {
+      if (!m_enabled) return;
+      if (IndexRecorder *r=IndexRecorder::active())
+      { StrArg n(name); r->record([=](IndexList &il) { il.addIndexFile(n); }); return; }
+      foreach(&IndexIntf::addIndexFile,name);
+    }
     void addImageFile(const char *name)
-    { if (m_enabled) foreach(&IndexIntf::addImageFile,name); }
+    {
+      if (!m_enabled) return;
+      if (IndexRecorder *r=IndexRecorder::active())
+      { StrArg n(name); r->record([=](IndexList &il) { il.addImageFile(n); }); return; }
+      foreach(&IndexIntf::addImageFile,name);
+    }
     void addStyleSheetFile(const char *name)
-    { if (m_enabled) foreach(&IndexIntf::addStyleSheetFile,name); }
+    {
+      if (!m_enabled) return;
+      if (IndexRecorder *r=IndexRecorder::active())
+      { StrArg n(name); r->record([=](IndexList &il) { il.addStyleSheetFile(n); }); return; }
+      foreach(&IndexIntf::addStyleSheetFile,name);
+    }
 
   private:
     bool m_enabled;
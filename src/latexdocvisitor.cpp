@@ -371,14 +371,8 @@ void LatexDocVisitor::visit(DocVerbatim *s)
       break;
     case DocVerbatim::Dot:
       {
-        static int dotindex = 1;
-        QCString fileName(4096);
-
-        fileName.sprintf("%s%d%s",
-            (Config_getString(LATEX_OUTPUT)+"/inline_dotgraph_").data(),
-            dotindex++,
-            ".dot"
-           );
+        static AtomicInt dotindex(1);
+        QCString fileName = Config_getString(LATEX_OUTPUT)+"/"+inlineGraphName("inline_dotgraph_",dotindex)+".dot";
         QFile file(fileName);
         if (!file.open(IO_WriteOnly))
         {
@@ -399,13 +393,8 @@ void LatexDocVisitor::visit(DocVerbatim *s)
       break;
     case DocVerbatim::Msc:
       {
-        static int mscindex = 1;
-        QCString baseName(4096);
-
-        baseName.sprintf("%s%d",
-            (Config_getString(LATEX_OUTPUT)+"/inline_mscgraph_").data(),
-            mscindex++
-           );
+        static AtomicInt mscindex(1);
+        QCString baseName = Config_getString(LATEX_OUTPUT)+"/"+inlineGraphName("inline_mscgraph_",mscindex);
         QFile file(baseName+".msc");
         if (!file.open(IO_WriteOnly))
         {
@@ -62,7 +62,7 @@ LatexCodeGenerator::LatexCodeGenerator()
 void LatexCodeGenerator::setTextStream(FTextStream &t)
 {
   m_streamSet = t.device()!=0;
-  m_t.setDevice(t.device());
+  m_t = &t;
 }
 
 void LatexCodeGenerator::setRelativePath(const QCString &path)
@@ -93,21 +93,21 @@ void LatexCodeGenerator::codify(const char *str)
       {
         case 0x0c: p++;  // remove ^L
                    break;
-        case ' ':  m_t <<" ";
+        case ' ':  *m_t <<" ";
                    m_col++;
                    p++;
                    break;
-        case '^':  m_t <<"\\string^";
+        case '^':  *m_t <<"\\string^";
                    m_col++;
                    p++;
                    break;
         case '\t': spacesToNextTabStop =
                          tabSize - (m_col%tabSize);
-                   for (i = 0; i < spacesToNextTabStop; i++) m_t <<" ";
+                   for (i = 0; i < spacesToNextTabStop; i++) *m_t <<" ";
                    m_col+=spacesToNextTabStop;
                    p++;
                    break;
-        case '\n': m_t << '\n';
+        case '\n': *m_t << '\n';
                    m_col=0;
                    p++;
                    break;
@@ -150,7 +150,7 @@ void LatexCodeGenerator::codify(const char *str)
                      COPYCHAR();
                    }
                    result[i]=0; // add terminator
-                   filterLatexString(m_t,(const char *)result,
+                   filterLatexString(*m_t,(const char *)result,
                                      false, // insideTabbing
                                      true,  // insidePre
                                      false, // insideItem
@@ -173,13 +173,13 @@ void LatexCodeGenerator::writeCodeLink(const char *ref,const char *f,
   int l = qstrlen(name);
   if (!ref && usePDFLatex && pdfHyperlinks)
   {
-    m_t << "\\mbox{\\hyperlink{";
-    if (f) m_t << stripPath(f);
-    if (f && anchor) m_t << "_";
-    if (anchor) m_t << anchor;
-    m_t << "}{";
+    *m_t << "\\mbox{\\hyperlink{";
+    if (f) *m_t << stripPath(f);
+    if (f && anchor) *m_t << "_";
+    if (anchor) *m_t << anchor;
+    *m_t << "}{";
     codify(name);
-    m_t << "}}";
+    *m_t << "}}";
   }
   else
   {
@@ -194,7 +194,7 @@ void LatexCodeGenerator::writeLineNumber(const char *ref,const char *fileName,co
   bool pdfHyperlinks = Config_getBool(PDF_HYPERLINKS);
   if (!m_doxyCodeLineOpen)
   {
-    m_t << "\\DoxyCodeLine{";
+    *m_t << "\\DoxyCodeLine{";
     m_doxyCodeLineOpen = TRUE;
   }
   if (m_prettyCode)
@@ -210,7 +210,7 @@ void LatexCodeGenerator::writeLineNumber(const char *ref,const char *fileName,co
       //if (!m_prettyCode) return;
       if (usePDFLatex && pdfHyperlinks)
       {
-        m_t << "\\Hypertarget{" << stripPath(lineAnchor) << "}";
+        *m_t << "\\Hypertarget{" << stripPath(lineAnchor) << "}";
       }
       writeCodeLink(ref,fileName,anchor,lineNumber,0);
     }
@@ -218,11 +218,11 @@ void LatexCodeGenerator::writeLineNumber(const char *ref,const char *fileName,co
     {
       codify(lineNumber);
     }
-    m_t << " ";
+    *m_t << " ";
   }
   else
   {
-    m_t << l << " ";
+    *m_t << l << " ";
   }
   m_col=0;
 }
@@ -233,7 +233,7 @@ void LatexCodeGenerator::startCodeLine(bool)
   m_col=0;
   if (!m_doxyCodeLineOpen)
   {
-    m_t << "\\DoxyCodeLine{";
+    *m_t << "\\DoxyCodeLine{";
     m_doxyCodeLineOpen = TRUE;
   }
 }
@@ -242,7 +242,7 @@ void LatexCodeGenerator::endCodeLine()
 {
   if (m_doxyCodeLineOpen)
   {
-    m_t << "}";
+    *m_t << "}";
     m_doxyCodeLineOpen = FALSE;
   }
   codify("\n");
@@ -250,17 +250,17 @@ void LatexCodeGenerator::endCodeLine()
 
 void LatexCodeGenerator::startFontClass(const char *name)
 {
-  m_t << "\\textcolor{" << name << "}{";
+  *m_t << "\\textcolor{" << name << "}{";
 }
 
 void LatexCodeGenerator::endFontClass()
 {
-  m_t << "}";
+  *m_t << "}";
 }
 
 void LatexCodeGenerator::startCodeFragment(const char *style)
 {
-  m_t << "\n\\begin{" << style << "}{" << m_usedTableLevel << "}\n";
+  *m_t << "\n\\begin{" << style << "}{" << m_usedTableLevel << "}\n";
 }
 
 void LatexCodeGenerator::endCodeFragment(const char *style)
@@ -268,7 +268,7 @@ void LatexCodeGenerator::endCodeFragment(const char *style)
   //endCodeLine checks is there is still an open code line, if so closes it.
   endCodeLine();
 
-  m_t << "\\end{" << style << "}\n";
+  *m_t << "\\end{" << style << "}\n";
 }
 
 
@@ -67,7 +67,7 @@ class LatexCodeGenerator : public CodeOutputInterface
                         const char *tooltip);
     void docify(const char *str);
     bool m_streamSet = false;
-    FTextStream m_t;
+    FTextStream *m_t = 0;
     QCString m_relPath;
     QCString m_sourceFileName;
     int m_col = 0;
@@ -51,6 +51,7 @@
 #include "section.h"
 #include "message.h"
 #include "portable.h"
+#include "parsecache.h"
 
 #if !defined(NDEBUG)
 #define ENABLE_TRACING
@@ -1467,6 +1468,7 @@ static QCString extractTitleId(QCString &title, int level)
     static AtomicInt autoId { 0 };
     QCString id;
     id.sprintf("autotoc_md%d",autoId++);
+    ParseCache::markUncacheable(); // id depends on the order in which files are parsed
     //printf("auto-generated id='%s' title='%s'\n",id.data(),title.data());
     return id;
   }
@@ -2755,7 +2757,7 @@ void MarkdownOutlineParser::parseInput(const char *fileName,
                 const std::shared_ptr<Entry> &root,
                 ClangTUParser* /*clangParser*/)
 {
-  std::shared_ptr<Entry> current = std::make_shared<Entry>();
+  std::shared_ptr<Entry> current = Entry::create();
   int prepend = 0; // number of empty lines in front
   current->lang = SrcLangExt_Markdown;
   current->fileName = fileName;
@@ -14,6 +14,8 @@
  */
 
 #include <stdio.h>
+#include <mutex>
+#include <atomic>
 #include <qglobal.h>
 #include <qregexp.h>
 #include <assert.h>
@@ -329,9 +331,9 @@ class MemberDefImpl : public DefinitionMixin<MemberDefMutable>
     virtual void resolveUnnamedParameters(const MemberDef *md);
 
   private:
-    void _computeLinkableInProject();
-    void _computeIsConstructor();
-    void _computeIsDestructor();
+    bool _computeLinkableInProject() const;
+    bool _computeIsConstructor() const;
+    bool _computeIsDestructor() const;
     void _writeGroupInclude(OutputList &ol,bool inGroup) const;
     void _writeCallGraph(OutputList &ol) const;
     void _writeCallerGraph(OutputList &ol) const;
@@ -345,7 +347,7 @@ class MemberDefImpl : public DefinitionMixin<MemberDefMutable>
     void _writeCategoryRelation(OutputList &ol) const;
     void _writeTagData(const DefType) const;
 
-    static int s_indentLevel;
+    static THREAD_LOCAL int s_indentLevel;
 
     // disable copying of member defs
     MemberDefImpl(const MemberDefImpl &);
@@ -355,9 +357,11 @@ class MemberDefImpl : public DefinitionMixin<MemberDefMutable>
     // PIMPL idiom
     class IMPL;
     IMPL *m_impl;
-    uchar m_isLinkableCached;    // 0 = not cached, 1=FALSE, 2=TRUE
-    uchar m_isConstructorCached; // 0 = not cached, 1=FALSE, 2=TRUE
-    uchar m_isDestructorCached;  // 1 = not cached, 1=FALSE, 2=TRUE
+    // the caches below are filled lazily, possibly from several threads at once,
+    // so each is computed into a local and published with a single store
+    mutable std::atomic<uchar> m_isLinkableCached;    // 0 = not cached, 1=FALSE, 2=TRUE
+    mutable std::atomic<uchar> m_isConstructorCached; // 0 = not cached, 1=FALSE, 2=TRUE
+    mutable std::atomic<uchar> m_isDestructorCached;  // 0 = not cached, 1=FALSE, 2=TRUE
 };
 
 MemberDefMutable *createMemberDef(const char *defFileName,int defLine,int defColumn,
@@ -769,7 +773,7 @@ MemberDef *createMemberDefAlias(const Definition *newScope,const MemberDef *alia
 
 //-----------------------------------------------------------------------------
 
-int MemberDefImpl::s_indentLevel = 0;
+THREAD_LOCAL int MemberDefImpl::s_indentLevel = 0;
 
 //-----------------------------------------------------------------------------
 
@@ -1666,49 +1670,42 @@ QCString MemberDefImpl::anchor() const
   return result;
 }
 
-void MemberDefImpl::_computeLinkableInProject()
+bool MemberDefImpl::_computeLinkableInProject() const
 {
   static bool extractStatic  = Config_getBool(EXTRACT_STATIC);
   static bool extractPrivateVirtual = Config_getBool(EXTRACT_PRIV_VIRTUAL);
-  m_isLinkableCached = 2; // linkable
   //printf("MemberDefImpl::isLinkableInProject(name=%s)\n",name().data());
   if (isHidden())
   {
     //printf("is hidden\n");
-    m_isLinkableCached = 1;
-    return;
+    return FALSE;
   }
   if (templateMaster())
   {
     //printf("has template master\n");
-    m_isLinkableCached = templateMaster()->isLinkableInProject() ? 2 : 1;
-    return;
+    return templateMaster()->isLinkableInProject();
   }
   if (isAnonymous())
   {
     //printf("name invalid\n");
-    m_isLinkableCached = 1; // not a valid or a dummy name
-    return;
+    return FALSE; // not a valid or a dummy name
   }
   if (!hasDocumentation() || isReference())
   {
     //printf("no docs or reference\n");
-    m_isLinkableCached = 1; // no documentation
-    return;
+    return FALSE; // no documentation
   }
   const GroupDef *groupDef = getGroupDef();
   const ClassDef *classDef = getClassDef();
   if (groupDef && !groupDef->isLinkableInProject())
   {
     //printf("group but group not linkable!\n");
-    m_isLinkableCached = 1; // group but group not linkable
-    return;
+    return FALSE; // group but group not linkable
   }
   if (!groupDef && classDef && !classDef->isLinkableInProject())
   {
     //printf("in a class but class not linkable!\n");
-    m_isLinkableCached = 1; // in class but class not linkable
-    return;
+    return FALSE; // in class but class not linkable
   }
   const NamespaceDef *nspace = getNamespaceDef();
   const FileDef *fileDef = getFileDef();
@@ -1716,32 +1713,28 @@ void MemberDefImpl::_computeLinkableInProject()
       && (fileDef==0 || !fileDef->isLinkableInProject()))
   {
     //printf("in a namespace but namespace not linkable!\n");
-    m_isLinkableCached = 1; // in namespace but namespace not linkable
-    return;
+    return FALSE; // in namespace but namespace not linkable
   }
   if (!groupDef && !nspace &&
       !m_impl->related && !classDef &&
       fileDef && !fileDef->isLinkableInProject())
   {
     //printf("in a file but file not linkable!\n");
-    m_isLinkableCached = 1; // in file (and not in namespace) but file not linkable
-    return;
+    return FALSE; // in file (and not in namespace) but file not linkable
   }
   if ((!protectionLevelVisible(m_impl->prot) && m_impl->mtype!=MemberType_Friend) &&
        !(m_impl->prot==Private && m_impl->virt!=Normal && extractPrivateVirtual))
   {
     //printf("private and invisible!\n");
-    m_isLinkableCached = 1; // hidden due to protection
-    return;
+    return FALSE; // hidden due to protection
   }
   if (m_impl->stat && classDef==0 && !extractStatic)
   {
     //printf("static and invisible!\n");
-    m_isLinkableCached = 1; // hidden due to staticness
-    return;
+    return FALSE; // hidden due to staticness
   }
   //printf("linkable!\n");
-  return; // linkable!
+  return TRUE; // linkable!
 }
 
 void MemberDefImpl::setDocumentation(const char *d,const char *docFile,int docLine,bool stripWhiteSpace)
@@ -1770,13 +1763,13 @@ void MemberDefImpl::setHidden(bool b)
 
 bool MemberDefImpl::isLinkableInProject() const
 {
-  if (m_isLinkableCached==0)
+  uchar cached = m_isLinkableCached;
+  if (cached==0)
   {
-    MemberDefImpl *that = (MemberDefImpl*)this;
-    that->_computeLinkableInProject();
+    cached = _computeLinkableInProject() ? 2 : 1;
+    m_isLinkableCached = cached;
   }
-  ASSERT(m_isLinkableCached>0);
-  return m_isLinkableCached==2;
+  return cached==2;
 }
 
 bool MemberDefImpl::isLinkable() const
@@ -4403,26 +4396,22 @@ void MemberDefImpl::writeTagFile(FTextStream &tagFile) const
   tagFile << "    </member>" << endl;
 }
 
-void MemberDefImpl::_computeIsConstructor()
+bool MemberDefImpl::_computeIsConstructor() const
 {
-  m_isConstructorCached=1; // FALSE
   if (getClassDef())
   {
     if (m_impl->isDMember) // for D
     {
-      m_isConstructorCached = name()=="this" ? 2 : 1;
-      return;
+      return name()=="this";
     }
     else if (getLanguage()==SrcLangExt_PHP) // for PHP
     {
-      m_isConstructorCached = name()=="__construct" ? 2 : 1;
-      return;
+      return name()=="__construct";
     }
     else if (name()=="__init__" &&
              getLanguage()==SrcLangExt_Python) // for Python
     {
-      m_isConstructorCached = 2; // TRUE
-      return;
+      return TRUE;
     }
     else // for other languages
     {
@@ -4430,30 +4419,29 @@ void MemberDefImpl::_computeIsConstructor()
       int i=locName.find('<');
       if (i==-1) // not a template class
       {
-        m_isConstructorCached = name()==locName ? 2 : 1;
+        return name()==locName;
       }
       else
       {
-        m_isConstructorCached = name()==locName.left(i) ? 2 : 1;
+        return name()==locName.left(i);
       }
-      return;
     }
   }
+  return FALSE;
 }
 
 bool MemberDefImpl::isConstructor() const
 {
-  if (m_isConstructorCached==0)
+  uchar cached = m_isConstructorCached;
+  if (cached==0)
   {
-    MemberDefImpl *that = (MemberDefImpl*)this;
-    that->_computeIsConstructor();
+    cached = _computeIsConstructor() ? 2 : 1;
+    m_isConstructorCached = cached;
   }
-  ASSERT(m_isConstructorCached>0);
-  return m_isConstructorCached==2;
-
+  return cached==2;
 }
 
-void MemberDefImpl::_computeIsDestructor()
+bool MemberDefImpl::_computeIsDestructor() const
 {
   bool isDestructor;
   if (m_impl->isDMember) // for D
@@ -4475,18 +4463,18 @@ void MemberDefImpl::_computeIsDestructor()
            (name().find('~')!=-1 || name().find('!')!=-1)  // The ! is for C++/CLI
            && name().find("operator")==-1;
   }
-  m_isDestructorCached = isDestructor ? 2 : 1;
+  return isDestructor;
 }
 
 bool MemberDefImpl::isDestructor() const
 {
-  if (m_isDestructorCached==0)
+  uchar cached = m_isDestructorCached;
+  if (cached==0)
   {
-    MemberDefImpl *that=(MemberDefImpl*)this;
-    that->_computeIsDestructor();
+    cached = _computeIsDestructor() ? 2 : 1;
+    m_isDestructorCached = cached;
   }
-  ASSERT(m_isDestructorCached>0);
-  return m_isDestructorCached==2;
+  return cached==2;
 }
 
 void MemberDefImpl::writeEnumDeclaration(OutputList &typeDecl,
@@ -5388,23 +5376,31 @@ const MemberDef *MemberDefImpl::templateMaster() const
   return m_impl->templateMaster;
 }
 
+// The typedef cache is filled while resolving links, which the source and
+// documentation generators do from multiple threads.
+static std::mutex g_typedefCacheMutex;
+
 bool MemberDefImpl::isTypedefValCached() const
 {
+  std::lock_guard<std::mutex> lock(g_typedefCacheMutex);
   return m_impl->isTypedefValCached;
 }
 
 const ClassDef *MemberDefImpl::getCachedTypedefVal() const
 {
+  std::lock_guard<std::mutex> lock(g_typedefCacheMutex);
   return m_impl->cachedTypedefValue;
 }
 
 QCString MemberDefImpl::getCachedTypedefTemplSpec() const
 {
+  std::lock_guard<std::mutex> lock(g_typedefCacheMutex);
   return m_impl->cachedTypedefTemplSpec;
 }
 
 QCString MemberDefImpl::getCachedResolvedTypedef() const
 {
+  std::lock_guard<std::mutex> lock(g_typedefCacheMutex);
   //printf("MemberDefImpl::getCachedResolvedTypedef()=%s m_impl=%p\n",m_impl->cachedResolvedType.data(),m_impl);
   return m_impl->cachedResolvedType;
 }
@@ -5631,6 +5627,7 @@ void MemberDefImpl::setGroupAlias(const MemberDef *md)
 
 void MemberDefImpl::invalidateTypedefValCache()
 {
+  std::lock_guard<std::mutex> lock(g_typedefCacheMutex);
   m_impl->isTypedefValCached=FALSE;
 }
 
@@ -5677,10 +5674,14 @@ QCString MemberDefImpl::enumBaseType() const
 
 void MemberDefImpl::cacheTypedefVal(const ClassDef*val, const QCString & templSpec, const QCString &resolvedType)
 {
-  m_impl->isTypedefValCached=TRUE;
+  std::lock_guard<std::mutex> lock(g_typedefCacheMutex);
+  // once cached the value is not changed anymore, so a reader that saw the
+  // flag gets the values of the same resolution for all its getters
+  if (m_impl->isTypedefValCached) return;
   m_impl->cachedTypedefValue=val;
   m_impl->cachedTypedefTemplSpec=templSpec;
   m_impl->cachedResolvedType=resolvedType;
+  m_impl->isTypedefValCached=TRUE;
   //printf("MemberDefImpl::cacheTypedefVal=%s m_impl=%p\n",m_impl->cachedResolvedType.data(),m_impl);
 }
 
@@ -19,6 +19,7 @@
 #include "portable.h"
 #include "message.h"
 #include "doxygen.h"
+#include "parsecache.h"
 
 #include <mutex>
 
@@ -136,6 +137,8 @@ void msg(const char *fmt, ...)
 
 static void format_warn(const char *file,int line,const char *text)
 {
+  // a file restored from the parse cache would not report this warning again
+  ParseCache::markUncacheable();
   QCString fileSubst = file==0 ? "<unknown>" : file;
   QCString lineSubst; lineSubst.setNum(line);
   QCString textSubst = text;
@@ -175,6 +178,7 @@ static void format_warn(const char *file,int line,const char *text)
 
 static void handle_warn_as_error()
 {
+  ParseCache::markUncacheable();
   if (warnBehavior == WARN_YES)
   {
     std::unique_lock<std::mutex> lock(g_mutex);
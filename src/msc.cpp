@@ -28,8 +28,13 @@
 
 #include <qdir.h>
 
+#include <mutex>
+
 static const int maxCmdLine = 40960;
 
+// mscgen keeps its parser state in globals, so only one graph can be generated at a time
+static std::mutex g_mscMutex;
+
 static bool convertMapFile(FTextStream &t,const char *mapName,const QCString relPath,
                            const QCString &context)
 {
@@ -118,7 +123,11 @@ void writeMscGraphFromFile(const char *inFile,const char *outDir,
       return;
   }
   int code;
-  if ((code=mscgen_generate(inFile,imgName,msc_format))!=0)
+  {
+    std::lock_guard<std::mutex> lock(g_mscMutex);
+    code=mscgen_generate(inFile,imgName,msc_format);
+  }
+  if (code!=0)
   {
     err("Problems generating msc output (error=%s). Look for typos in you msc file %s\n",
         mscgen_error2str(code),inFile);
@@ -149,8 +158,12 @@ static QCString getMscImageMapFromFile(const QCString& inFile, const QCString& o
   QCString outFile = inFile + ".map";
 
   int code;
-  if ((code=mscgen_generate(inFile,outFile,
-                            writeSVGMap ? mscgen_format_svgmap : mscgen_format_pngmap))!=0)
+  {
+    std::lock_guard<std::mutex> lock(g_mscMutex);
+    code=mscgen_generate(inFile,outFile,
+                         writeSVGMap ? mscgen_format_svgmap : mscgen_format_pngmap);
+  }
+  if (code!=0)
   {
     err("Problems generating msc output (error=%s). Look for typos in you msc file %s\n",
         mscgen_error2str(code),inFile.data());
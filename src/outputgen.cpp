@@ -19,12 +19,13 @@
 
 #include <stdlib.h>
 
-#include <qfile.h>
+#include <qbuffer.h>
 
 #include "doxygen.h"
 #include "outputgen.h"
 #include "message.h"
 #include "portable.h"
+#include "util.h"
 
 OutputGenerator::OutputGenerator(const char *dir) : m_dir(dir)
 {
@@ -63,18 +64,31 @@ void OutputGenerator::startPlainFile(const char *name)
 {
   //printf("startPlainFile(%s)\n",name);
   m_fileName=m_dir+"/"+name;
-  m_file.setName(m_fileName);
-  if (!m_file.open(IO_WriteOnly))
-  {
-    term("Could not open file %s for writing\n",m_fileName.data());
-  }
-  t.setDevice(&m_file);
+  // collect the output in memory, so endPlainFile() can leave the file
+  // alone when its contents did not change since the previous run
+  m_buffer.setBuffer(QByteArray());
+  m_buffer.open(IO_WriteOnly);
+  t.setBuffered(true);
+  t.setDevice(&m_buffer);
 }
 
 void OutputGenerator::endPlainFile()
 {
   t.unsetDevice();
-  m_file.close();
+  m_buffer.close();
+  QByteArray data = m_buffer.buffer();
+  switch (writeFileIfChanged(m_fileName,data.data(),data.size()))
+  {
+    case WriteFileResult::Ok:
+      break;
+    case WriteFileResult::OpenFailed:
+      term("Could not open file %s for writing\n",m_fileName.data());
+      break;
+    case WriteFileResult::WriteFailed:
+      term("Could not write file %s, the disk may be full\n",m_fileName.data());
+      break;
+  }
+  m_buffer.setBuffer(QByteArray());
   m_fileName.resize(0);
 }
 
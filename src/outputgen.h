@@ -21,7 +21,7 @@
 #include <memory>
 #include <stack>
 
-#include <qfile.h>
+#include <qbuffer.h>
 
 #include "index.h"
 #include "section.h"
@@ -500,7 +500,7 @@ class OutputGenerator : public BaseOutputDocInterface
   private:
     QCString m_dir;
     QCString m_fileName;
-    QFile m_file;
+    QBuffer m_buffer;
     bool m_active = true;
     std::stack<bool> m_genStack;
 };
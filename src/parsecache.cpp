@@ -0,0 +1,513 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <string>
+
+#include <qdir.h>
+#include <qfileinfo.h>
+#include <qgstring.h>
+
+#include "parsecache.h"
+#include "binarystream.h"
+#include "entry.h"
+#include "config.h"
+#include "doxygen.h"
+#include "message.h"
+#include "portable.h"
+#include "version.h"
+#include "ftextstream.h"
+#include "md5.h"
+
+// increase this when the layout of the cache files changes
+static const int   g_cacheFormatVersion = 1;
+static const char *g_cacheMagic         = "DOXYPARSECACHE";
+
+// Options that can not influence the result of parsing a file. Changing them
+// should not invalidate the cache.
+static const char *g_ignoredOptions[] =
+{
+  "PROJECT_NAME", "PROJECT_NUMBER", "PROJECT_BRIEF", "PROJECT_LOGO",
+  "OUTPUT_DIRECTORY", "PARSE_CACHE_DIR", "NUM_PROC_THREADS",
+  "PARALLEL_SOURCE_GENERATION", "QUIET", "WARN_LOGFILE", "INPUT", 0
+};
+
+/** Per thread state used to detect side effects while parsing a file */
+struct RecordingState
+{
+  bool recording   = false;
+  bool uncacheable = false;
+};
+
+static THREAD_LOCAL RecordingState g_recordingState;
+
+//------------------------------------------------------------------------
+
+/** Helper to write an Entry tree into a binary buffer */
+class EntryWriter : public BinaryWriter
+{
+  public:
+    EntryWriter(std::string &buf) : BinaryWriter(buf) {}
+
+    using BinaryWriter::writeString;
+    void writeString(const QGString &s) { writeString(s.data(),s.length()); }
+
+    void writeArgumentList(const ArgumentList &al)
+    {
+      writeUInt64(al.size());
+      for (const Argument &a : al)
+      {
+        writeString(a.attrib);
+        writeString(a.type);
+        writeString(a.canType);
+        writeString(a.name);
+        writeString(a.array);
+        writeString(a.defval);
+        writeString(a.docs);
+        writeString(a.typeConstraint);
+      }
+      writeBool(al.constSpecifier());
+      writeBool(al.volatileSpecifier());
+      writeBool(al.pureSpecifier());
+      writeString(al.trailingReturnType());
+      writeBool(al.isDeleted());
+      writeInt(al.refQualifier());
+      writeBool(al.noParameters());
+    }
+
+    void writeEntry(const Entry *e)
+    {
+      writeInt(e->section);
+      writeString(e->type);
+      writeString(e->name);
+      writeBool(e->hasTagInfo);
+      writeString(e->tagInfoData.tagName);
+      writeString(e->tagInfoData.fileName);
+      writeString(e->tagInfoData.anchor);
+      writeInt(e->protection);
+      writeInt(e->mtype);
+      writeUInt64(e->spec);
+      writeInt(e->initLines);
+      writeBool(e->stat);
+      writeBool(e->explicitExternal);
+      writeBool(e->proto);
+      writeBool(e->subGrouping);
+      writeBool(e->callGraph);
+      writeBool(e->callerGraph);
+      writeBool(e->referencedByRelation);
+      writeBool(e->referencesRelation);
+      writeInt(e->virt);
+      writeString(e->args);
+      writeString(e->bitfields);
+      writeArgumentList(e->argList);
+      writeUInt64(e->tArgLists.size());
+      for (const ArgumentList &al : e->tArgLists)
+      {
+        writeArgumentList(al);
+      }
+      writeString(e->program);
+      writeString(e->initializer);
+      writeString(e->includeFile);
+      writeString(e->includeName);
+      writeString(e->doc);
+      writeInt(e->docLine);
+      writeString(e->docFile);
+      writeString(e->brief);
+      writeInt(e->briefLine);
+      writeString(e->briefFile);
+      writeString(e->inbodyDocs);
+      writeInt(e->inbodyLine);
+      writeString(e->inbodyFile);
+      writeString(e->relates);
+      writeInt(e->relatesType);
+      writeString(e->read);
+      writeString(e->write);
+      writeString(e->inside);
+      writeString(e->exception);
+      writeArgumentList(e->typeConstr);
+      writeInt(e->bodyLine);
+      writeInt(e->bodyColumn);
+      writeInt(e->endBodyLine);
+      writeInt(e->mGrpId);
+      writeUInt64(e->extends.size());
+      for (const BaseInfo &bi : e->extends)
+      {
+        writeString(bi.name);
+        writeInt(bi.prot);
+        writeInt(bi.virt);
+      }
+      writeUInt64(e->groups.size());
+      for (const Grouping &g : e->groups)
+      {
+        writeString(g.groupname);
+        writeInt(g.pri);
+      }
+      writeString(e->fileName);
+      writeInt(e->startLine);
+      writeInt(e->startColumn);
+      writeInt(e->lang);
+      writeBool(e->hidden);
+      writeBool(e->artificial);
+      writeInt(e->groupDocType);
+      writeString(e->id);
+      writeInt(e->localToc.mask());
+      writeInt(e->localToc.htmlLevel());
+      writeInt(e->localToc.latexLevel());
+      writeInt(e->localToc.xmlLevel());
+      writeInt(e->localToc.docbookLevel());
+      writeString(e->metaData);
+      writeUInt64(e->children().size());
+      for (const auto &child : e->children())
+      {
+        writeEntry(child.get());
+      }
+    }
+};
+
+//------------------------------------------------------------------------
+
+/** Helper to read an Entry tree from a binary buffer written by EntryWriter.
+ *  After an error ok() returns FALSE and the result should be discarded.
+ */
+class EntryReader : public BinaryReader
+{
+  public:
+    EntryReader(const char *buf,size_t len) : BinaryReader(buf,len) {}
+
+    // the string members of Entry are QCStrings
+    QCString readString() { return QCString(BinaryReader::readString()); }
+
+    void readArgumentList(ArgumentList &al)
+    {
+      al.reset();
+      size_t n = readCount();
+      for (size_t i=0;i<n && ok();i++)
+      {
+        Argument a;
+        a.attrib         = readString();
+        a.type           = readString();
+        a.canType        = readString();
+        a.name           = readString();
+        a.array          = readString();
+        a.defval         = readString();
+        a.docs           = readString();
+        a.typeConstraint = readString();
+        al.push_back(a);
+      }
+      al.setConstSpecifier(readBool());
+      al.setVolatileSpecifier(readBool());
+      al.setPureSpecifier(readBool());
+      al.setTrailingReturnType(readString());
+      al.setIsDeleted(readBool());
+      al.setRefQualifier(static_cast<RefQualifierType>(readInt()));
+      al.setNoParameters(readBool());
+    }
+
+    void readEntry(Entry *e)
+    {
+      e->section              = readInt();
+      e->type                 = readString();
+      e->name                 = readString();
+      e->hasTagInfo           = readBool();
+      e->tagInfoData.tagName  = readString();
+      e->tagInfoData.fileName = readString();
+      e->tagInfoData.anchor   = readString();
+      e->protection           = static_cast<Protection>(readInt());
+      e->mtype                = static_cast<MethodTypes>(readInt());
+      e->spec                 = readUInt64();
+      e->initLines            = readInt();
+      e->stat                 = readBool();
+      e->explicitExternal     = readBool();
+      e->proto                = readBool();
+      e->subGrouping          = readBool();
+      e->callGraph            = readBool();
+      e->callerGraph          = readBool();
+      e->referencedByRelation = readBool();
+      e->referencesRelation   = readBool();
+      e->virt                 = static_cast<Specifier>(readInt());
+      e->args                 = readString();
+      e->bitfields            = readString();
+      readArgumentList(e->argList);
+      size_t numTArgLists = readCount();
+      for (size_t i=0;i<numTArgLists && ok();i++)
+      {
+        ArgumentList al;
+        readArgumentList(al);
+        e->tArgLists.push_back(al);
+      }
+      e->program              = readString();
+      e->initializer          = readString();
+      e->includeFile          = readString();
+      e->includeName          = readString();
+      e->doc                  = readString();
+      e->docLine              = readInt();
+      e->docFile              = readString();
+      e->brief                = readString();
+      e->briefLine            = readInt();
+      e->briefFile            = readString();
+      e->inbodyDocs           = readString();
+      e->inbodyLine           = readInt();
+      e->inbodyFile           = readString();
+      e->relates              = readString();
+      e->relatesType          = static_cast<RelatesType>(readInt());
+      e->read                 = readString();
+      e->write                = readString();
+      e->inside               = readString();
+      e->exception            = readString();
+      readArgumentList(e->typeConstr);
+      e->bodyLine             = readInt();
+      e->bodyColumn           = readInt();
+      e->endBodyLine          = readInt();
+      e->mGrpId               = readInt();
+      size_t numExtends = readCount();
+      for (size_t i=0;i<numExtends && ok();i++)
+      {
+        QCString name  = readString();
+        Protection prot = static_cast<Protection>(readInt());
+        Specifier virt  = static_cast<Specifier>(readInt());
+        e->extends.push_back(BaseInfo(name,prot,virt));
+      }
+      size_t numGroups = readCount();
+      for (size_t i=0;i<numGroups && ok();i++)
+      {
+        QCString name = readString();
+        Grouping::GroupPri_t pri = static_cast<Grouping::GroupPri_t>(readInt());
+        e->groups.push_back(Grouping(name,pri));
+      }
+      e->fileName             = readString();
+      e->startLine            = readInt();
+      e->startColumn          = readInt();
+      e->lang                 = static_cast<SrcLangExt>(readInt());
+      e->hidden               = readBool();
+      e->artificial           = readBool();
+      e->groupDocType         = static_cast<Entry::GroupDocType>(readInt());
+      e->id                   = readString();
+      int tocMask             = readInt();
+      int htmlLevel           = readInt();
+      int latexLevel          = readInt();
+      int xmlLevel            = readInt();
+      int docbookLevel        = readInt();
+      if (tocMask & (1<<LocalToc::Html))    e->localToc.enableHtml(htmlLevel);
+      if (tocMask & (1<<LocalToc::Latex))   e->localToc.enableLatex(latexLevel);
+      if (tocMask & (1<<LocalToc::Xml))     e->localToc.enableXml(xmlLevel);
+      if (tocMask & (1<<LocalToc::Docbook)) e->localToc.enableDocbook(docbookLevel);
+      e->metaData             = readString();
+      size_t numChildren = readCount();
+      for (size_t i=0;i<numChildren && ok();i++)
+      {
+        std::shared_ptr<Entry> child = Entry::create();
+        readEntry(child.get());
+        e->moveToSubEntryAndKeep(child);
+      }
+    }
+};
+
+//------------------------------------------------------------------------
+
+// returns TRUE if the tree contains references to global objects
+// (sections or cross reference items) that can not be stored
+static bool hasGlobalReferences(const Entry *e)
+{
+  if (!e->anchors.empty() || !e->sli.empty()) return true;
+  for (const auto &child : e->children())
+  {
+    if (hasGlobalReferences(child.get())) return true;
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------
+
+struct ParseCache::Private
+{
+  bool enabled = false;
+  QCString dir;
+  QCString configHash;
+  std::atomic<int> numHits{0};
+  std::atomic<int> numMisses{0};
+  std::atomic<int> numStored{0};
+
+  QCString fileNameForKey(const QCString &key) const
+  {
+    return dir+"/"+key+".entries";
+  }
+};
+
+ParseCache &ParseCache::instance()
+{
+  static ParseCache pc;
+  return pc;
+}
+
+ParseCache::ParseCache() : p(std::make_unique<Private>())
+{
+}
+
+ParseCache::~ParseCache()
+{
+}
+
+void ParseCache::init()
+{
+  QCString dirName = Config_getString(PARSE_CACHE_DIR);
+  p->enabled = false;
+  if (dirName.isEmpty()) return;
+
+  QDir dir(dirName);
+  if (!dir.exists() && !dir.mkdir(dirName,TRUE))
+  {
+    err("Could not create parse cache directory %s, the parse cache is disabled\n",dirName.data());
+    return;
+  }
+  p->dir = QFileInfo(dirName).absFilePath().utf8();
+
+  // compute a hash over the version and all non default settings, skipping
+  // the settings that do not influence parsing
+  QGString config;
+  {
+    FTextStream t(&config);
+    Config::compareDoxyfile(t);
+  }
+  std::string filtered = getFullVersion();
+  filtered+='\n';
+  bool skip = false;
+  const char *s = config.data();
+  while (s && *s)
+  {
+    const char *e = strchr(s,'\n');
+    if (e==0) e = s+strlen(s);
+    if (*s>='A' && *s<='Z') // start of a new option
+    {
+      skip = false;
+      for (const char **opt = g_ignoredOptions; *opt; opt++)
+      {
+        size_t l = strlen(*opt);
+        if (qstrncmp(s,*opt,l)==0 && (s[l]==' ' || s[l]=='=' || s[l]=='+'))
+        {
+          skip = true;
+          break;
+        }
+      }
+    }
+    if (!skip && *s!='#') // skip comments, these contain the config file name
+    {
+      filtered.append(s,static_cast<size_t>(e-s));
+      filtered+='\n';
+    }
+    s = *e ? e+1 : e;
+  }
+  uchar md5_sig[16];
+  char sigStr[33];
+  MD5Buffer((const unsigned char *)filtered.data(),static_cast<unsigned int>(filtered.length()),md5_sig);
+  MD5SigToString(md5_sig,sigStr,33);
+  p->configHash = sigStr;
+  p->enabled = true;
+}
+
+bool ParseCache::isEnabled() const
+{
+  return p->enabled;
+}
+
+QCString ParseCache::computeKey(const char *fileName,const char *buf,size_t len) const
+{
+  struct MD5Context ctx;
+  MD5Init(&ctx);
+  MD5Update(&ctx,(const unsigned char *)p->configHash.data(),p->configHash.length());
+  MD5Update(&ctx,(const unsigned char *)fileName,static_cast<unsigned>(qstrlen(fileName)+1));
+  MD5Update(&ctx,(const unsigned char *)buf,static_cast<unsigned>(len));
+  uchar md5_sig[16];
+  char sigStr[33];
+  MD5Final(md5_sig,&ctx);
+  MD5SigToString(md5_sig,sigStr,33);
+  return sigStr;
+}
+
+std::shared_ptr<Entry> ParseCache::load(const QCString &key)
+{
+  QCString fileName = p->fileNameForKey(key);
+  std::string buf;
+  if (!readFileToString(fileName,buf))
+  {
+    p->numMisses++;
+    return nullptr;
+  }
+
+  EntryReader reader(buf.data(),buf.size());
+  QCString magic = reader.readString();
+  int version    = reader.readInt();
+  std::shared_ptr<Entry> root;
+  if (reader.ok() && magic==g_cacheMagic && version==g_cacheFormatVersion)
+  {
+    root = Entry::create();
+    reader.readEntry(root.get());
+  }
+  if (!root || !reader.ok() || !reader.atEnd())
+  {
+    warn_uncond("ignoring corrupt parse cache file %s\n",fileName.data());
+    p->numMisses++;
+    return nullptr;
+  }
+  p->numHits++;
+  return root;
+}
+
+void ParseCache::store(const QCString &key,const Entry *root)
+{
+  if (hasGlobalReferences(root)) return;
+
+  std::string buf;
+  EntryWriter writer(buf);
+  writer.writeString(g_cacheMagic,strlen(g_cacheMagic));
+  writer.writeInt(g_cacheFormatVersion);
+  writer.writeEntry(root);
+
+  QCString fileName = p->fileNameForKey(key);
+  if (!writeFileAtomically(fileName,buf))
+  {
+    err("Could not write parse cache file %s\n",fileName.data());
+    return;
+  }
+  p->numStored++;
+}
+
+void ParseCache::startRecording()
+{
+  g_recordingState.recording   = true;
+  g_recordingState.uncacheable = false;
+}
+
+bool ParseCache::stopRecording()
+{
+  bool result = g_recordingState.recording && !g_recordingState.uncacheable;
+  g_recordingState.recording   = false;
+  g_recordingState.uncacheable = false;
+  return result;
+}
+
+void ParseCache::markUncacheable()
+{
+  g_recordingState.uncacheable = true;
+}
+
+void ParseCache::printStatistics() const
+{
+  if (!p->enabled) return;
+  msg("Parse cache: %d files restored, %d files parsed, %d results stored\n",
+      p->numHits.load(),p->numMisses.load(),p->numStored.load());
+}
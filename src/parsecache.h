@@ -0,0 +1,74 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef PARSECACHE_H
+#define PARSECACHE_H
+
+#include <memory>
+#include <qcstring.h>
+
+class Entry;
+
+/** Manager for the on-disk cache of parsed input files (see PARSE_CACHE_DIR).
+ *
+ *  The cache stores the Entry tree produced by the language parser for a file,
+ *  keyed by a hash of the text that was handed to the parser (i.e. after
+ *  preprocessing and comment conversion), the file name, the doxygen version, and
+ *  the configuration. The preprocessor still runs for every file, so the state it
+ *  builds up (macros, include relations) is the same as without the cache, and
+ *  any change in predefined macros, include paths, or included files results in a
+ *  different key.
+ *
+ *  Parsing a file can also change global state outside of the Entry tree, such as
+ *  sections, formulas, cross reference items, citations, anonymous scope counters,
+ *  or warnings. Code that does this calls markUncacheable(), which prevents the
+ *  result of parsing that file from being stored, so that a restored file never
+ *  misses such a side effect.
+ */
+class ParseCache
+{
+  public:
+    static ParseCache &instance();
+
+    /** Reads the configuration, must be called before the input is parsed */
+    void init();
+    /** Returns TRUE if the cache is enabled via PARSE_CACHE_DIR */
+    bool isEnabled() const;
+
+    /** Computes the cache key for \a fileName with parser input \a buf of \a len bytes */
+    QCString computeKey(const char *fileName,const char *buf,size_t len) const;
+    /** Returns the entry tree stored under \a key, or nullptr if there is none */
+    std::shared_ptr<Entry> load(const QCString &key);
+    /** Stores the entry tree \a root under \a key */
+    void store(const QCString &key,const Entry *root);
+
+    /** Starts tracking side effects of parsing a file on the calling thread */
+    static void startRecording();
+    /** Stops tracking and returns TRUE if the parse result can be stored in the cache */
+    static bool stopRecording();
+    /** Marks the file currently being parsed by the calling thread as not cacheable */
+    static void markUncacheable();
+
+    /** Prints the number of hits and misses */
+    void printStatistics() const;
+
+  private:
+    ParseCache();
+   ~ParseCache();
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
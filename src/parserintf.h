@@ -74,6 +74,19 @@ class OutlineParserInterface
      */
     virtual void parsePrototype(const char *text) = 0;
 
+    /** Returns TRUE if the Entry tree produced by parseInput() only depends on
+     *  the file name and the contents of the file, such that it can be restored
+     *  from the parse cache.
+     *  @see skipInput()
+     */
+    virtual bool supportsParseCache() const { return FALSE; }
+
+    /** Called instead of parseInput() for a file whose Entry tree was
+     *  restored from the parse cache. A parser that keeps state across files
+     *  should update it here as if the file was parsed.
+     */
+    virtual void skipInput(const char * /* fileName */) {}
+
 };
 
 /** \brief Abstract interface for code parsers.
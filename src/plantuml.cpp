@@ -20,16 +20,21 @@
 #include "doxygen.h"
 #include "message.h"
 #include "debug.h"
+#include "md5.h"
+#include "ftextstream.h"
+#include "threadpool.h"
 
 #include <qfileinfo.h>
 
+#include <thread>
+
 QCString PlantumlManager::writePlantUMLSource(const QCString &outDirArg,const QCString &fileName,const QCString &content,OutputFormat format)
 {
   QCString baseName;
   QCString puName;
   QCString imgName;
   QCString outDir(outDirArg);
-  static int umlindex=1;
+  static AtomicInt umlindex(1);
 
   Debug::print(Debug::Plantuml,0,"*** %s fileName: %s\n","writePlantUMLSource",qPrint(fileName));
   Debug::print(Debug::Plantuml,0,"*** %s outDir: %s\n","writePlantUMLSource",qPrint(outDir));
@@ -43,8 +48,8 @@ QCString PlantumlManager::writePlantUMLSource(const QCString &outDirArg,const QC
 
   if (fileName.isEmpty()) // generate name
   {
-    puName = "inline_umlgraph_"+QCString().setNum(umlindex);
-    baseName = outDir+"/inline_umlgraph_"+QCString().setNum(umlindex++);
+    puName = inlineGraphName("inline_umlgraph_",umlindex);
+    baseName = outDir+"/"+puName;
   }
   else // user specified name
   {
@@ -131,24 +136,80 @@ PlantumlManager::PlantumlManager()
   QFileInfo fi(outputFilename);
   if (fi.exists())
   {
-    m_cachedPlantumlAllContent = fileToString(outputFilename);
+    QCString cachedKeys = fileToString(outputFilename);
+    int p=0,i;
+    while ((i=cachedKeys.find('\n',p))!=-1)
+    {
+      if (i>p) m_cachedKeys.insert(cachedKeys.mid(p,i-p).str());
+      p=i+1;
+    }
+  }
+  Debug::print(Debug::Plantuml,0,"*** instance() : %zu cached diagrams\n",m_cachedKeys.size());
+
+  // everything besides the diagram text that influences the generated images
+  QCString settings;
+  settings+=Config_getString(PLANTUML_JAR_PATH)+"\n";
+  QCString plantumlConfigFile = Config_getString(PLANTUML_CFG_FILE);
+  if (!plantumlConfigFile.isEmpty())
+  {
+    settings+=plantumlConfigFile+"\n"+fileToString(plantumlConfigFile)+"\n";
+  }
+  for (const auto &path : Config_getList(PLANTUML_INCLUDE_PATH))
+  {
+    settings+=path.c_str();
+    settings+="\n";
+  }
+  if (Config_getBool(HAVE_DOT)) settings+=Config_getString(DOT_PATH)+"\n";
+  if (Config_getBool(USE_PDFLATEX)) settings+="pdf\n";
+  uchar md5_sig[16];
+  char sigStr[33];
+  MD5Buffer((const unsigned char *)settings.data(),settings.length(),md5_sig);
+  MD5SigToString(md5_sig,sigStr,33);
+  m_settingsHash = sigStr;
+}
+
+QCString PlantumlManager::computeKey(OutputFormat format,const QCString &puContent) const
+{
+  QCString text = m_settingsHash;
+  text+=static_cast<char>('0'+format);
+  text+=puContent;
+  uchar md5_sig[16];
+  char sigStr[33];
+  MD5Buffer((const unsigned char *)text.data(),text.length(),md5_sig);
+  MD5SigToString(md5_sig,sigStr,33);
+  return sigStr;
+}
+
+static const char *plantumlType(PlantumlManager::OutputFormat format)
+{
+  switch (format)
+  {
+    case PlantumlManager::PUML_BITMAP: return "png";
+    case PlantumlManager::PUML_EPS:    return "eps";
+    case PlantumlManager::PUML_SVG:    return "svg";
   }
-  Debug::print(Debug::Plantuml,0,"*** instance() : m_cachedPlantumlAllContent = [%s]\n",qPrint(m_cachedPlantumlAllContent));
+  return "";
 }
 
-static void runPlantumlContent(const PlantumlManager::FilesMap &plantumlFiles,
+/** Renders the diagrams in \a plantumlContent, returns FALSE if this failed for any of them */
+static bool runPlantumlContent(const PlantumlManager::FilesMap &plantumlFiles,
                                const PlantumlManager::ContentMap &plantumlContent,
-                               PlantumlManager::OutputFormat format)
+                               PlantumlManager::OutputFormat format,
+                               int numThreads)
 {
   /* example : running: java -Djava.awt.headless=true
                -jar "/usr/local/bin/plantuml.jar"
-               -o "test_doxygen/DOXYGEN_OUTPUT/html"
-               -tpng
-               "test_doxygen/DOXYGEN_OUTPUT/html/A.pu"
+               -nbthread 4
                -charset UTF-8
-               outDir:test_doxygen/DOXYGEN_OUTPUT/html
-               test_doxygen/DOXYGEN_OUTPUT/html/A
+               -tpng
+               "test_doxygen/DOXYGEN_OUTPUT/html/inline_umlgraph_pnghtml.pu"
+               "test_doxygen/DOXYGEN_OUTPUT/latex/inline_umlgraph_pnglatex.pu"
+
+     The images are written next to the .pu files, so a single run of java
+     handles all output directories.
    */
+  if (plantumlContent.empty()) return TRUE;
+  bool result = TRUE;
   int exitCode;
   QCString plantumlJarPath = Config_getString(PLANTUML_JAR_PATH);
   QCString plantumlConfigFile = Config_getString(PLANTUML_CFG_FILE);
@@ -156,8 +217,7 @@ static void runPlantumlContent(const PlantumlManager::FilesMap &plantumlFiles,
 
   QCString pumlExe = "java";
   QCString pumlArgs = "";
-  QCString pumlType = "";
-  QCString pumlOutDir = "";
+  QCString pumlType = plantumlType(format);
 
   const StringVector &pumlIncludePathList = Config_getList(PLANTUML_INCLUDE_PATH);
   {
@@ -191,107 +251,130 @@ static void runPlantumlContent(const PlantumlManager::FilesMap &plantumlFiles,
     pumlArgs += Portable::commandExtension();
     pumlArgs += "\" ";
   }
-  switch (format)
+  // let PlantUML render the diagrams on the cores assigned to this run
+  pumlArgs+="-nbthread ";
+  pumlArgs+=numThreads>0 ? QCString().setNum(numThreads) : QCString("auto");
+  pumlArgs+=" -charset UTF-8 -t";
+  pumlArgs+=pumlType;
+  pumlArgs+=" ";
+
+  StringVector puFileNames;
+  for (const auto &kv : plantumlContent)
   {
-    case PlantumlManager::PUML_BITMAP:
-      pumlType="png";
-      break;
-    case PlantumlManager::PUML_EPS:
-      pumlType="eps";
-      break;
-    case PlantumlManager::PUML_SVG:
-      pumlType="svg";
-      break;
+    const PlantumlContent &nb = kv.second;
+    msg("Generating PlantUML %s Files in %s\n",qPrint(pumlType),kv.first.c_str());
+
+    QCString puFileName("");
+    puFileName+=nb.outDir;
+    puFileName+="/";
+    puFileName+="inline_umlgraph_";
+    puFileName+=pumlType;
+    puFileName+=kv.first.c_str();
+    puFileName+=".pu";
+
+    QFile file(puFileName);
+    if (!file.open(IO_WriteOnly))
+    {
+      err("Could not open file %s for writing\n",puFileName.data());
+      result = FALSE;
+      continue;
+    }
+    file.writeBlock( nb.content, nb.content.length() );
+    file.close();
+
+    pumlArgs+="\"";
+    pumlArgs+=puFileName;
+    pumlArgs+="\" ";
+    puFileNames.push_back(puFileName.str());
   }
+  if (puFileNames.empty()) return FALSE;
 
+  Debug::print(Debug::Plantuml,0,"*** %s Running Plantuml arguments:%s\n","PlantumlManager::runPlantumlContent",qPrint(pumlArgs));
+  if ((exitCode=Portable::system(pumlExe,pumlArgs,TRUE))!=0)
   {
-    for (const auto &kv : plantumlContent)
+    err("Problems running PlantUML. Verify that the command 'java -jar \"%splantuml.jar\" -h' works from the command line. Exit code: %d\n",
+        plantumlJarPath.data(),exitCode);
+    result = FALSE;
+  }
+  else if (Config_getBool(DOT_CLEANUP))
+  {
+    for (const auto &puFileName : puFileNames)
     {
-      const PlantumlContent &nb = kv.second;
-      QCString pumlArguments = pumlArgs;
-      msg("Generating PlantUML %s Files in %s\n",qPrint(pumlType),kv.first.c_str());
-      pumlArguments+="-o \"";
-      pumlArguments+=nb.outDir;
-      pumlArguments+="\" ";
-      pumlArguments+="-charset UTF-8 -t";
-      pumlArguments+=pumlType;
-      pumlArguments+=" ";
-
-      QCString puFileName("");
-      puFileName+=nb.outDir;
-      puFileName+="/";
-      pumlOutDir=puFileName;
-      puFileName+="inline_umlgraph_";
-      puFileName+=pumlType;
-      puFileName+=kv.first.c_str();
-      puFileName+=".pu";
-
-      pumlArguments+="\"";
-      pumlArguments+=puFileName;
-      pumlArguments+="\" ";
-
-      QFile file(puFileName);
-      if (!file.open(IO_WriteOnly))
-      {
-        err("Could not open file %s for writing\n",puFileName.data());
-      }
-      file.writeBlock( nb.content, nb.content.length() );
-      file.close();
-      Debug::print(Debug::Plantuml,0,"*** %s Running Plantuml arguments:%s\n","PlantumlManager::runPlantumlContent",qPrint(pumlArguments));
-
-      Portable::sysTimerStart();
-      if ((exitCode=Portable::system(pumlExe,pumlArguments,TRUE))!=0)
-      {
-        err("Problems running PlantUML. Verify that the command 'java -jar \"%splantuml.jar\" -h' works from the command line. Exit code: %d\n",
-            plantumlJarPath.data(),exitCode);
-      }
-      else if (Config_getBool(DOT_CLEANUP))
-      {
-        Debug::print(Debug::Plantuml,0,"*** %s Remove %s file\n","PlantumlManager::runPlantumlContent",qPrint(puFileName));
-        file.remove();
-      }
-      Portable::sysTimerStop();
+      Debug::print(Debug::Plantuml,0,"*** %s Remove %s file\n","PlantumlManager::runPlantumlContent",puFileName.c_str());
+      QFile::remove(puFileName.c_str());
+    }
+  }
 
-      if ( (format==PlantumlManager::PUML_EPS) && (Config_getBool(USE_PDFLATEX)) )
+  if ( (format==PlantumlManager::PUML_EPS) && (Config_getBool(USE_PDFLATEX)) )
+  {
+    Debug::print(Debug::Plantuml,0,"*** %s Running epstopdf\n","PlantumlManager::runPlantumlContent");
+    for (const auto &kv : plantumlContent)
+    {
+      QCString pumlOutDir = kv.second.outDir+"/";
+      auto files_kv = plantumlFiles.find(kv.first);
+      if (files_kv!=plantumlFiles.end())
       {
-        Debug::print(Debug::Plantuml,0,"*** %s Running epstopdf\n","PlantumlManager::runPlantumlContent");
-        auto files_kv = plantumlFiles.find(kv.first);
-        if (files_kv!=plantumlFiles.end())
+        for (const auto &str : files_kv->second)
         {
-          for (const auto &str : files_kv->second)
+          const int maxCmdLine = 40960;
+          QCString epstopdfArgs(maxCmdLine);
+          epstopdfArgs.sprintf("\"%s%s.eps\" --outfile=\"%s%s.pdf\"",
+              pumlOutDir.data(),str.c_str(), pumlOutDir.data(),str.c_str());
+          if ((exitCode=Portable::system("epstopdf",epstopdfArgs))!=0)
           {
-            const int maxCmdLine = 40960;
-            QCString epstopdfArgs(maxCmdLine);
-            epstopdfArgs.sprintf("\"%s%s.eps\" --outfile=\"%s%s.pdf\"",
-                pumlOutDir.data(),str.c_str(), pumlOutDir.data(),str.c_str());
-            Portable::sysTimerStart();
-            if ((exitCode=Portable::system("epstopdf",epstopdfArgs))!=0)
-            {
-              err("Problems running epstopdf. Check your TeX installation! Exit code: %d\n",exitCode);
-            }
-            Portable::sysTimerStop();
+            err("Problems running epstopdf. Check your TeX installation! Exit code: %d\n",exitCode);
+            result = FALSE;
           }
         }
       }
     }
   }
+  return result;
 }
 
 void PlantumlManager::run()
 {
   Debug::print(Debug::Plantuml,0,"*** %s\n","PlantumlManager::run");
-  if (m_currentPlantumlAllContent.isEmpty()) return;
-  runPlantumlContent(m_pngPlantumlFiles, m_pngPlantumlContent, PUML_BITMAP);
-  runPlantumlContent(m_svgPlantumlFiles, m_svgPlantumlContent, PUML_SVG);
-  runPlantumlContent(m_epsPlantumlFiles, m_epsPlantumlContent, PUML_EPS);
+  if (m_currentKeys.empty() && m_pngPendingKeys.empty() &&
+      m_svgPendingKeys.empty() && m_epsPendingKeys.empty()) return;
+
+  // PlantUML renders one output format per run, so the formats are
+  // rendered by concurrent runs that share the available threads
+  std::size_t numProcThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+  if (numProcThreads==0)
+  {
+    numProcThreads = std::thread::hardware_concurrency();
+  }
+  std::size_t numFormats = (m_pngPlantumlContent.empty() ? 0 : 1) +
+                           (m_svgPlantumlContent.empty() ? 0 : 1) +
+                           (m_epsPlantumlContent.empty() ? 0 : 1);
+  std::size_t numRuns = QMAX(QMIN(numProcThreads,numFormats),static_cast<std::size_t>(1));
+  int numThreads = numProcThreads>0 ? static_cast<int>(QMAX(numProcThreads/numRuns,static_cast<std::size_t>(1))) : 0; // 0 = auto
+  Portable::sysTimerStart();
+  {
+    WorkStealingThreadPool threadPool(numRuns);
+    auto png = threadPool.queue([this,numThreads]() { return runPlantumlContent(m_pngPlantumlFiles, m_pngPlantumlContent, PUML_BITMAP, numThreads); });
+    auto svg = threadPool.queue([this,numThreads]() { return runPlantumlContent(m_svgPlantumlFiles, m_svgPlantumlContent, PUML_SVG, numThreads); });
+    auto eps = threadPool.queue([this,numThreads]() { return runPlantumlContent(m_epsPlantumlFiles, m_epsPlantumlContent, PUML_EPS, numThreads); });
+    // only diagrams that were rendered successfully can be reused by the next run
+    if (png.get()) m_currentKeys.insert(m_pngPendingKeys.begin(),m_pngPendingKeys.end());
+    if (svg.get()) m_currentKeys.insert(m_svgPendingKeys.begin(),m_svgPendingKeys.end());
+    if (eps.get()) m_currentKeys.insert(m_epsPendingKeys.begin(),m_epsPendingKeys.end());
+  }
+  Portable::sysTimerStop();
+
   QCString outputFilename = Config_getString(OUTPUT_DIRECTORY) + "/" + CACHE_FILENAME;
   QFile file(outputFilename);
   if (!file.open(IO_WriteOnly))
   {
     err("Could not open file %s for writing\n",CACHE_FILENAME);
+    return;
+  }
+  FTextStream t(&file);
+  for (const auto &key : m_currentKeys)
+  {
+    t << key.c_str() << "\n";
   }
-  file.writeBlock( m_currentPlantumlAllContent, m_currentPlantumlAllContent.length() );
-  file.close();
 }
 
 static void print(const PlantumlManager::FilesMap &plantumlFiles)
@@ -343,37 +426,49 @@ static void addPlantumlContent(PlantumlManager::ContentMap &plantumlContent,
   kv->second.content+=puContent;
 }
 
+// Returns TRUE if the image \a value of format \a format exists in \a outDir
+static bool outputExists(const QCString &outDir,const std::string &value,PlantumlManager::OutputFormat format)
+{
+  QCString baseName = outDir+"/"+value.c_str();
+  if (!QFileInfo(baseName+"."+plantumlType(format)).exists()) return false;
+  return format!=PlantumlManager::PUML_EPS || !Config_getBool(USE_PDFLATEX) ||
+         QFileInfo(baseName+".pdf").exists();
+}
+
 void PlantumlManager::insert(const std::string &key, const std::string &value,
                              const QCString &outDir,OutputFormat format,const QCString &puContent)
 {
-  int find;
-
+  std::lock_guard<std::mutex> lock(m_mutex);
   Debug::print(Debug::Plantuml,0,"*** %s key:%s ,value:%s\n","PlantumlManager::insert",qPrint(key),qPrint(value));
 
-  m_currentPlantumlAllContent+=puContent;
+  std::string hash = computeKey(format,puContent).str();
 
-  find = m_cachedPlantumlAllContent.find(puContent);
-  Debug::print(Debug::Plantuml,0,"*** %s find: %d\n","PlantumlManager::addPlantumlContent",find);
-  if (find >=0)
-  {         // matched in cache. so we skip to run java for this plantuml
+  bool found = m_cachedKeys.find(hash)!=m_cachedKeys.end() && outputExists(outDir,value,format);
+  Debug::print(Debug::Plantuml,0,"*** %s found: %d\n","PlantumlManager::addPlantumlContent",found);
+  if (found)
+  {         // rendered by the previous run and still there, so we skip to run java for this plantuml
+      m_currentKeys.insert(hash);
       return ;
   }
 
   switch (format)
   {
     case PUML_BITMAP:
+      m_pngPendingKeys.insert(hash);
       addPlantumlFiles(m_pngPlantumlFiles,key,value);
       print(m_pngPlantumlFiles);
       addPlantumlContent(m_pngPlantumlContent,key,outDir,puContent);
       print(m_pngPlantumlContent);
       break;
     case PUML_EPS:
+      m_epsPendingKeys.insert(hash);
       addPlantumlFiles(m_epsPlantumlFiles,key,value);
       print(m_epsPlantumlFiles);
       addPlantumlContent(m_epsPlantumlContent,key,outDir,puContent);
       print(m_epsPlantumlContent);
       break;
     case PUML_SVG:
+      m_svgPendingKeys.insert(hash);
       addPlantumlFiles(m_svgPlantumlFiles,key,value);
       print(m_svgPlantumlFiles);
       addPlantumlContent(m_svgPlantumlContent,key,outDir,puContent);
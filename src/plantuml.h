@@ -18,10 +18,11 @@
 
 #include <map>
 #include <string>
+#include <mutex>
 #include "containers.h"
 #include <qcstring.h>
 
-#define CACHE_FILENAME          "inline_umlgraph_cache_all.pu"
+#define CACHE_FILENAME          "inline_umlgraph_cache_all.md5"
 #define DIVIDE_COUNT            4
 #define MIN_PLANTUML_COUNT      8
 
@@ -75,6 +76,7 @@ class PlantumlManager
                 const QCString &outDir,
                 OutputFormat format,
                 const QCString &puContent);
+    QCString computeKey(OutputFormat format,const QCString &puContent) const;
 
     FilesMap   m_pngPlantumlFiles;
     FilesMap   m_svgPlantumlFiles;
@@ -82,8 +84,13 @@ class PlantumlManager
     ContentMap m_pngPlantumlContent;               // use circular queue for using multi-processor (multi threading)
     ContentMap m_svgPlantumlContent;
     ContentMap m_epsPlantumlContent;
-    QCString   m_cachedPlantumlAllContent;         // read from CACHE_FILENAME file
-    QCString   m_currentPlantumlAllContent;        // processing plantuml then write it into CACHE_FILENAME to reuse the next time as cache information
+    StringSet  m_cachedKeys;                       // hashes of the diagrams rendered by the previous run, read from CACHE_FILENAME
+    StringSet  m_currentKeys;                      // hashes of the diagrams of this run, written to CACHE_FILENAME to reuse the next time
+    StringSet  m_pngPendingKeys;                   // hashes of the diagrams still to be rendered, added to
+    StringSet  m_svgPendingKeys;                   // m_currentKeys once PlantUML rendered them successfully
+    StringSet  m_epsPendingKeys;
+    QCString   m_settingsHash;                     // hash of the settings that influence rendering, part of each key
+    std::mutex m_mutex;                            // protects the above when documentation is generated using multiple threads
 };
 
 #endif
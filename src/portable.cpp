@@ -12,6 +12,9 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <errno.h>
 extern char **environ;
 #endif
@@ -513,6 +516,81 @@ void Portable::unlink(const char *fileName)
 #endif
 }
 
+/** Renames \a oldName to \a newName, replacing \a newName if it exists. */
+bool Portable::rename(const char *oldName,const char *newName)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  // unlike on POSIX systems, rename() fails here if the target exists
+  return MoveFileExA(oldName,newName,MOVEFILE_REPLACE_EXISTING)!=0;
+#else
+  return ::rename(oldName,newName)==0;
+#endif
+}
+
+bool Portable::hardLink(const char *existingFile,const char *newFile)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  return CreateHardLinkA(newFile,existingFile,NULL)!=0;
+#else
+  return ::link(existingFile,newFile)==0;
+#endif
+}
+
+/** Maps the file \a fileName read-only into memory and returns a pointer to
+ *  its contents, or 0 if the file cannot be mapped or is empty. The size of
+ *  the file is returned in \a size. The mapping must be released with unmapFile().
+ */
+const char *Portable::mapFile(const char *fileName,size_t &size)
+{
+  size=0;
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  HANDLE file = CreateFileA(fileName,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+  if (file==INVALID_HANDLE_VALUE) return 0;
+  LARGE_INTEGER fileSize;
+  const char *data = 0;
+  if (GetFileSizeEx(file,&fileSize) && fileSize.QuadPart>0 &&
+      static_cast<unsigned long long>(fileSize.QuadPart)<=static_cast<size_t>(-1))
+  {
+    HANDLE mapping = CreateFileMappingA(file,NULL,PAGE_READONLY,0,0,NULL);
+    if (mapping!=NULL)
+    {
+      data = static_cast<const char *>(MapViewOfFile(mapping,FILE_MAP_READ,0,0,0));
+      if (data) size = static_cast<size_t>(fileSize.QuadPart);
+      CloseHandle(mapping); // the view keeps the mapping alive
+    }
+  }
+  CloseHandle(file);
+  return data;
+#else
+  int fd = ::open(fileName,O_RDONLY);
+  if (fd<0) return 0;
+  struct stat st;
+  const char *data = 0;
+  if (fstat(fd,&st)==0 && st.st_size>0)
+  {
+    void *p = mmap(0,static_cast<size_t>(st.st_size),PROT_READ,MAP_PRIVATE,fd,0);
+    if (p!=MAP_FAILED)
+    {
+      data = static_cast<const char *>(p);
+      size = static_cast<size_t>(st.st_size);
+    }
+  }
+  ::close(fd);
+  return data;
+#endif
+}
+
+void Portable::unmapFile(const char *data,size_t size)
+{
+  if (data==0) return;
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  (void)size;
+  UnmapViewOfFile(data);
+#else
+  munmap(const_cast<char *>(data),size);
+#endif
+}
+
 void Portable::setShortDir()
 {
 #if defined(_WIN32) && !defined(__CYGWIN__)
@@ -28,6 +28,10 @@ namespace Portable
   portable_off_t ftell(FILE *f);
   FILE *         fopen(const char *fileName,const char *mode);
   void           unlink(const char *fileName);
+  bool           rename(const char *oldName,const char *newName);
+  bool           hardLink(const char *existingFile,const char *newFile);
+  const char *   mapFile(const char *fileName,size_t &size);
+  void           unmapFile(const char *data,size_t size);
   char           pathSeparator();
   char           pathListSeparator();
   const char *   ghostScriptCommand();
@@ -324,14 +324,8 @@ void RTFDocVisitor::visit(DocVerbatim *s)
       break;
     case DocVerbatim::Dot:
       {
-        static int dotindex = 1;
-        QCString fileName(4096);
-
-        fileName.sprintf("%s%d%s",
-            (Config_getString(RTF_OUTPUT)+"/inline_dotgraph_").data(),
-            dotindex++,
-            ".dot"
-           );
+        static AtomicInt dotindex(1);
+        QCString fileName = Config_getString(RTF_OUTPUT)+"/"+inlineGraphName("inline_dotgraph_",dotindex)+".dot";
         QFile file(fileName);
         if (!file.open(IO_WriteOnly))
         {
@@ -349,14 +343,8 @@ void RTFDocVisitor::visit(DocVerbatim *s)
       break;
     case DocVerbatim::Msc:
       {
-        static int mscindex = 1;
-        QCString baseName(4096);
-
-        baseName.sprintf("%s%d%s",
-            (Config_getString(RTF_OUTPUT)+"/inline_mscgraph_").data(),
-            mscindex++,
-            ".msc"
-           );
+        static AtomicInt mscindex(1);
+        QCString baseName = Config_getString(RTF_OUTPUT)+"/"+inlineGraphName("inline_mscgraph_",mscindex)+".msc";
         QFile file(baseName);
         if (!file.open(IO_WriteOnly))
         {
@@ -37,6 +37,8 @@ class COutlineParser : public OutlineParserInterface
                     ClangTUParser *clangParser);
     bool needsPreprocessing(const QCString &extension) const;
     void parsePrototype(const char *text);
+    bool supportsParseCache() const;
+    void skipInput(const char *fileName);
   private:
     struct Private;
     std::unique_ptr<Private> p;
@@ -16,6 +16,8 @@
 
 #include <ctype.h>
 #include <assert.h>
+#include <algorithm>
+#include <string>
 
 #include <qfile.h>
 #include <qregexp.h>
@@ -42,19 +44,31 @@
 // the following part is for the server based search engine
 //---------------------------------------------------------------------------------------------
 
-// file format: (all multi-byte values are stored in big endian format)
-//   4 byte header
-//   256*256*4 byte index (4 bytes)
-//   for each index entry: a zero terminated list of words
-//   for each word: a \0 terminated string + 4 byte offset to the stats info
-//   padding bytes to align at 4 byte boundary
-//   for each word: the number of urls (4 bytes)
-//               + for each url containing the word 8 bytes statistics
-//                 (4 bytes index to url string + 4 bytes frequency counter)
-//   for each url: a \0 terminated string
+// file format: (fixed size values are stored as 4 byte big endian numbers, variable
+// size values (vint) as groups of 7 bits, least significant group first, with the
+// high bit set in all but the last byte)
+//   4 byte header "DOXC"
+//   4 byte number of urls
+//   4 byte offset of the url table
+//   256*256*4 byte index: for each pair of leading characters the offset of the word list or 0
+//   for each non empty index entry a word list:
+//     4 byte offset of the postings of the first word
+//     vint number of words, followed for each word in sorted order by
+//       vint length of the prefix shared with the previous word in the list
+//       vint length of the remaining characters + the characters
+//       vint offset of the postings of the word relative to the ones of the previous word
+//   for each word the postings: vint number of urls, followed for each url
+//     containing the word, in order of increasing url index, by
+//       vint difference of the url index with the previous one
+//       vint frequency counter (bit 0 is set for high priority documents)
+//   the url table: 4 byte offset of the strings for each url index
+//   for each url: a \0 terminated name followed by a \0 terminated url
 
 const size_t numIndexEntries = 256*256;
 
+// maximum number of symbols in a data file of the JavaScript search index
+const size_t maxShardEntries = 2000;
+
 //--------------------------------------------------------------------
 
 IndexWord::IndexWord(QCString word) : m_word(word)
@@ -84,6 +98,8 @@ SearchIndex::SearchIndex() : SearchIndexIntf(Internal)
 
 void SearchIndex::setCurrentDoc(const Definition *ctx,const char *anchor,bool isSourceFile)
 {
+  SearchIndexRecorder *recorder = SearchIndexRecorder::active();
+  if (recorder) { recorder->setCurrentDoc(ctx,anchor,isSourceFile); return; }
   if (ctx==0) return;
   assert(!isSourceFile || ctx->definitionType()==Definition::TypeFile);
   //printf("SearchIndex::setCurrentDoc(%s,%s,%s)\n",name,baseName,anchor);
@@ -236,150 +252,141 @@ void SearchIndex::addWord(const char *word,bool hiPriority,bool recurse)
 
 void SearchIndex::addWord(const char *word,bool hiPriority)
 {
+  SearchIndexRecorder *recorder = SearchIndexRecorder::active();
+  if (recorder) { recorder->addWord(word,hiPriority); return; }
   addWord(word,hiPriority,FALSE);
 }
 
-static void writeInt(QFile &f,size_t index)
+static void writeInt(std::string &buf,size_t index)
 {
-  f.putch(static_cast<int>(index>>24));
-  f.putch(static_cast<int>((index>>16)&0xff));
-  f.putch(static_cast<int>((index>>8)&0xff));
-  f.putch(static_cast<int>(index&0xff));
+  buf+=static_cast<char>(index>>24);
+  buf+=static_cast<char>((index>>16)&0xff);
+  buf+=static_cast<char>((index>>8)&0xff);
+  buf+=static_cast<char>(index&0xff);
 }
 
-static void writeString(QFile &f,const char *s)
+static void patchInt(std::string &buf,size_t pos,size_t index)
 {
-  const char *p = s;
-  while (*p) f.putch(*p++);
-  f.putch(0);
+  buf[pos]  =static_cast<char>(index>>24);
+  buf[pos+1]=static_cast<char>((index>>16)&0xff);
+  buf[pos+2]=static_cast<char>((index>>8)&0xff);
+  buf[pos+3]=static_cast<char>(index&0xff);
 }
 
-void SearchIndex::write(const char *fileName)
+static void writeVInt(std::string &buf,size_t value)
 {
-  size_t i;
-  size_t size=4; // for the header
-  size+=4*numIndexEntries; // for the index
-  size_t wordsOffset = size;
-  // first pass: compute the size of the wordlist
-  for (i=0;i<numIndexEntries;i++)
+  while (value>=0x80)
   {
-    const auto &wlist = m_index[i];
-    if (!wlist.empty())
-    {
-      for (const auto &iw : wlist)
-      {
-        int ws = iw.word().length()+1;
-        size+=ws+4; // word + url info list offset
-      }
-      size+=1; // zero list terminator
-    }
+    buf+=static_cast<char>((value&0x7f)|0x80);
+    value>>=7;
   }
+  buf+=static_cast<char>(value);
+}
+
+static void writeString(std::string &buf,const QCString &s)
+{
+  buf.append(s.data(),s.length());
+  buf+='\0';
+}
 
-  // second pass: compute the offsets in the index
-  size_t indexOffsets[numIndexEntries];
-  size_t offset=wordsOffset;
-  for (i=0;i<numIndexEntries;i++)
+void SearchIndex::write(const char *fileName)
+{
+  const size_t headerSize = 12+4*numIndexEntries;
+  std::string words;    // the word lists
+  std::string postings; // the postings of all words
+  std::vector<size_t> indexOffsets(numIndexEntries,0);
+  std::vector<size_t> postingsBases;  // per word list: position of the postings base in words
+  std::vector<size_t> postingsStarts; // per word list: offset of its postings in postings
+  std::vector<const IndexWord*> sortedWords;
+  std::vector<const URLInfo*> sortedUrls;
+  for (size_t i=0;i<numIndexEntries;i++)
   {
     const auto &wlist = m_index[i];
-    if (!wlist.empty())
+    if (wlist.empty()) continue;
+
+    sortedWords.clear();
+    for (const auto &iw : wlist) sortedWords.push_back(&iw);
+    std::sort(sortedWords.begin(),sortedWords.end(),
+        [](const IndexWord *w1,const IndexWord *w2) { return qstrcmp(w1->word(),w2->word())<0; });
+
+    indexOffsets[i]=headerSize+words.size();
+    postingsBases.push_back(words.size());
+    postingsStarts.push_back(postings.size());
+    writeInt(words,0); // patched once the location of the postings is known
+    writeVInt(words,sortedWords.size());
+    const char *prevWord = "";
+    size_t prevPostings = postings.size();
+    for (const IndexWord *iw : sortedWords)
     {
-      indexOffsets[i]=offset;
-      for (const auto &iw : wlist)
+      // front coding: only store the part that differs from the previous word
+      const QCString &word = iw->word();
+      size_t prefix=0;
+      while (prevWord[prefix]!=0 && prevWord[prefix]==word.data()[prefix]) prefix++;
+      writeVInt(words,prefix);
+      writeVInt(words,word.length()-prefix);
+      words.append(word.data()+prefix,word.length()-prefix);
+      writeVInt(words,postings.size()-prevPostings);
+      prevWord = word.data();
+      prevPostings = postings.size();
+
+      sortedUrls.clear();
+      for (const auto &ui : iw->urls())
       {
-        offset+= iw.word().length()+1;
-        offset+=4; // word + offset to url info array
+        if (ui.second.urlIdx>=0) sortedUrls.push_back(&ui.second);
+      }
+      std::sort(sortedUrls.begin(),sortedUrls.end(),
+          [](const URLInfo *u1,const URLInfo *u2) { return u1->urlIdx<u2->urlIdx; });
+      writeVInt(postings,sortedUrls.size());
+      int prevIdx = 0;
+      for (const URLInfo *ui : sortedUrls)
+      {
+        writeVInt(postings,static_cast<size_t>(ui->urlIdx-prevIdx));
+        writeVInt(postings,static_cast<size_t>(ui->freq));
+        prevIdx = ui->urlIdx;
       }
-      offset+=1; // zero list terminator
-    }
-    else
-    {
-      indexOffsets[i]=0;
     }
   }
-  size_t padding = size;
-  size = (size+3)&~3; // round up to 4 byte boundary
-  padding = size - padding;
 
-  std::vector<size_t> wordStatOffsets(m_words.size());
-
-  int count=0;
+  size_t postingsOffset = headerSize+words.size();
+  for (size_t i=0;i<postingsBases.size();i++)
+  {
+    patchInt(words,postingsBases[i],postingsOffset+postingsStarts[i]);
+  }
 
-  // third pass: compute offset to stats info for each word
-  for (i=0;i<numIndexEntries;i++)
+  size_t urlTableOffset = postingsOffset+postings.size();
+  std::string urls;
+  size_t urlOffset = urlTableOffset+4*m_urls.size();
+  for (const auto &udi : m_urls)
   {
-    const auto &wlist = m_index[i];
-    if (!wlist.empty())
-    {
-      for (const auto &iw : wlist)
-      {
-        //printf("wordStatOffsets[%d]=%d\n",count,size);
-        wordStatOffsets[count++] = size;
-        size+=4 + iw.urls().size() * 8; // count + (url_index,freq) per url
-      }
-    }
+    writeInt(urls,urlOffset);
+    urlOffset+=udi.second.name.length()+1+udi.second.url.length()+1;
   }
-  std::vector<size_t> urlOffsets(m_urls.size());
   for (const auto &udi : m_urls)
   {
-    urlOffsets[udi.first]=size;
-    size+=udi.second.name.length()+1+
-          udi.second.url.length()+1;
+    writeString(urls,udi.second.name);
+    writeString(urls,udi.second.url);
+  }
+
+  std::string header = "DOXC";
+  writeInt(header,m_urls.size());
+  writeInt(header,urlTableOffset);
+  for (size_t i=0;i<numIndexEntries;i++)
+  {
+    writeInt(header,indexOffsets[i]);
   }
 
-  //printf("Total size %x bytes (word=%x stats=%x urls=%x)\n",size,wordsOffset,statsOffset,urlsOffset);
   QFile f(fileName);
   if (f.open(IO_WriteOnly))
   {
-    // write header
-    f.putch('D'); f.putch('O'); f.putch('X'); f.putch('S');
-    // write index
-    for (i=0;i<numIndexEntries;i++)
-    {
-      writeInt(f,indexOffsets[i]);
-    }
-    // write word lists
-    count=0;
-    for (i=0;i<numIndexEntries;i++)
-    {
-      const auto &wlist = m_index[i];
-      if (!wlist.empty())
-      {
-        for (const auto &iw : wlist)
-        {
-          writeString(f,iw.word());
-          writeInt(f,wordStatOffsets[count++]);
-        }
-        f.putch(0);
-      }
-    }
-    // write extra padding bytes
-    for (i=0;i<padding;i++) f.putch(0);
-    // write word statistics
-    for (i=0;i<numIndexEntries;i++)
-    {
-      const auto &wlist = m_index[i];
-      if (!wlist.empty())
-      {
-        for (const auto &iw : wlist)
-        {
-          size_t numUrls = iw.urls().size();
-          writeInt(f,numUrls);
-          for (const auto &ui : iw.urls())
-          {
-            writeInt(f,urlOffsets[ui.second.urlIdx]);
-            writeInt(f,ui.second.freq);
-          }
-        }
-      }
-    }
-    // write urls
-    for (const auto &udi : m_urls)
-    {
-      writeString(f,udi.second.name);
-      writeString(f,udi.second.url);
-    }
+    f.writeBlock(header.data(),header.size());
+    f.writeBlock(words.data(),words.size());
+    f.writeBlock(postings.data(),postings.size());
+    f.writeBlock(urls.data(),urls.size());
+  }
+  else
+  {
+    err("Could not open file %s for writing\n",fileName);
   }
-
 }
 
 
@@ -464,6 +471,8 @@ static QCString definitionToName(const Definition *ctx)
 
 void SearchIndexExternal::setCurrentDoc(const Definition *ctx,const char *anchor,bool isSourceFile)
 {
+  SearchIndexRecorder *recorder = SearchIndexRecorder::active();
+  if (recorder) { recorder->setCurrentDoc(ctx,anchor,isSourceFile); return; }
   static QCString extId = stripPath(Config_getString(EXTERNAL_SEARCH_ID));
   QCString baseName = isSourceFile ? (toFileDef(ctx))->getSourceFileBase() : ctx->getOutputFileBase();
   QCString url = baseName + Doxygen::htmlFileExtension;
@@ -490,6 +499,8 @@ void SearchIndexExternal::setCurrentDoc(const Definition *ctx,const char *anchor
 
 void SearchIndexExternal::addWord(const char *word,bool hiPriority)
 {
+  SearchIndexRecorder *recorder = SearchIndexRecorder::active();
+  if (recorder) { recorder->addWord(word,hiPriority); return; }
   if (word==0 || !isId(*word) || p->current==0) return;
   GrowBuf *pText = hiPriority ? &p->current->importantText : &p->current->normalText;
   if (pText->getPos()>0) pText->addChar(' ');
@@ -534,6 +545,47 @@ void SearchIndexExternal::write(const char *fileName)
   }
 }
 
+//---------------------------------------------------------------------------------------------
+
+static THREAD_LOCAL SearchIndexRecorder *g_activeRecorder = 0;
+
+void SearchIndexRecorder::setCurrentDoc(const Definition *ctx,const char *anchor,bool isSourceFile)
+{
+  m_items.emplace_back(ctx,anchor,isSourceFile);
+}
+
+void SearchIndexRecorder::addWord(const char *word,bool hiPriority)
+{
+  m_items.emplace_back(word,hiPriority);
+}
+
+void SearchIndexRecorder::replay(SearchIndexIntf *searchIndex) const
+{
+  if (searchIndex==0) return;
+  for (const auto &item : m_items)
+  {
+    const char *text = item.isNull ? 0 : item.text.data();
+    if (item.isWord)
+    {
+      searchIndex->addWord(text,item.flag);
+    }
+    else
+    {
+      searchIndex->setCurrentDoc(item.ctx,text,item.flag);
+    }
+  }
+}
+
+void SearchIndexRecorder::setActive(SearchIndexRecorder *recorder)
+{
+  g_activeRecorder = recorder;
+}
+
+SearchIndexRecorder *SearchIndexRecorder::active()
+{
+  return g_activeRecorder;
+}
+
 //---------------------------------------------------------------------------------------------
 // the following part is for the javascript based search engine
 //---------------------------------------------------------------------------------------------
@@ -896,6 +948,387 @@ void createJavaScriptSearchIndex()
   }
 }
 
+/** A link to one of the symbols that share a search name */
+struct SearchDataChild
+{
+  QCString url;          // file name, including the path for external references
+  QCString anchor;
+  bool     parentTarget; // open the link in the parent frame
+  QCString scope;        // text shown next to or instead of the name
+};
+
+/** The data of a search name in a JavaScript search data file */
+struct SearchDataEntry
+{
+  QCString id;
+  QCString name;
+  std::vector<SearchDataChild> children;
+};
+
+// Groups the symbols in \a list, which is sorted by search name, by their
+// search name and determines the links and texts shown in the search results.
+static void collectSearchData(const std::vector<const Definition*> &list,std::vector<SearchDataEntry> &entries)
+{
+  static bool extLinksInWindow = Config_getBool(EXT_LINKS_IN_WINDOW);
+  QCString lastName;
+  const Definition *prevScope = 0;
+  for (auto it = list.begin(); it!=list.end();)
+  {
+    const Definition *d = *it;
+    QCString sname = searchName(d);
+
+    if (entries.empty() || sname!=lastName) // this item has a different search word
+    {
+      entries.push_back(SearchDataEntry());
+      entries.back().id   = searchId(d);
+      entries.back().name = convertToXML(sname);
+      prevScope=0;
+    }
+
+    ++it;
+    const Definition *scope     = d->getOuterScope();
+    const Definition *next      = it!=list.end() ? *it : 0;
+    const Definition *nextScope = 0;
+    const MemberDef  *md        = toMemberDef(d);
+    if (next) nextScope = next->getOuterScope();
+
+    SearchDataChild child;
+    child.url          = externalRef("../",d->getReference(),TRUE)+
+                         addHtmlExtensionIfMissing(d->getOutputFileBase());
+    child.anchor       = d->anchor();
+    child.parentTarget = !extLinksInWindow || d->getReference().isEmpty();
+
+    if (lastName!=sname && (next==0 || searchName(next)!=sname)) // unique name
+    {
+      if (d->getOuterScope()!=Doxygen::globalScope)
+      {
+        child.scope = convertToXML(d->getOuterScope()->name());
+      }
+      else if (md)
+      {
+        const FileDef *fd = md->getBodyDef();
+        if (fd==0) fd = md->getFileDef();
+        if (fd)
+        {
+          child.scope = convertToXML(fd->localName());
+        }
+      }
+    }
+    else // multiple entries with the same name
+    {
+      bool found=FALSE;
+      bool overloadedFunction = ((prevScope!=0 && scope==prevScope) ||
+          (scope && scope==nextScope)) && md && (md->isFunction() || md->isSlot());
+      QCString prefix;
+      if (md) prefix=convertToXML(md->localName());
+      if (overloadedFunction) // overloaded member function
+      {
+        prefix+=convertToXML(md->argsString());
+        // show argument list to disambiguate overloaded functions
+      }
+      else if (md) // unique member function
+      {
+        prefix+="()"; // only to show it is a function
+      }
+      QCString name;
+      if (d->definitionType()==Definition::TypeClass)
+      {
+        name = convertToXML((toClassDef(d))->displayName());
+        found = TRUE;
+      }
+      else if (d->definitionType()==Definition::TypeNamespace)
+      {
+        name = convertToXML((toNamespaceDef(d))->displayName());
+        found = TRUE;
+      }
+      else if (scope==0 || scope==Doxygen::globalScope) // in global scope
+      {
+        if (md)
+        {
+          const FileDef *fd = md->getBodyDef();
+          if (fd==0) fd = md->resolveAlias()->getFileDef();
+          if (fd)
+          {
+            if (!prefix.isEmpty()) prefix+=":&#160;";
+            name = prefix + convertToXML(fd->localName());
+            found = TRUE;
+          }
+        }
+      }
+      else if (md && (md->resolveAlias()->getClassDef() || md->resolveAlias()->getNamespaceDef()))
+        // member in class or namespace scope
+      {
+        SrcLangExt lang = md->getLanguage();
+        name = convertToXML(d->getOuterScope()->qualifiedName())
+          + getLanguageSpecificSeparator(lang) + prefix;
+        found = TRUE;
+      }
+      else if (scope) // some thing else? -> show scope
+      {
+        name = prefix + convertToXML(scope->name());
+        found = TRUE;
+      }
+      if (!found) // fallback
+      {
+        name = prefix + "("+theTranslator->trGlobalNamespace()+")";
+      }
+      child.scope = name;
+
+      prevScope = scope;
+    }
+    entries.back().children.push_back(child);
+    lastName = sname;
+  }
+}
+
+// Writes the array with the search data of the symbols in \a list, the
+// entries are numbered starting at \a cnt.
+static void writeSearchData(FTextStream &ti,const std::vector<const Definition*> &list,int &cnt)
+{
+  // format
+  // searchData[] = array of items
+  // searchData[x][0] = id
+  // searchData[x][1] = [ name + child1 + child2 + .. ]
+  // searchData[x][1][0] = name as shown
+  // searchData[x][1][y+1] = info for child y
+  // searchData[x][1][y+1][0] = url
+  // searchData[x][1][y+1][1] = 1 => target="_parent"
+  // searchData[x][1][y+1][2] = scope
+  std::vector<SearchDataEntry> entries;
+  collectSearchData(list,entries);
+  ti << "[" << endl;
+  bool firstEntry=TRUE;
+  for (const auto &entry : entries)
+  {
+    if (!firstEntry)
+    {
+      ti << "," << endl;
+    }
+    firstEntry=FALSE;
+    ti << "  ['" << entry.id << "_" << cnt++ << "',['" << entry.name << "',[";
+    bool firstChild=TRUE;
+    for (const auto &child : entry.children)
+    {
+      if (!firstChild)
+      {
+        ti << "],[";
+      }
+      firstChild=FALSE;
+      ti << "'" << child.url;
+      if (!child.anchor.isEmpty())
+      {
+        ti << "#" << child.anchor;
+      }
+      ti << "'," << (child.parentTarget ? "1" : "0") << ",'" << child.scope << "'";
+    }
+    ti << "]]]";
+  }
+  if (!firstEntry)
+  {
+    ti << endl;
+  }
+  ti << "]";
+}
+
+// Writes the search data of the symbols in \a list, with entries numbered
+// starting at \a cnt, in the compact format of the shards, which
+// addSearchShard() in search.js expands into the format of writeSearchData().
+static void writeCompactSearchData(FTextStream &ti,const std::vector<const Definition*> &list,int &cnt)
+{
+  // format
+  // c = number of the first entry
+  // f[] = the files linked to, f[x][0] = url, f[x][1] = 1 => target="_parent"
+  // s[] = the scope texts
+  // e[] = array of items
+  // e[x][0] = length of the prefix the id shares with the id of entry x-1
+  // e[x][1] = rest of the id
+  // e[x][2] = name as shown
+  // e[x][3+3*y] = index in f[] of child y
+  // e[x][4+3*y] = anchor of child y
+  // e[x][5+3*y] = index in s[] of the scope of child y
+  std::vector<SearchDataEntry> entries;
+  collectSearchData(list,entries);
+
+  std::map<std::string,int> fileIndex, scopeIndex;
+  std::vector<const SearchDataChild*> files;
+  std::vector<QCString> scopes;
+  for (const auto &entry : entries)
+  {
+    for (const auto &child : entry.children)
+    {
+      std::string fileKey = (child.parentTarget ? "1" : "0")+child.url.str();
+      if (fileIndex.insert(std::make_pair(fileKey,static_cast<int>(files.size()))).second)
+      {
+        files.push_back(&child);
+      }
+      if (scopeIndex.insert(std::make_pair(child.scope.str(),static_cast<int>(scopes.size()))).second)
+      {
+        scopes.push_back(child.scope);
+      }
+    }
+  }
+
+  ti << "{c:" << cnt << "," << endl;
+  ti << "f:[";
+  for (size_t i=0;i<files.size();i++)
+  {
+    ti << (i>0 ? "," : "") << "['" << files[i]->url << "'," << (files[i]->parentTarget ? "1" : "0") << "]";
+  }
+  ti << "]," << endl;
+  ti << "s:[";
+  for (size_t i=0;i<scopes.size();i++)
+  {
+    ti << (i>0 ? "," : "") << "'" << scopes[i] << "'";
+  }
+  ti << "]," << endl;
+  ti << "e:[" << endl;
+  QCString prevId;
+  for (size_t i=0;i<entries.size();i++)
+  {
+    const SearchDataEntry &entry = entries[i];
+    uint common=0;
+    while (common<prevId.length() && common<entry.id.length() && prevId.at(common)==entry.id.at(common)) common++;
+    ti << "[" << common << ",'" << entry.id.mid(common) << "','" << entry.name << "'";
+    for (const auto &child : entry.children)
+    {
+      std::string fileKey = (child.parentTarget ? "1" : "0")+child.url.str();
+      ti << "," << fileIndex[fileKey] << ",'" << child.anchor << "'," << scopeIndex[child.scope.str()];
+    }
+    ti << "]" << (i+1<entries.size() ? "," : "") << endl;
+    prevId = entry.id;
+    cnt++;
+  }
+  ti << "]}";
+}
+
+// Returns the number of bytes of the character at position \a pos of search id \a id,
+// where an escaped character (_xx) counts as one.
+static size_t searchIdCharLength(const std::string &id,size_t pos)
+{
+  uchar c = static_cast<uchar>(id[pos]);
+  size_t len = c=='_' ? 3 : c>=0xF0 ? 4 : c>=0xE0 ? 3 : c>=0xC0 ? 2 : 1;
+  return QMIN(len,id.length()-pos);
+}
+
+using SearchShardMap = std::map< std::string, std::vector<const Definition*> >;
+
+// Splits the symbols in \a list, whose search ids all start with \a prefix, into
+// shards of at most maxShardEntries symbols, using longer prefixes of the search ids.
+static void splitSearchShards(const std::string &prefix,const std::vector<const Definition*> &list,
+                              SearchShardMap &shards)
+{
+  if (list.size()<=maxShardEntries)
+  {
+    shards.insert(std::make_pair(prefix,list));
+    return;
+  }
+  SearchShardMap groups;
+  for (const Definition *d : list)
+  {
+    std::string id = searchId(d).str();
+    std::string key = id.length()>prefix.length() ?
+                      id.substr(0,prefix.length()+searchIdCharLength(id,prefix.length())) :
+                      id;
+    groups[key].push_back(d);
+  }
+  for (const auto &kv : groups)
+  {
+    if (kv.first.length()>prefix.length())
+    {
+      splitSearchShards(kv.first,kv.second,shards);
+    }
+    else // symbols whose search id is the prefix itself cannot be split further
+    {
+      shards.insert(kv);
+    }
+  }
+}
+
+// Writes the page that shows the search results for the data in \a baseName.js,
+// or, if \a shardKeys is not empty, in the shards \a baseName_<n>.js of which
+// only the ones matching the search are loaded.
+static void writeSearchResultsPage(const QCString &fileName,const QCString &baseName,const StringVector &shardKeys)
+{
+  QFile outFile(fileName);
+  if (!outFile.open(IO_WriteOnly))
+  {
+    err("Failed to open file '%s' for writing...\n",fileName.data());
+    return;
+  }
+  FTextStream t(&outFile);
+
+  t << "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Transitional//EN\""
+    " \"https://www.w3.org/TR/xhtml1/DTD/xhtml1-transitional.dtd\">" << endl;
+  t << "<html xmlns=\"http://www.w3.org/1999/xhtml\">" << endl;
+  t << "<head><title></title>" << endl;
+  t << "<meta http-equiv=\"Content-Type\" content=\"text/xhtml;charset=UTF-8\"/>" << endl;
+  t << "<meta name=\"generator\" content=\"Doxygen " << getDoxygenVersion() << "\"/>" << endl;
+  t << "<link rel=\"stylesheet\" type=\"text/css\" href=\"search.css\"/>" << endl;
+  if (shardKeys.empty())
+  {
+    t << "<script type=\"text/javascript\" src=\"" << baseName << ".js\"></script>" << endl;
+  }
+  t << "<script type=\"text/javascript\" src=\"search.js\"></script>" << endl;
+  t << "</head>" << endl;
+  t << "<body class=\"SRPage\">" << endl;
+  t << "<div id=\"SRIndex\">" << endl;
+  t << "<div class=\"SRStatus\" id=\"Loading\">" << theTranslator->trLoading() << "</div>" << endl;
+  t << "<div id=\"SRResults\"></div>" << endl; // here the results will be inserted
+  if (shardKeys.empty())
+  {
+    t << "<script type=\"text/javascript\">" << endl;
+    t << "/* @license magnet:?xt=urn:btih:cf05388f2679ee054f2beb29a391d25f4e673ac3&amp;dn=gpl-2.0.txt GPL-v2 */\n";
+    t << "createResults();" << endl; // this function will insert the results
+    t << "/* @license-end */\n";
+    t << "</script>" << endl;
+  }
+  t << "<div class=\"SRStatus\" id=\"Searching\">"
+    << theTranslator->trSearching() << "</div>" << endl;
+  t << "<div class=\"SRStatus\" id=\"NoMatches\">"
+    << theTranslator->trNoMatches() << "</div>" << endl;
+
+  t << "<script type=\"text/javascript\">" << endl;
+  t << "/* @license magnet:?xt=urn:btih:cf05388f2679ee054f2beb29a391d25f4e673ac3&amp;dn=gpl-2.0.txt GPL-v2 */\n";
+  t << "var searchResults = new SearchResults(\"searchResults\");" << endl;
+  t << "function showResults() {" << endl;
+  t << "  document.getElementById(\"Loading\").style.display=\"none\";" << endl;
+  t << "  document.getElementById(\"NoMatches\").style.display=\"none\";" << endl;
+  t << "  searchResults.Search();" << endl;
+  t << "}" << endl;
+  if (shardKeys.empty())
+  {
+    t << "showResults();" << endl;
+  }
+  else
+  {
+    // the search id prefix of the symbols in each shard
+    t << "var searchShards = [";
+    bool first=TRUE;
+    for (const auto &key : shardKeys)
+    {
+      if (!first) t << ",";
+      t << "'" << key.c_str() << "'";
+      first=FALSE;
+    }
+    t << "];" << endl;
+    t << "loadSearchShards(\"" << baseName << "\",searchShards,function() {" << endl;
+    t << "  createResults();" << endl;
+    t << "  showResults();" << endl;
+    t << "});" << endl;
+  }
+  t << "window.addEventListener(\"message\", function(event) {" << endl;
+  t << "  if (event.data == \"take_focus\") {" << endl;
+  t << "    var elem = searchResults.NavNext(0);" << endl;
+  t << "    if (elem) elem.focus();" << endl;
+  t << "  }" << endl;
+  t << "});" << endl;
+  t << "/* @license-end */\n";
+  t << "</script>" << endl;
+  t << "</div>" << endl; // SRIndex
+  t << "</body>" << endl;
+  t << "</html>" << endl;
+}
+
 void writeJavaScriptSearchIndex()
 {
   int cnt = 0;
@@ -911,221 +1344,56 @@ void writeJavaScriptSearchIndex()
       baseName.sprintf("%s_%x",sii.name.data(),p);
 
       QCString fileName = searchDirName + "/"+baseName+Doxygen::htmlFileExtension;
-      QCString dataFileName = searchDirName + "/"+baseName+".js";
 
-      QFile outFile(fileName);
-      QFile dataOutFile(dataFileName);
-      if (outFile.open(IO_WriteOnly) && dataOutFile.open(IO_WriteOnly))
+      // large lists are split into shards by a longer prefix, so the browser
+      // only needs to load and parse the symbols that can match the search
+      SearchShardMap shards;
+      splitSearchShards(std::string(),kv.second,shards);
+      StringVector shardKeys;
+      if (shards.size()>1)
+      {
+        for (const auto &skv : shards) shardKeys.push_back(skv.first);
+      }
+
+      writeSearchResultsPage(fileName,baseName,shardKeys);
+
+      if (shardKeys.empty())
       {
+        QCString dataFileName = searchDirName + "/"+baseName+".js";
+        QFile dataOutFile(dataFileName);
+        if (dataOutFile.open(IO_WriteOnly))
         {
-          FTextStream t(&outFile);
-
-          t << "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Transitional//EN\""
-            " \"https://www.w3.org/TR/xhtml1/DTD/xhtml1-transitional.dtd\">" << endl;
-          t << "<html xmlns=\"http://www.w3.org/1999/xhtml\">" << endl;
-          t << "<head><title></title>" << endl;
-          t << "<meta http-equiv=\"Content-Type\" content=\"text/xhtml;charset=UTF-8\"/>" << endl;
-          t << "<meta name=\"generator\" content=\"Doxygen " << getDoxygenVersion() << "\"/>" << endl;
-          t << "<link rel=\"stylesheet\" type=\"text/css\" href=\"search.css\"/>" << endl;
-          t << "<script type=\"text/javascript\" src=\"" << baseName << ".js\"></script>" << endl;
-          t << "<script type=\"text/javascript\" src=\"search.js\"></script>" << endl;
-          t << "</head>" << endl;
-          t << "<body class=\"SRPage\">" << endl;
-          t << "<div id=\"SRIndex\">" << endl;
-          t << "<div class=\"SRStatus\" id=\"Loading\">" << theTranslator->trLoading() << "</div>" << endl;
-          t << "<div id=\"SRResults\"></div>" << endl; // here the results will be inserted
-          t << "<script type=\"text/javascript\">" << endl;
-          t << "/* @license magnet:?xt=urn:btih:cf05388f2679ee054f2beb29a391d25f4e673ac3&amp;dn=gpl-2.0.txt GPL-v2 */\n";
-          t << "createResults();" << endl; // this function will insert the results
-          t << "/* @license-end */\n";
-          t << "</script>" << endl;
-          t << "<div class=\"SRStatus\" id=\"Searching\">"
-            << theTranslator->trSearching() << "</div>" << endl;
-          t << "<div class=\"SRStatus\" id=\"NoMatches\">"
-            << theTranslator->trNoMatches() << "</div>" << endl;
-
-          t << "<script type=\"text/javascript\">" << endl;
-          t << "/* @license magnet:?xt=urn:btih:cf05388f2679ee054f2beb29a391d25f4e673ac3&amp;dn=gpl-2.0.txt GPL-v2 */\n";
-          t << "document.getElementById(\"Loading\").style.display=\"none\";" << endl;
-          t << "document.getElementById(\"NoMatches\").style.display=\"none\";" << endl;
-          t << "var searchResults = new SearchResults(\"searchResults\");" << endl;
-          t << "searchResults.Search();" << endl;
-          t << "window.addEventListener(\"message\", function(event) {" << endl;
-          t << "  if (event.data == \"take_focus\") {" << endl;
-          t << "    var elem = searchResults.NavNext(0);" << endl;
-          t << "    if (elem) elem.focus();" << endl;
-          t << "  }" << endl;
-          t << "});" << endl;
-          t << "/* @license-end */\n";
-          t << "</script>" << endl;
-          t << "</div>" << endl; // SRIndex
-          t << "</body>" << endl;
-          t << "</html>" << endl;
+          FTextStream ti(&dataOutFile);
+          ti << "var searchData=" << endl;
+          writeSearchData(ti,kv.second,cnt);
+          ti << ";" << endl;
         }
-        FTextStream ti(&dataOutFile);
-
-        ti << "var searchData=" << endl;
-        // format
-        // searchData[] = array of items
-        // searchData[x][0] = id
-        // searchData[x][1] = [ name + child1 + child2 + .. ]
-        // searchData[x][1][0] = name as shown
-        // searchData[x][1][y+1] = info for child y
-        // searchData[x][1][y+1][0] = url
-        // searchData[x][1][y+1][1] = 1 => target="_parent"
-        // searchData[x][1][y+1][2] = scope
-
-        ti << "[" << endl;
-        bool firstEntry=TRUE;
-
-        int childCount=0;
-        QCString lastName;
-        const Definition *prevScope = 0;
-        for (auto it = kv.second.begin(); it!=kv.second.end();)
+        else
         {
-          const Definition *d = *it;
-          QCString sname = searchName(d);
-          QCString id    = searchId(d);
-
-          if (sname!=lastName) // this item has a different search word
-          {
-            if (!firstEntry)
-            {
-              ti << "]]]";
-              ti << "," << endl;
-            }
-            firstEntry=FALSE;
-
-            ti << "  ['" << id << "_" << cnt++ << "',['" << convertToXML(sname) << "',[";
-            childCount=0;
-            prevScope=0;
-          }
-
-          ++it;
-          const Definition *scope     = d->getOuterScope();
-          const Definition *next      = it!=kv.second.end() ? *it : 0;
-          const Definition *nextScope = 0;
-          const MemberDef  *md        = toMemberDef(d);
-          if (next) nextScope = next->getOuterScope();
-          QCString anchor = d->anchor();
-
-          if (childCount>0)
-          {
-            ti << "],[";
-          }
-          ti << "'" << externalRef("../",d->getReference(),TRUE)
-            << addHtmlExtensionIfMissing(d->getOutputFileBase());
-          if (!anchor.isEmpty())
-          {
-            ti << "#" << anchor;
-          }
-          ti << "',";
-
-          static bool extLinksInWindow = Config_getBool(EXT_LINKS_IN_WINDOW);
-          if (!extLinksInWindow || d->getReference().isEmpty())
+          err("Failed to open file '%s' for writing...\n",dataFileName.data());
+        }
+      }
+      else
+      {
+        int shardIndex=0;
+        for (const auto &skv : shards)
+        {
+          QCString dataFileName;
+          dataFileName.sprintf("%s/%s_%x.js",searchDirName.data(),baseName.data(),shardIndex);
+          QFile dataOutFile(dataFileName);
+          if (dataOutFile.open(IO_WriteOnly))
           {
-            ti << "1,";
+            FTextStream ti(&dataOutFile);
+            ti << "addSearchShard(" << shardIndex << "," << endl;
+            writeCompactSearchData(ti,skv.second,cnt);
+            ti << ");" << endl;
           }
           else
           {
-            ti << "0,";
-          }
-
-          if (lastName!=sname && (next==0 || searchName(next)!=sname)) // unique name
-          {
-            if (d->getOuterScope()!=Doxygen::globalScope)
-            {
-              ti << "'" << convertToXML(d->getOuterScope()->name()) << "'";
-            }
-            else if (md)
-            {
-              const FileDef *fd = md->getBodyDef();
-              if (fd==0) fd = md->getFileDef();
-              if (fd)
-              {
-                ti << "'" << convertToXML(fd->localName()) << "'";
-              }
-            }
-            else
-            {
-              ti << "''";
-            }
-          }
-          else // multiple entries with the same name
-          {
-            bool found=FALSE;
-            bool overloadedFunction = ((prevScope!=0 && scope==prevScope) ||
-                (scope && scope==nextScope)) && md && (md->isFunction() || md->isSlot());
-            QCString prefix;
-            if (md) prefix=convertToXML(md->localName());
-            if (overloadedFunction) // overloaded member function
-            {
-              prefix+=convertToXML(md->argsString());
-              // show argument list to disambiguate overloaded functions
-            }
-            else if (md) // unique member function
-            {
-              prefix+="()"; // only to show it is a function
-            }
-            QCString name;
-            if (d->definitionType()==Definition::TypeClass)
-            {
-              name = convertToXML((toClassDef(d))->displayName());
-              found = TRUE;
-            }
-            else if (d->definitionType()==Definition::TypeNamespace)
-            {
-              name = convertToXML((toNamespaceDef(d))->displayName());
-              found = TRUE;
-            }
-            else if (scope==0 || scope==Doxygen::globalScope) // in global scope
-            {
-              if (md)
-              {
-                const FileDef *fd = md->getBodyDef();
-                if (fd==0) fd = md->resolveAlias()->getFileDef();
-                if (fd)
-                {
-                  if (!prefix.isEmpty()) prefix+=":&#160;";
-                  name = prefix + convertToXML(fd->localName());
-                  found = TRUE;
-                }
-              }
-            }
-            else if (md && (md->resolveAlias()->getClassDef() || md->resolveAlias()->getNamespaceDef()))
-              // member in class or namespace scope
-            {
-              SrcLangExt lang = md->getLanguage();
-              name = convertToXML(d->getOuterScope()->qualifiedName())
-                + getLanguageSpecificSeparator(lang) + prefix;
-              found = TRUE;
-            }
-            else if (scope) // some thing else? -> show scope
-            {
-              name = prefix + convertToXML(scope->name());
-              found = TRUE;
-            }
-            if (!found) // fallback
-            {
-              name = prefix + "("+theTranslator->trGlobalNamespace()+")";
-            }
-
-            ti << "'" << name << "'";
-
-            prevScope = scope;
-            childCount++;
+            err("Failed to open file '%s' for writing...\n",dataFileName.data());
           }
-          lastName = sname;
-        }
-        if (!firstEntry)
-        {
-          ti << "]]]" << endl;
+          shardIndex++;
         }
-        ti << "];" << endl;
-      }
-      else
-      {
-        err("Failed to open file '%s' for writing...\n",fileName.data());
       }
       p++;
     }
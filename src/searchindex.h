@@ -56,8 +56,8 @@ class IndexWord
     using URLInfoMap = std::unordered_map<int,URLInfo>;
     IndexWord(QCString word);
     void addUrlIndex(int,bool);
-    URLInfoMap urls() const { return m_urls; }
-    QCString word() const { return m_word; }
+    const URLInfoMap &urls() const { return m_urls; }
+    const QCString &word() const { return m_word; }
 
   private:
     QCString    m_word;
@@ -107,6 +107,42 @@ class SearchIndexExternal : public SearchIndexIntf
     std::unique_ptr<Private> p;
 };
 
+/** Records the search index updates made by a thread, so they can be
+ *  applied to the real search index later on in a fixed order.
+ *
+ *  While a recorder is active for a thread, the setCurrentDoc() and addWord()
+ *  calls made on Doxygen::searchIndex by that thread are stored in the recorder
+ *  instead of being processed.
+ */
+class SearchIndexRecorder
+{
+  public:
+    void setCurrentDoc(const Definition *ctx,const char *anchor,bool isSourceFile);
+    void addWord(const char *word,bool hiPriority);
+    /** Applies all recorded updates to \a searchIndex in the order they were recorded */
+    void replay(SearchIndexIntf *searchIndex) const;
+
+    /** Makes \a recorder the active recorder for the calling thread, pass 0 to deactivate */
+    static void setActive(SearchIndexRecorder *recorder);
+    /** Returns the recorder that is active for the calling thread or 0 if there is none */
+    static SearchIndexRecorder *active();
+
+  private:
+    struct Item
+    {
+      Item(const Definition *c,const char *a,bool src)
+        : isWord(false), ctx(c), text(a), isNull(a==0), flag(src) {}
+      Item(const char *w,bool hiPrio)
+        : isWord(true), ctx(0), text(w), isNull(w==0), flag(hiPrio) {}
+      bool isWord;
+      const Definition *ctx;
+      QCString text;  // anchor or word
+      bool isNull;    // text was passed as a null pointer
+      bool flag;      // isSourceFile or hiPriority
+    };
+    std::vector<Item> m_items;
+};
+
 //------- client side search index ----------------------
 
 #define NUM_SEARCH_INDICES 20
@@ -50,6 +50,13 @@
 #include <string.h>
 #include <sqlite3.h>
 
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 // enable to show general debug messages
 // #define SQLITE3_DEBUG
 
@@ -500,10 +507,159 @@ const char * table_schema[][2] = {
 };
 
 //////////////////////////////////////////////////////
+class SqlBatch;
+
 struct SqlStmt {
   const char   *query = 0;
   sqlite3_stmt *stmt = 0;
   sqlite3 *db = 0;
+  SqlBatch *batch = 0; // rows are collected here in bulk load mode
+};
+//////////////////////////////////////////////////////
+/** Collects the rows for one of the relation tables when SQLITE3_BULK_LOAD
+ *  is enabled, and inserts them using multi-row INSERT statements.
+ *
+ *  The values bound to the statement the batch is attached to are recorded
+ *  instead, and step() adds them as a new row. Rows that violate a uniqueness
+ *  constraint are ignored, like they are when inserted one by one.
+ */
+class SqlBatch
+{
+  public:
+    SqlBatch(const char *table,std::initializer_list<const char *> params)
+      : m_table(table), m_params(params), m_row(m_params.size())
+    {
+      // stay below the default SQLITE_MAX_VARIABLE_NUMBER of 999
+      m_maxRows = std::min<size_t>(256,999/m_params.size());
+    }
+    void setInt(const char *name,int value)
+    {
+      Value &v = m_row[column(name)];
+      v.type = Value::Int;
+      v.i = value;
+    }
+    void setText(const char *name,const char *value)
+    {
+      Value &v = m_row[column(name)];
+      v.type = value ? Value::Text : Value::Null;
+      v.s = value ? value : "";
+    }
+    void addRow(sqlite3 *db)
+    {
+      m_values.insert(m_values.end(),m_row.begin(),m_row.end());
+      m_row.assign(m_params.size(),Value());
+      if (m_values.size()>=m_maxRows*m_params.size())
+      {
+        flush(db);
+      }
+    }
+    /** Inserts all collected rows */
+    void flush(sqlite3 *db)
+    {
+      size_t numRows = m_values.size()/m_params.size();
+      if (numRows==0) return;
+      sqlite3_stmt *stmt = 0;
+      if (numRows==m_maxRows && m_fullStmt) // reuse the statement for a full batch
+      {
+        stmt = m_fullStmt;
+      }
+      else
+      {
+        std::string query = insertQuery(numRows);
+        if (sqlite3_prepare_v2(db,query.c_str(),-1,&stmt,0)!=SQLITE_OK)
+        {
+          err("prepare failed for %s\n%s\n", query.c_str(), sqlite3_errmsg(db));
+          m_values.clear();
+          return;
+        }
+        if (numRows==m_maxRows) m_fullStmt = stmt;
+      }
+      for (size_t i=0;i<m_values.size();i++)
+      {
+        const Value &v = m_values[i];
+        int idx = static_cast<int>(i)+1;
+        switch (v.type)
+        {
+          case Value::Null: sqlite3_bind_null(stmt,idx); break;
+          case Value::Int:  sqlite3_bind_int(stmt,idx,v.i); break;
+          case Value::Text: sqlite3_bind_text(stmt,idx,v.s.c_str(),-1,SQLITE_STATIC); break;
+        }
+      }
+      int rc = sqlite3_step(stmt);
+      if (rc!=SQLITE_DONE)
+      {
+        DBG_CTX(("sqlite3_step: %s (rc: %d)\n", sqlite3_errmsg(db), rc));
+      }
+      if (stmt==m_fullStmt)
+      {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+      }
+      else
+      {
+        sqlite3_finalize(stmt);
+      }
+      m_values.clear();
+    }
+    /** Inserts all collected rows and releases the prepared statement */
+    void finish(sqlite3 *db)
+    {
+      flush(db);
+      if (m_fullStmt)
+      {
+        sqlite3_finalize(m_fullStmt);
+        m_fullStmt = 0;
+      }
+    }
+
+  private:
+    struct Value
+    {
+      enum Type { Null, Int, Text };
+      Type type = Null;
+      int i = 0;
+      std::string s;
+    };
+    size_t column(const char *name) const
+    {
+      for (size_t i=0;i<m_params.size();i++)
+      {
+        if (qstrcmp(m_params[i],name)==0) return i;
+      }
+      err("sqlite3 batch for table %s has no parameter %s\n",m_table,name);
+      return 0;
+    }
+    std::string insertQuery(size_t numRows) const
+    {
+      std::string query = "INSERT OR IGNORE INTO ";
+      query += m_table;
+      query += " (";
+      for (size_t i=0;i<m_params.size();i++)
+      {
+        if (i>0) query += ",";
+        query += m_params[i]+1; // skip the ':'
+      }
+      query += ") VALUES ";
+      std::string row = "(";
+      for (size_t i=0;i<m_params.size();i++)
+      {
+        row += i>0 ? ",?" : "?";
+      }
+      row += ")";
+      for (size_t r=0;r<numRows;r++)
+      {
+        if (r>0) query += ",";
+        query += row;
+      }
+      return query;
+    }
+
+    const char *m_table;
+    std::vector<const char *> m_params;
+    std::vector<Value> m_row;
+    std::vector<Value> m_values;
+    size_t m_maxRows = 1;
+    sqlite3_stmt *m_fullStmt = 0;
 };
 //////////////////////////////////////////////////////
 /* If you add a new statement below, make sure to add it to
@@ -823,6 +979,31 @@ SqlStmt memberdef_param_insert={
   ,NULL
 };
 
+//////////////////////////////////////////////////////
+SqlBatch incl_batch("includes",{":local",":src_id",":dst_id"});
+SqlBatch contains_batch("contains",{":inner_rowid",":outer_rowid"});
+SqlBatch xrefs_batch("xrefs",{":src_rowid",":dst_rowid",":context"});
+SqlBatch reimplements_batch("reimplements",{":memberdef_rowid",":reimplemented_rowid"});
+SqlBatch member_batch("member",{":scope_rowid",":memberdef_rowid",":prot",":virt"});
+SqlBatch compoundref_batch("compoundref",{":base_rowid",":derived_rowid",":prot",":virt"});
+SqlBatch memberdef_param_batch("memberdef_param",{":memberdef_id",":param_id"});
+
+/** In bulk load mode the rowids of the refids and paths, and the memberdefs
+ *  and compounddefs written so far are kept in memory, so no SELECT is needed
+ *  to find out if a row has to be inserted.
+ */
+struct BulkLoadState
+{
+  bool enabled = false;
+  std::unordered_map<std::string,int> refids;
+  std::unordered_map<std::string,int> paths;
+  // memberdef rowid -> value of the inline column, -1 if it is NULL (not a function)
+  std::unordered_map<int,int> memberdefInline;
+  std::unordered_set<int> compounddefs;
+};
+
+static BulkLoadState g_bulkLoad;
+
 class TextGeneratorSqlite3Impl : public TextGeneratorIntf
 {
   public:
@@ -854,6 +1035,11 @@ class TextGeneratorSqlite3Impl : public TextGeneratorIntf
 
 static bool bindTextParameter(SqlStmt &s,const char *name,const char *value, bool _static=FALSE)
 {
+  if (s.batch)
+  {
+    s.batch->setText(name,value);
+    return true;
+  }
   int idx = sqlite3_bind_parameter_index(s.stmt, name);
   if (idx==0) {
     err("sqlite3_bind_parameter_index(%s)[%s] failed: %s\n", name, s.query, sqlite3_errmsg(s.db));
@@ -869,6 +1055,11 @@ static bool bindTextParameter(SqlStmt &s,const char *name,const char *value, boo
 
 static bool bindIntParameter(SqlStmt &s,const char *name,int value)
 {
+  if (s.batch)
+  {
+    s.batch->setInt(name,value);
+    return true;
+  }
   int idx = sqlite3_bind_parameter_index(s.stmt, name);
   if (idx==0) {
     err("sqlite3_bind_parameter_index(%s)[%s] failed to find column: %s\n", name, s.query, sqlite3_errmsg(s.db));
@@ -884,6 +1075,11 @@ static bool bindIntParameter(SqlStmt &s,const char *name,int value)
 
 static int step(SqlStmt &s,bool getRowId=FALSE, bool select=FALSE)
 {
+  if (s.batch) // row is inserted later, so there is no rowid yet
+  {
+    s.batch->addRow(s.db);
+    return 0;
+  }
   int rowid=-1;
   int rc = sqlite3_step(s.stmt);
   if (rc!=SQLITE_DONE && rc!=SQLITE_ROW)
@@ -907,8 +1103,17 @@ static int insertPath(QCString name, bool local=TRUE, bool found=TRUE, int type=
 
   name = stripFromPath(name);
 
-  bindTextParameter(path_select,":name",name.data());
-  rowid=step(path_select,TRUE,TRUE);
+  if (g_bulkLoad.enabled)
+  {
+    auto it = g_bulkLoad.paths.find(name.str());
+    if (it!=g_bulkLoad.paths.end()) return it->second;
+    rowid=0;
+  }
+  else
+  {
+    bindTextParameter(path_select,":name",name.data());
+    rowid=step(path_select,TRUE,TRUE);
+  }
   if (rowid==0)
   {
     bindTextParameter(path_insert,":name",name.data());
@@ -916,6 +1121,10 @@ static int insertPath(QCString name, bool local=TRUE, bool found=TRUE, int type=
     bindIntParameter(path_insert,":local",local?1:0);
     bindIntParameter(path_insert,":found",found?1:0);
     rowid=step(path_insert,TRUE);
+    if (g_bulkLoad.enabled && rowid!=-1)
+    {
+      g_bulkLoad.paths.insert(std::make_pair(name.str(),rowid));
+    }
   }
   return rowid;
 }
@@ -946,13 +1155,30 @@ struct Refid insertRefid(const char *refid)
   ret.created = FALSE;
   if (refid==0) return ret;
 
-  bindTextParameter(refid_select,":refid",refid);
-  ret.rowid=step(refid_select,TRUE,TRUE);
+  if (g_bulkLoad.enabled)
+  {
+    auto it = g_bulkLoad.refids.find(refid);
+    if (it!=g_bulkLoad.refids.end())
+    {
+      ret.rowid=it->second;
+      return ret;
+    }
+    ret.rowid=0;
+  }
+  else
+  {
+    bindTextParameter(refid_select,":refid",refid);
+    ret.rowid=step(refid_select,TRUE,TRUE);
+  }
   if (ret.rowid==0)
   {
     bindTextParameter(refid_insert,":refid",refid);
     ret.rowid=step(refid_insert,TRUE);
     ret.created = TRUE;
+    if (g_bulkLoad.enabled && ret.rowid!=-1)
+    {
+      g_bulkLoad.refids.insert(std::make_pair(std::string(refid),ret.rowid));
+    }
   }
 
   return ret;
@@ -960,6 +1186,10 @@ struct Refid insertRefid(const char *refid)
 
 static bool memberdefExists(struct Refid refid)
 {
+  if (g_bulkLoad.enabled)
+  {
+    return g_bulkLoad.memberdefInline.find(refid.rowid)!=g_bulkLoad.memberdefInline.end();
+  }
   bindIntParameter(memberdef_exists,":rowid",refid.rowid);
   int test = step(memberdef_exists,TRUE,TRUE);
   return test ? true : false;
@@ -967,6 +1197,13 @@ static bool memberdefExists(struct Refid refid)
 
 static bool memberdefIncomplete(struct Refid refid, const MemberDef* md)
 {
+  if (g_bulkLoad.enabled)
+  {
+    auto it = g_bulkLoad.memberdefInline.find(refid.rowid);
+    // like the query, a NULL inline column never makes a member incomplete
+    return it!=g_bulkLoad.memberdefInline.end() &&
+           it->second!=-1 && it->second!=2 && it->second!=(md->isInline() ? 1 : 0);
+  }
   bindIntParameter(memberdef_incomplete,":rowid",refid.rowid);
   bindIntParameter(memberdef_incomplete,":new_inline",md->isInline());
   int test = step(memberdef_incomplete,TRUE,TRUE);
@@ -975,11 +1212,24 @@ static bool memberdefIncomplete(struct Refid refid, const MemberDef* md)
 
 static bool compounddefExists(struct Refid refid)
 {
+  if (g_bulkLoad.enabled)
+  {
+    return g_bulkLoad.compounddefs.find(refid.rowid)!=g_bulkLoad.compounddefs.end();
+  }
   bindIntParameter(compounddef_exists,":rowid",refid.rowid);
   int test = step(compounddef_exists,TRUE,TRUE);
   return test ? true : false;
 }
 
+static void insertCompounddef(struct Refid refid)
+{
+  int rowid = step(compounddef_insert,TRUE);
+  if (g_bulkLoad.enabled && rowid!=-1)
+  {
+    g_bulkLoad.compounddefs.insert(refid.rowid);
+  }
+}
+
 static bool insertMemberReference(struct Refid src_refid, struct Refid dst_refid, const char *context)
 {
   if (src_refid.rowid==-1||dst_refid.rowid==-1)
@@ -1186,6 +1436,37 @@ static int prepareStatements(sqlite3 *db)
   return 0;
 }
 
+static void beginBulkLoad()
+{
+  g_bulkLoad = BulkLoadState();
+  g_bulkLoad.enabled = Config_getBool(SQLITE3_BULK_LOAD);
+  if (g_bulkLoad.enabled)
+  {
+    incl_insert.batch            = &incl_batch;
+    contains_insert.batch        = &contains_batch;
+    xrefs_insert.batch           = &xrefs_batch;
+    reimplements_insert.batch    = &reimplements_batch;
+    member_insert.batch          = &member_batch;
+    compoundref_insert.batch     = &compoundref_batch;
+    memberdef_param_insert.batch = &memberdef_param_batch;
+  }
+}
+
+static void endBulkLoad(sqlite3 *db)
+{
+  if (g_bulkLoad.enabled)
+  {
+    incl_batch.finish(db);
+    contains_batch.finish(db);
+    xrefs_batch.finish(db);
+    reimplements_batch.finish(db);
+    member_batch.finish(db);
+    compoundref_batch.finish(db);
+    memberdef_param_batch.finish(db);
+  }
+  g_bulkLoad = BulkLoadState();
+}
+
 static void beginTransaction(sqlite3 *db)
 {
   char * sErrMsg = 0;
@@ -1579,7 +1860,10 @@ static void generateSqlite3ForMember(const MemberDef *md, struct Refid scope_ref
     getSQLDesc(memberdef_update,":detaileddescription",md->documentation(),md);
     getSQLDesc(memberdef_update,":inbodydescription",md->inbodyDocumentation(),md);
 
-    step(memberdef_update,TRUE);
+    if (step(memberdef_update,TRUE)!=-1 && g_bulkLoad.enabled)
+    {
+      g_bulkLoad.memberdefInline[refid.rowid]=2;
+    }
 
     // don't think we need to repeat params; should have from first encounter
 
@@ -1796,6 +2080,10 @@ static void generateSqlite3ForMember(const MemberDef *md, struct Refid scope_ref
   }
 
   int memberdef_id=step(memberdef_insert,TRUE);
+  if (g_bulkLoad.enabled && memberdef_id!=-1)
+  {
+    g_bulkLoad.memberdefInline[refid.rowid]=!isFunc ? -1 : md->isInline() ? 1 : 0;
+  }
 
   if (isFunc)
   {
@@ -1950,7 +2238,7 @@ static void generateSqlite3ForClass(const ClassDef *cd)
   getSQLDesc(compounddef_insert,":briefdescription",cd->briefDescription(),cd);
   getSQLDesc(compounddef_insert,":detaileddescription",cd->documentation(),cd);
 
-  step(compounddef_insert);
+  insertCompounddef(refid);
 
   // + list of direct super classes
   for (const auto &bcd : cd->baseClasses())
@@ -2031,7 +2319,7 @@ static void generateSqlite3ForNamespace(const NamespaceDef *nd)
   getSQLDesc(compounddef_insert,":briefdescription",nd->briefDescription(),nd);
   getSQLDesc(compounddef_insert,":detaileddescription",nd->documentation(),nd);
 
-  step(compounddef_insert);
+  insertCompounddef(refid);
 
   // + contained class definitions
   writeInnerClasses(nd->getClasses(),refid);
@@ -2091,7 +2379,7 @@ static void generateSqlite3ForFile(const FileDef *fd)
   getSQLDesc(compounddef_insert,":briefdescription",fd->briefDescription(),fd);
   getSQLDesc(compounddef_insert,":detaileddescription",fd->documentation(),fd);
 
-  step(compounddef_insert);
+  insertCompounddef(refid);
 
   // + includes files
   for (const auto &ii : fd->includeFileList())
@@ -2133,7 +2421,7 @@ static void generateSqlite3ForFile(const FileDef *fd)
     bindIntParameter(incl_select,":local",ii.local);
     bindIntParameter(incl_select,":src_id",src_id);
     bindIntParameter(incl_select,":dst_id",dst_id);
-    if (step(incl_select,TRUE,TRUE)==0) {
+    if (g_bulkLoad.enabled || step(incl_select,TRUE,TRUE)==0) {
       bindIntParameter(incl_insert,":local",ii.local);
       bindIntParameter(incl_insert,":src_id",src_id);
       bindIntParameter(incl_insert,":dst_id",dst_id);
@@ -2171,7 +2459,7 @@ static void generateSqlite3ForFile(const FileDef *fd)
     bindIntParameter(incl_select,":local",ii.local);
     bindIntParameter(incl_select,":src_id",src_id);
     bindIntParameter(incl_select,":dst_id",dst_id);
-    if (step(incl_select,TRUE,TRUE)==0) {
+    if (g_bulkLoad.enabled || step(incl_select,TRUE,TRUE)==0) {
       bindIntParameter(incl_insert,":local",ii.local);
       bindIntParameter(incl_insert,":src_id",src_id);
       bindIntParameter(incl_insert,":dst_id",dst_id);
@@ -2235,7 +2523,7 @@ static void generateSqlite3ForGroup(const GroupDef *gd)
   getSQLDesc(compounddef_insert,":briefdescription",gd->briefDescription(),gd);
   getSQLDesc(compounddef_insert,":detaileddescription",gd->documentation(),gd);
 
-  step(compounddef_insert);
+  insertCompounddef(refid);
 
   // + files
   writeInnerFiles(gd->getFiles(),refid);
@@ -2305,7 +2593,7 @@ static void generateSqlite3ForDir(const DirDef *dd)
   getSQLDesc(compounddef_insert,":briefdescription",dd->briefDescription(),dd);
   getSQLDesc(compounddef_insert,":detaileddescription",dd->documentation(),dd);
 
-  step(compounddef_insert);
+  insertCompounddef(refid);
 
   // + files
   writeInnerDirs(dd->subDirs(),refid);
@@ -2382,7 +2670,7 @@ static void generateSqlite3ForPage(const PageDef *pd,bool isExample)
   // + documentation (detailed description)
   getSQLDesc(compounddef_insert,":detaileddescription",pd->documentation(),pd);
 
-  step(compounddef_insert);
+  insertCompounddef(refid);
   // + sub pages
   writeInnerPages(pd->getSubPages(),refid);
 }
@@ -2468,6 +2756,7 @@ void generateSqlite3()
     return;
   }
 
+  beginBulkLoad();
   recordMetadata();
 
   // + classes
@@ -2529,6 +2818,8 @@ void generateSqlite3()
     generateSqlite3ForPage(Doxygen::mainPage.get(),FALSE);
   }
 
+  endBulkLoad(db);
+
   // TODO: copied from initializeSchema; not certain if we should say/do more
   // if there's a failure here?
   if (-1==initializeViews(db))
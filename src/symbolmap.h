@@ -22,6 +22,8 @@
 #include <string>
 #include <utility>
 
+#include <qcstring.h>
+
 //! Class implementing a symbol map that maps symbol names to objects.
 //! Symbol names do not have to be unique.
 //! Supports adding symbols with add(), removing symbols with remove(), and
@@ -31,7 +33,19 @@ class SymbolMap
 {
   public:
     using Ptr = T *;
-    using Map = std::multimap<std::string,Ptr>;
+    //! Orders the symbol names and also compares them with references to
+    //! (parts of) other strings, so a lookup does not need to copy the name.
+    struct NameLess
+    {
+      using is_transparent = void;
+      bool operator()(const std::string &s1,const std::string &s2) const
+      { return s1<s2; }
+      bool operator()(const std::string &s1,const QCStringRef &s2) const
+      { return QCStringRef(s1.data(),(uint)s1.size()).compare(s2)<0; }
+      bool operator()(const QCStringRef &s1,const std::string &s2) const
+      { return s1.compare(QCStringRef(s2.data(),(uint)s2.size()))<0; }
+    };
+    using Map = std::multimap<std::string,Ptr,NameLess>;
     using iterator = typename Map::iterator;
     using const_iterator = typename Map::const_iterator;
 
@@ -53,16 +67,16 @@ class SymbolMap
 
     //! Find the list of symbols stored under key \a name
     //! Returns a pair of iterators pointing to the start and end of the range of matching symbols
-    std::pair<const_iterator,const_iterator> find(const char *name) const
+    std::pair<const_iterator,const_iterator> find(const QCStringRef &name) const
     {
-      return m_map.equal_range(name ? name : "");
+      return m_map.equal_range(name);
     }
 
     //! Find the list of symbols stored under key \a name
     //! Returns a pair of iterators pointing to the start and end of the range of matching symbols
-    std::pair<iterator,iterator> find(const char *name)
+    std::pair<iterator,iterator> find(const QCStringRef &name)
     {
-      return m_map.equal_range(name ? name : "");
+      return m_map.equal_range(name);
     }
 
     iterator begin()             { return m_map.begin();  }
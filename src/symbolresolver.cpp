@@ -24,8 +24,6 @@
 #include "config.h"
 #include "defargs.h"
 
-static std::mutex g_cacheMutex;
-
 //--------------------------------------------------------------------------------------
 
 /** Helper class representing the stack of items considered while resolving
@@ -257,29 +255,26 @@ const ClassDef *SymbolResolver::Private::getResolvedClassRec(
   }
   *pk='\0';
 
-  LookupInfo *pval = 0;
   {
-    std::lock_guard<std::mutex> lock(g_cacheMutex);
-    pval=Doxygen::lookupCache->find(key.str());
-    //printf("Searching for %s result=%p\n",key.data(),pval);
-    if (pval)
+    LookupInfo val;
+    if (Doxygen::lookupCache->find(key.str(),val))
     {
       //printf("LookupInfo %p %p '%s' %p\n",
-      //    pval->classDef, pval->typeDef, pval->templSpec.data(),
-      //    pval->resolvedType.data());
-      if (pTemplSpec)    *pTemplSpec=pval->templSpec;
-      if (pTypeDef)      *pTypeDef=pval->typeDef;
-      if (pResolvedType) *pResolvedType=pval->resolvedType;
+      //    val.classDef, val.typeDef, val.templSpec.data(),
+      //    val.resolvedType.data());
+      if (pTemplSpec)    *pTemplSpec=val.templSpec;
+      if (pTypeDef)      *pTypeDef=val.typeDef;
+      if (pResolvedType) *pResolvedType=val.resolvedType;
       //fprintf(stderr,"%d ] cachedMatch=%s\n",--level,
-      //    pval->classDef?pval->classDef->name().data():"<none>");
+      //    val.classDef?val.classDef->name().data():"<none>");
       //if (pTemplSpec)
       //  printf("templSpec=%s\n",pTemplSpec->data());
-      return pval->classDef;
+      return val.classDef;
     }
     else // not found yet; we already add a 0 to avoid the possibility of
       // endless recursion.
     {
-      pval = Doxygen::lookupCache->insert(key.str(),LookupInfo());
+      Doxygen::lookupCache->insert(key.str(),LookupInfo());
     }
   }
 
@@ -312,14 +307,9 @@ const ClassDef *SymbolResolver::Private::getResolvedClassRec(
   //printf("getResolvedClassRec: bestMatch=%p pval->resolvedType=%s\n",
   //    bestMatch,bestResolvedType.data());
 
-  if (pval)
-  {
-    std::lock_guard<std::mutex> lock(g_cacheMutex);
-    pval->classDef     = bestMatch;
-    pval->typeDef      = bestTypedef;
-    pval->templSpec    = bestTemplSpec;
-    pval->resolvedType = bestResolvedType;
-  }
+  // replace the placeholder added above by the result
+  Doxygen::lookupCache->insert(key.str(),
+      LookupInfo(bestMatch,bestTypedef,bestTemplSpec,bestResolvedType));
   //fprintf(stderr,"%d ] bestMatch=%s distance=%d\n",--level,
   //    bestMatch?bestMatch->name().data():"<none>",minDistance);
   //if (pTemplSpec)
@@ -38,6 +38,16 @@
 #include "filename.h"
 #include "section.h"
 #include "containers.h"
+#include "config.h"
+#include "portable.h"
+#include "version.h"
+#include "binarystream.h"
+
+#include <qdatetime.h>
+#include <qfileinfo.h>
+
+static const int   g_tagIndexFormatVersion = 1;
+static const char *g_tagIndexMagic         = "DOXYTAGINDEX";
 
 /** Information about an linkable anchor */
 class TagAnchorInfo
@@ -239,13 +249,64 @@ class TagDirInfo : public TagCompoundInfo
     }
 };
 
+/** Helper to write the compounds read from a tag file into a binary index */
+class TagIndexWriter : public BinaryWriter
+{
+  public:
+    TagIndexWriter(std::string &buf) : BinaryWriter(buf) {}
+
+    void writeStringVector(const StringVector &sv)
+    {
+      writeUInt64(sv.size());
+      for (const auto &s : sv) writeString(s);
+    }
+    void writeAnchors(const std::vector<TagAnchorInfo> &anchors)
+    {
+      writeUInt64(anchors.size());
+      for (const auto &ta : anchors)
+      {
+        writeString(ta.fileName);
+        writeString(ta.label);
+        writeString(ta.title);
+      }
+    }
+};
+
+/** Helper to read the compounds of a tag file back from a (memory mapped) binary index */
+class TagIndexReader : public BinaryReader
+{
+  public:
+    TagIndexReader(const char *buf,size_t len) : BinaryReader(buf,len) {}
+
+    void readStringVector(StringVector &sv)
+    {
+      size_t n = readCount();
+      sv.reserve(n);
+      for (size_t i=0;i<n && ok();i++) sv.push_back(readString());
+    }
+    void readAnchors(std::vector<TagAnchorInfo> &anchors)
+    {
+      size_t n = readCount();
+      anchors.reserve(n);
+      for (size_t i=0;i<n && ok();i++)
+      {
+        std::string fileName = readString();
+        std::string label    = readString();
+        std::string title    = readString();
+        anchors.push_back(TagAnchorInfo(fileName,label,title));
+      }
+    }
+};
+
+struct ElementCallbacks;
+
 /** Tag file parser.
  *
  *  Reads an XML-structured tagfile and builds up the structure in
  *  memory. The method buildLists() is used to transfer/translate
  *  the structures to the doxygen engine.
  */
-class TagFileParser
+class TagFileParser : public XMLEventHandler
 {
   public:
     TagFileParser(const char *tagName) : m_tagName(tagName) {}
@@ -255,23 +316,25 @@ class TagFileParser
       m_locator = locator;
     }
 
-    void startDocument()
+    void startDocument() override
     {
       m_state = Invalid;
     }
 
-    void startElement( const std::string &name, const XMLHandlers::Attributes& attrib );
-    void endElement( const std::string &name );
-    void characters ( const std::string & ch ) { m_curString+=ch; }
-    void error( const std::string &fileName,int lineNr,const std::string &msg)
+    void startElement( const XMLTag &tag, const XMLAttributeList& attrib ) override;
+    void endElement( const XMLTag &tag ) override;
+    void characters ( XMLStringRef ch ) override { m_curString.append(ch.data(),ch.length()); }
+    void error( const std::string &fileName,int lineNr,const std::string &msg) override
     {
       ::warn(fileName.c_str(),lineNr,"%s",msg.c_str());
     }
 
     void dump();
+    void writeIndex(TagIndexWriter &writer) const;
+    bool readIndex(TagIndexReader &reader);
     void buildLists(const std::shared_ptr<Entry> &root);
     void addIncludes();
-    void startCompound( const XMLHandlers::Attributes& attrib );
+    void startCompound( const XMLAttributeList &attrib );
 
     void endCompound()
     {
@@ -292,13 +355,13 @@ class TagFileParser
       }
     }
 
-    void startMember( const XMLHandlers::Attributes& attrib)
+    void startMember( const XMLAttributeList &attrib)
     {
       m_curMember = TagMemberInfo();
-      m_curMember.kind      = XMLHandlers::value(attrib,"kind");
-      std::string protStr   = XMLHandlers::value(attrib,"protection");
-      std::string virtStr   = XMLHandlers::value(attrib,"virtualness");
-      std::string staticStr = XMLHandlers::value(attrib,"static");
+      m_curMember.kind       = attrib.value("kind");
+      XMLStringRef protStr   = attrib.find("protection");
+      XMLStringRef virtStr   = attrib.find("virtualness");
+      XMLStringRef staticStr = attrib.find("static");
       if (protStr=="protected")
       {
         m_curMember.prot = Protected;
@@ -342,15 +405,15 @@ class TagFileParser
       }
     }
 
-    void startEnumValue( const XMLHandlers::Attributes& attrib)
+    void startEnumValue( const XMLAttributeList &attrib)
     {
       if (m_state==InMember)
       {
         m_curString = "";
         m_curEnumValue = TagEnumValueInfo();
-        m_curEnumValue.file    = XMLHandlers::value(attrib,"file");
-        m_curEnumValue.anchor  = XMLHandlers::value(attrib,"anchor");
-        m_curEnumValue.clangid = XMLHandlers::value(attrib,"clangid");
+        m_curEnumValue.file    = attrib.value("file");
+        m_curEnumValue.anchor  = attrib.value("anchor");
+        m_curEnumValue.clangid = attrib.value("clangid");
         m_stateStack.push(m_state);
         m_state = InEnumValue;
       }
@@ -495,15 +558,15 @@ class TagFileParser
       }
     }
 
-    void startStringValue(const XMLHandlers::Attributes& )
+    void startStringValue(const XMLAttributeList &)
     {
       m_curString = "";
     }
 
-    void startDocAnchor(const XMLHandlers::Attributes& attrib )
+    void startDocAnchor(const XMLAttributeList &attrib )
     {
-      m_fileName  = XMLHandlers::value(attrib,"file");
-      m_title     = XMLHandlers::value(attrib,"title");
+      m_fileName  = attrib.value("file");
+      m_title     = attrib.value("title");
       m_curString = "";
     }
 
@@ -541,13 +604,13 @@ class TagFileParser
       }
     }
 
-    void startBase(const XMLHandlers::Attributes& attrib )
+    void startBase(const XMLAttributeList &attrib )
     {
       m_curString="";
       if (m_state==InClass && m_curCompound)
       {
-        std::string protStr = XMLHandlers::value(attrib,"protection");
-        std::string virtStr = XMLHandlers::value(attrib,"virtualness");
+        XMLStringRef protStr = attrib.find("protection");
+        XMLStringRef virtStr = attrib.find("virtualness");
         Protection prot = Public;
         Specifier  virt = Normal;
         if (protStr=="protected")
@@ -582,13 +645,13 @@ class TagFileParser
       }
     }
 
-    void startIncludes(const XMLHandlers::Attributes& attrib )
+    void startIncludes(const XMLAttributeList &attrib )
     {
       m_curIncludes = TagIncludeInfo();
-      m_curIncludes.id         = XMLHandlers::value(attrib,"id");
-      m_curIncludes.name       = XMLHandlers::value(attrib,"name");
-      m_curIncludes.isLocal    = XMLHandlers::value(attrib,"local")=="yes";
-      m_curIncludes.isImported = XMLHandlers::value(attrib,"imported")=="yes";
+      m_curIncludes.id         = attrib.value("id");
+      m_curIncludes.name       = attrib.value("name");
+      m_curIncludes.isLocal    = attrib.find("local")=="yes";
+      m_curIncludes.isImported = attrib.find("imported")=="yes";
       m_curString="";
     }
 
@@ -742,7 +805,7 @@ class TagFileParser
       }
     }
 
-    void startIgnoreElement(const XMLHandlers::Attributes& )
+    void startIgnoreElement(const XMLAttributeList &)
     {
     }
 
@@ -751,6 +814,7 @@ class TagFileParser
     }
 
     void buildMemberList(const std::shared_ptr<Entry> &ce,const std::vector<TagMemberInfo> &members);
+    const ElementCallbacks *elementCallbacks(const XMLTag &tag);
     void addDocAnchors(const std::shared_ptr<Entry> &e,const std::vector<TagAnchorInfo> &l);
 
 
@@ -770,14 +834,20 @@ class TagFileParser
 
     void warn(const char *fmt)
     {
-      std::string fileName = m_locator->fileName();
-      ::warn(fileName.c_str(),m_locator->lineNr(),"%s", fmt);
+      warn("%s",fmt);
     }
 
     void warn(const char *fmt,const char *s)
     {
-      std::string fileName = m_locator->fileName();
-      ::warn(fileName.c_str(),m_locator->lineNr(),fmt,s);
+      if (m_locator)
+      {
+        std::string fileName = m_locator->fileName();
+        ::warn(fileName.c_str(),m_locator->lineNr(),fmt,s);
+      }
+      else // compounds read from the tag file index
+      {
+        ::warn(m_tagName.c_str(),1,fmt,s);
+      }
     }
 
 
@@ -797,55 +867,46 @@ class TagFileParser
     State                      m_state = Invalid;
     std::stack<State>          m_stateStack;
     const XMLLocator          *m_locator = nullptr;
+    std::vector<const ElementCallbacks *> m_elementCallbacks;
 };
 
 //---------------------------------------------------------------------------------------------------------------
 
 struct ElementCallbacks
 {
-  using StartCallback = std::function<void(TagFileParser&,const XMLHandlers::Attributes&)>;
-  using EndCallback   = std::function<void(TagFileParser&)>;
+  using StartCallback = void (TagFileParser::*)(const XMLAttributeList &);
+  using EndCallback   = void (TagFileParser::*)();
 
   StartCallback startCb;
   EndCallback   endCb;
 };
 
-ElementCallbacks::StartCallback startCb(void (TagFileParser::*fn)(const XMLHandlers::Attributes &))
-{
-  return [fn](TagFileParser &parser,const XMLHandlers::Attributes &attr) { (parser.*fn)(attr); };
-}
-
-ElementCallbacks::EndCallback endCb(void (TagFileParser::*fn)())
-{
-  return [fn](TagFileParser &parser) { (parser.*fn)(); };
-}
-
 static const std::map< std::string, ElementCallbacks > g_elementHandlers =
 {
-  // name,         start element callback,                      end element callback
-  { "compound",    { startCb(&TagFileParser::startCompound     ), endCb(&TagFileParser::endCompound     ) } },
-  { "member",      { startCb(&TagFileParser::startMember       ), endCb(&TagFileParser::endMember       ) } },
-  { "enumvalue",   { startCb(&TagFileParser::startEnumValue    ), endCb(&TagFileParser::endEnumValue    ) } },
-  { "name",        { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endName         ) } },
-  { "base",        { startCb(&TagFileParser::startBase         ), endCb(&TagFileParser::endBase         ) } },
-  { "filename",    { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endFilename     ) } },
-  { "includes",    { startCb(&TagFileParser::startIncludes     ), endCb(&TagFileParser::endIncludes     ) } },
-  { "path",        { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endPath         ) } },
-  { "anchorfile",  { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endAnchorFile   ) } },
-  { "anchor",      { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endAnchor       ) } },
-  { "clangid",     { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endClangId      ) } },
-  { "arglist",     { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endArglist      ) } },
-  { "title",       { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endTitle        ) } },
-  { "subgroup",    { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endSubgroup     ) } },
-  { "class",       { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endClass        ) } },
-  { "namespace",   { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endNamespace    ) } },
-  { "file",        { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endFile         ) } },
-  { "dir",         { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endDir          ) } },
-  { "page",        { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endPage         ) } },
-  { "docanchor",   { startCb(&TagFileParser::startDocAnchor    ), endCb(&TagFileParser::endDocAnchor    ) } },
-  { "tagfile",     { startCb(&TagFileParser::startIgnoreElement), endCb(&TagFileParser::endIgnoreElement) } },
-  { "templarg",    { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endTemplateArg  ) } },
-  { "type",        { startCb(&TagFileParser::startStringValue  ), endCb(&TagFileParser::endType         ) } }
+  // name,         start element callback,              end element callback
+  { "compound",    { &TagFileParser::startCompound,       &TagFileParser::endCompound      } },
+  { "member",      { &TagFileParser::startMember,         &TagFileParser::endMember        } },
+  { "enumvalue",   { &TagFileParser::startEnumValue,      &TagFileParser::endEnumValue     } },
+  { "name",        { &TagFileParser::startStringValue,    &TagFileParser::endName          } },
+  { "base",        { &TagFileParser::startBase,           &TagFileParser::endBase          } },
+  { "filename",    { &TagFileParser::startStringValue,    &TagFileParser::endFilename      } },
+  { "includes",    { &TagFileParser::startIncludes,       &TagFileParser::endIncludes      } },
+  { "path",        { &TagFileParser::startStringValue,    &TagFileParser::endPath          } },
+  { "anchorfile",  { &TagFileParser::startStringValue,    &TagFileParser::endAnchorFile    } },
+  { "anchor",      { &TagFileParser::startStringValue,    &TagFileParser::endAnchor        } },
+  { "clangid",     { &TagFileParser::startStringValue,    &TagFileParser::endClangId       } },
+  { "arglist",     { &TagFileParser::startStringValue,    &TagFileParser::endArglist       } },
+  { "title",       { &TagFileParser::startStringValue,    &TagFileParser::endTitle         } },
+  { "subgroup",    { &TagFileParser::startStringValue,    &TagFileParser::endSubgroup      } },
+  { "class",       { &TagFileParser::startStringValue,    &TagFileParser::endClass         } },
+  { "namespace",   { &TagFileParser::startStringValue,    &TagFileParser::endNamespace     } },
+  { "file",        { &TagFileParser::startStringValue,    &TagFileParser::endFile          } },
+  { "dir",         { &TagFileParser::startStringValue,    &TagFileParser::endDir           } },
+  { "page",        { &TagFileParser::startStringValue,    &TagFileParser::endPage          } },
+  { "docanchor",   { &TagFileParser::startDocAnchor,      &TagFileParser::endDocAnchor     } },
+  { "tagfile",     { &TagFileParser::startIgnoreElement,  &TagFileParser::endIgnoreElement } },
+  { "templarg",    { &TagFileParser::startStringValue,    &TagFileParser::endTemplateArg   } },
+  { "type",        { &TagFileParser::startStringValue,    &TagFileParser::endType          } }
 };
 
 //---------------------------------------------------------------------------------------------------------------
@@ -881,39 +942,58 @@ static const std::map< std::string, CompoundFactory > g_compoundFactory =
 
 //---------------------------------------------------------------------------------------------------------------
 
-void TagFileParser::startElement( const std::string &name, const XMLHandlers::Attributes& attrib )
+static const ElementCallbacks g_unknownElement = { nullptr, nullptr };
+
+const ElementCallbacks *TagFileParser::elementCallbacks(const XMLTag &tag)
+{
+  // look up the callbacks once per distinct tag instead of for every element
+  size_t id = static_cast<size_t>(tag.id);
+  if (id>=m_elementCallbacks.size())
+  {
+    m_elementCallbacks.resize(id+1,nullptr);
+  }
+  const ElementCallbacks *&cb = m_elementCallbacks[id];
+  if (cb==nullptr)
+  {
+    auto it = g_elementHandlers.find(tag.name);
+    cb = it!=std::end(g_elementHandlers) ? &it->second : &g_unknownElement;
+  }
+  return cb!=&g_unknownElement ? cb : nullptr;
+}
+
+void TagFileParser::startElement( const XMLTag &tag, const XMLAttributeList &attrib )
 {
-  //printf("startElement '%s'\n",name.data());
-  auto it = g_elementHandlers.find(name);
-  if (it!=std::end(g_elementHandlers))
+  //printf("startElement '%s'\n",tag.name.data());
+  const ElementCallbacks *cb = elementCallbacks(tag);
+  if (cb)
   {
-    it->second.startCb(*this,attrib);
+    (this->*cb->startCb)(attrib);
   }
   else
   {
-    warn("Unknown start tag '%s' found!",name.data());
+    warn("Unknown start tag '%s' found!",tag.name.data());
   }
 }
 
-void TagFileParser::endElement( const std::string &name )
+void TagFileParser::endElement( const XMLTag &tag )
 {
-  //printf("endElement '%s'\n",name.data());
-  auto it = g_elementHandlers.find(name);
-  if (it!=std::end(g_elementHandlers))
+  //printf("endElement '%s'\n",tag.name.data());
+  const ElementCallbacks *cb = elementCallbacks(tag);
+  if (cb)
   {
-    it->second.endCb(*this);
+    (this->*cb->endCb)();
   }
   else
   {
-    warn("Unknown end tag '%s' found!",name.data());
+    warn("Unknown end tag '%s' found!",tag.name.data());
   }
 }
 
-void TagFileParser::startCompound( const XMLHandlers::Attributes& attrib )
+void TagFileParser::startCompound( const XMLAttributeList &attrib )
 {
   m_curString = "";
-  std::string kind   = XMLHandlers::value(attrib,"kind");
-  std::string isObjC = XMLHandlers::value(attrib,"objc");
+  std::string  kind   = attrib.value("kind");
+  XMLStringRef isObjC = attrib.find("objc");
 
   auto it = g_compoundFactory.find(kind);
   if (it!=g_compoundFactory.end())
@@ -1486,20 +1566,318 @@ void TagFileParser::addIncludes()
   }
 }
 
+void TagFileParser::writeIndex(TagIndexWriter &w) const
+{
+  w.writeUInt64(m_tagFileCompounds.size());
+  for (const auto &comp : m_tagFileCompounds)
+  {
+    w.writeInt(static_cast<int>(comp->compoundType()));
+    w.writeString(comp->name);
+    w.writeString(comp->filename);
+    w.writeAnchors(comp->docAnchors);
+    w.writeUInt64(comp->members.size());
+    for (const auto &tmi : comp->members)
+    {
+      w.writeString(tmi.type);
+      w.writeString(tmi.name);
+      w.writeString(tmi.anchorFile);
+      w.writeString(tmi.anchor);
+      w.writeString(tmi.arglist);
+      w.writeString(tmi.kind);
+      w.writeString(tmi.clangId);
+      w.writeAnchors(tmi.docAnchors);
+      w.writeInt(tmi.prot);
+      w.writeInt(tmi.virt);
+      w.writeBool(tmi.isStatic);
+      w.writeUInt64(tmi.enumValues.size());
+      for (const auto &evi : tmi.enumValues)
+      {
+        w.writeString(evi.name);
+        w.writeString(evi.file);
+        w.writeString(evi.anchor);
+        w.writeString(evi.clangid);
+      }
+    }
+    switch (comp->compoundType())
+    {
+      case TagCompoundInfo::CompoundType::Class:
+        {
+          const TagClassInfo *tci = TagClassInfo::get(comp);
+          w.writeInt(static_cast<int>(tci->kind));
+          w.writeString(tci->clangId);
+          w.writeString(tci->anchor);
+          w.writeUInt64(tci->bases.size());
+          for (const auto &bi : tci->bases)
+          {
+            w.writeString(bi.name);
+            w.writeInt(bi.prot);
+            w.writeInt(bi.virt);
+          }
+          w.writeStringVector(tci->templateArguments);
+          w.writeStringVector(tci->classList);
+          w.writeBool(tci->isObjC);
+        }
+        break;
+      case TagCompoundInfo::CompoundType::Namespace:
+        {
+          const TagNamespaceInfo *tni = TagNamespaceInfo::get(comp);
+          w.writeString(tni->clangId);
+          w.writeStringVector(tni->classList);
+          w.writeStringVector(tni->namespaceList);
+        }
+        break;
+      case TagCompoundInfo::CompoundType::Package:
+        w.writeStringVector(TagPackageInfo::get(comp)->classList);
+        break;
+      case TagCompoundInfo::CompoundType::File:
+        {
+          const TagFileInfo *tfi = TagFileInfo::get(comp);
+          w.writeString(tfi->path);
+          w.writeStringVector(tfi->classList);
+          w.writeStringVector(tfi->namespaceList);
+          w.writeUInt64(tfi->includes.size());
+          for (const auto &ii : tfi->includes)
+          {
+            w.writeString(ii.id);
+            w.writeString(ii.name);
+            w.writeString(ii.text);
+            w.writeBool(ii.isLocal);
+            w.writeBool(ii.isImported);
+          }
+        }
+        break;
+      case TagCompoundInfo::CompoundType::Group:
+        {
+          const TagGroupInfo *tgi = TagGroupInfo::get(comp);
+          w.writeString(tgi->title);
+          w.writeStringVector(tgi->subgroupList);
+          w.writeStringVector(tgi->classList);
+          w.writeStringVector(tgi->namespaceList);
+          w.writeStringVector(tgi->fileList);
+          w.writeStringVector(tgi->pageList);
+          w.writeStringVector(tgi->dirList);
+        }
+        break;
+      case TagCompoundInfo::CompoundType::Page:
+        w.writeString(TagPageInfo::get(comp)->title);
+        break;
+      case TagCompoundInfo::CompoundType::Dir:
+        {
+          const TagDirInfo *tdi = TagDirInfo::get(comp);
+          w.writeString(tdi->path);
+          w.writeStringVector(tdi->subdirList);
+          w.writeStringVector(tdi->fileList);
+        }
+        break;
+    }
+  }
+}
+
+bool TagFileParser::readIndex(TagIndexReader &r)
+{
+  bool valid = true;
+  size_t numCompounds = r.readCount();
+  m_tagFileCompounds.reserve(numCompounds);
+  for (size_t i=0;i<numCompounds && r.ok() && valid;i++)
+  {
+    std::unique_ptr<TagCompoundInfo> comp;
+    switch (static_cast<TagCompoundInfo::CompoundType>(r.readInt()))
+    {
+      case TagCompoundInfo::CompoundType::Class:     comp = std::make_unique<TagClassInfo>(TagClassInfo::Kind::None); break;
+      case TagCompoundInfo::CompoundType::Namespace: comp = std::make_unique<TagNamespaceInfo>();                     break;
+      case TagCompoundInfo::CompoundType::Package:   comp = std::make_unique<TagPackageInfo>();                       break;
+      case TagCompoundInfo::CompoundType::File:      comp = std::make_unique<TagFileInfo>();                          break;
+      case TagCompoundInfo::CompoundType::Group:     comp = std::make_unique<TagGroupInfo>();                         break;
+      case TagCompoundInfo::CompoundType::Page:      comp = std::make_unique<TagPageInfo>();                          break;
+      case TagCompoundInfo::CompoundType::Dir:       comp = std::make_unique<TagDirInfo>();                           break;
+      default: valid=false; continue;
+    }
+    comp->name     = r.readString();
+    comp->filename = r.readString();
+    r.readAnchors(comp->docAnchors);
+    size_t numMembers = r.readCount();
+    comp->members.reserve(numMembers);
+    for (size_t j=0;j<numMembers && r.ok();j++)
+    {
+      TagMemberInfo tmi;
+      tmi.type       = r.readString();
+      tmi.name       = r.readString();
+      tmi.anchorFile = r.readString();
+      tmi.anchor     = r.readString();
+      tmi.arglist    = r.readString();
+      tmi.kind       = r.readString();
+      tmi.clangId    = r.readString();
+      r.readAnchors(tmi.docAnchors);
+      tmi.prot       = static_cast<Protection>(r.readInt());
+      tmi.virt       = static_cast<Specifier>(r.readInt());
+      tmi.isStatic   = r.readBool();
+      size_t numEnumValues = r.readCount();
+      for (size_t k=0;k<numEnumValues && r.ok();k++)
+      {
+        TagEnumValueInfo evi;
+        evi.name    = r.readString();
+        evi.file    = r.readString();
+        evi.anchor  = r.readString();
+        evi.clangid = r.readString();
+        tmi.enumValues.push_back(std::move(evi));
+      }
+      comp->members.push_back(std::move(tmi));
+    }
+    switch (comp->compoundType())
+    {
+      case TagCompoundInfo::CompoundType::Class:
+        {
+          TagClassInfo *tci = TagClassInfo::get(comp);
+          tci->kind    = static_cast<TagClassInfo::Kind>(r.readInt());
+          tci->clangId = r.readString();
+          tci->anchor  = r.readString();
+          size_t numBases = r.readCount();
+          for (size_t j=0;j<numBases && r.ok();j++)
+          {
+            std::string name = r.readString();
+            Protection prot  = static_cast<Protection>(r.readInt());
+            Specifier  virt  = static_cast<Specifier>(r.readInt());
+            tci->bases.push_back(BaseInfo(name.c_str(),prot,virt));
+          }
+          r.readStringVector(tci->templateArguments);
+          r.readStringVector(tci->classList);
+          tci->isObjC = r.readBool();
+        }
+        break;
+      case TagCompoundInfo::CompoundType::Namespace:
+        {
+          TagNamespaceInfo *tni = TagNamespaceInfo::get(comp);
+          tni->clangId = r.readString();
+          r.readStringVector(tni->classList);
+          r.readStringVector(tni->namespaceList);
+        }
+        break;
+      case TagCompoundInfo::CompoundType::Package:
+        r.readStringVector(TagPackageInfo::get(comp)->classList);
+        break;
+      case TagCompoundInfo::CompoundType::File:
+        {
+          TagFileInfo *tfi = TagFileInfo::get(comp);
+          tfi->path = r.readString();
+          r.readStringVector(tfi->classList);
+          r.readStringVector(tfi->namespaceList);
+          size_t numIncludes = r.readCount();
+          for (size_t j=0;j<numIncludes && r.ok();j++)
+          {
+            TagIncludeInfo ii;
+            ii.id         = r.readString();
+            ii.name       = r.readString();
+            ii.text       = r.readString();
+            ii.isLocal    = r.readBool();
+            ii.isImported = r.readBool();
+            tfi->includes.push_back(std::move(ii));
+          }
+        }
+        break;
+      case TagCompoundInfo::CompoundType::Group:
+        {
+          TagGroupInfo *tgi = TagGroupInfo::get(comp);
+          tgi->title = r.readString();
+          r.readStringVector(tgi->subgroupList);
+          r.readStringVector(tgi->classList);
+          r.readStringVector(tgi->namespaceList);
+          r.readStringVector(tgi->fileList);
+          r.readStringVector(tgi->pageList);
+          r.readStringVector(tgi->dirList);
+        }
+        break;
+      case TagCompoundInfo::CompoundType::Page:
+        TagPageInfo::get(comp)->title = r.readString();
+        break;
+      case TagCompoundInfo::CompoundType::Dir:
+        {
+          TagDirInfo *tdi = TagDirInfo::get(comp);
+          tdi->path = r.readString();
+          r.readStringVector(tdi->subdirList);
+          r.readStringVector(tdi->fileList);
+        }
+        break;
+    }
+    m_tagFileCompounds.push_back(std::move(comp));
+  }
+  if (!valid || !r.ok() || !r.atEnd())
+  {
+    m_tagFileCompounds.clear();
+    return false;
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/** Returns a string identifying the version of the tag file \a fi,
+ *  which changes whenever the tag file is rewritten.
+ */
+static QCString tagFileStamp(const QFileInfo &fi)
+{
+  QDateTime lastModified = fi.lastModified();
+  QCString stamp;
+  stamp.sprintf("%u %s.%03d %s",fi.size(),lastModified.toString().data(),
+                lastModified.time().msec(),getFullVersion());
+  return stamp;
+}
+
+/** Loads the compounds of tag file \a fullName from its binary index,
+ *  if that exists and is up to date.
+ */
+static bool loadTagIndex(TagFileParser &tagFileParser,const char *fullName)
+{
+  QCString indexName = QCString(fullName)+".idx";
+  size_t size;
+  const char *data = Portable::mapFile(indexName,size);
+  if (data==0) return false;
+  bool success = false;
+  {
+    TagIndexReader reader(data,size);
+    std::string magic   = reader.readString();
+    int version         = reader.readInt();
+    std::string stamp   = reader.readString();
+    if (reader.ok() && magic==g_tagIndexMagic && version==g_tagIndexFormatVersion &&
+        QCString(stamp)==tagFileStamp(QFileInfo(fullName)))
+    {
+      success = tagFileParser.readIndex(reader);
+      if (!success)
+      {
+        warn_uncond("ignoring corrupt tag file index %s\n",indexName.data());
+      }
+    }
+  }
+  Portable::unmapFile(data,size);
+  return success;
+}
+
+/** Writes the compounds read from tag file \a fullName to a binary index
+ *  next to it. Nothing is written if the directory is not writable.
+ */
+static void storeTagIndex(const TagFileParser &tagFileParser,const char *fullName)
+{
+  std::string buf;
+  TagIndexWriter writer(buf);
+  writer.writeString(g_tagIndexMagic,strlen(g_tagIndexMagic));
+  writer.writeInt(g_tagIndexFormatVersion);
+  writer.writeString(tagFileStamp(QFileInfo(fullName)));
+  tagFileParser.writeIndex(writer);
+
+  writeFileAtomically(QCString(fullName)+".idx",buf);
+}
+
 void parseTagFile(const std::shared_ptr<Entry> &root,const char *fullName)
 {
   TagFileParser tagFileParser(fullName);
-  QCString inputStr = fileToString(fullName);
-  XMLHandlers handlers;
-  // connect the generic events handlers of the XML parser to the specific handlers of the tagFileParser object
-  handlers.startDocument = [&tagFileParser]()                                                              { tagFileParser.startDocument(); };
-  handlers.startElement  = [&tagFileParser](const std::string &name,const XMLHandlers::Attributes &attrs)  { tagFileParser.startElement(name,attrs); };
-  handlers.endElement    = [&tagFileParser](const std::string &name)                                       { tagFileParser.endElement(name); };
-  handlers.characters    = [&tagFileParser](const std::string &chars)                                      { tagFileParser.characters(chars); };
-  handlers.error         = [&tagFileParser](const std::string &fileName,int lineNr,const std::string &msg) { tagFileParser.error(fileName,lineNr,msg); };
-  XMLParser parser(handlers);
-  tagFileParser.setDocumentLocator(&parser);
-  parser.parse(fullName,inputStr);
+  XMLParser parser(tagFileParser);
+  bool useIndex = Config_getBool(TAGFILE_INDEX);
+  if (!useIndex || !loadTagIndex(tagFileParser,fullName))
+  {
+    QCString inputStr = fileToString(fullName);
+    tagFileParser.setDocumentLocator(&parser);
+    parser.parse(fullName,inputStr);
+    if (useIndex) storeTagIndex(tagFileParser,fullName);
+  }
   tagFileParser.buildLists(root);
   tagFileParser.addIncludes();
   //tagFileParser.dump();
@@ -16,10 +16,14 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
+#include <atomic>
 #include <condition_variable>
 #include <deque>
+#include <exception>
 #include <functional>
 #include <future>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <type_traits>
@@ -147,5 +151,349 @@ class ThreadPool
     std::vector< std::future<void> > m_finished;
 };
 
-#endif
+/// Class managing a pool of worker threads that each have their own queue of tasks.
+///
+/// Work queued from outside the pool is distributed over the queues of the workers
+/// in a round robin fashion, work queued by one of the workers is added to its
+/// own queue. A worker takes tasks from the back of its own queue and, when that
+/// queue is empty, steals tasks from the front of the queues of the other workers.
+/// As a result there is no single lock that all threads compete for.
+///
+/// The queue() method is compatible with the one of ThreadPool. In addition
+/// parallelFor() can be used to process all elements of a container,
+/// like a LinkedMap, in parallel.
+///
+/// Usage example:
+/// @code
+/// WorkStealingThreadPool pool(4);
+/// pool.parallelFor(*Doxygen::classLinkedMap,[](const std::unique_ptr<ClassDef> &cd)
+/// {
+///   process(cd.get());
+/// });
+/// @endcode
+class WorkStealingThreadPool
+{
+  public:
+    /// start N threads in the thread pool.
+    WorkStealingThreadPool(std::size_t N=1) : m_queues(N==0 ? 1 : N)
+    {
+      for (std::size_t i = 0; i < m_queues.size(); ++i)
+      {
+        m_threads.emplace_back([this,i]{ threadTask(i); });
+      }
+    }
+    /// deletes the thread pool after all queued work is done
+    ~WorkStealingThreadPool()
+    {
+      finish();
+    }
+    WorkStealingThreadPool(const WorkStealingThreadPool &) = delete;
+    WorkStealingThreadPool &operator=(const WorkStealingThreadPool &) = delete;
+
+    /// Returns the number of worker threads
+    std::size_t numThreads() const { return m_queues.size(); }
+
+    /// Queue the callable function \a f for the threads to execute.
+    /// A future of the return type of the function is returned to capture the result.
+    template<class F, class R=std::result_of_t<F&()> >
+    std::future<R> queue(F&& f)
+    {
+      std::packaged_task<R()> task(std::forward<F>(f));
+      auto r=task.get_future(); // get the return value before we hand off the task
+      push(Task(std::move(task)));
+      return r; // return the future result of the task
+    }
+
+    /// Calls \a f for each element in the range [\a first, \a last) using
+    /// all worker threads and the calling thread, and returns when all elements
+    /// have been processed. Elements are handed out in chunks of \a grainSize
+    /// elements; when \a grainSize is 0 a suitable size is chosen.
+    /// If \a f throws, the first exception is rethrown after all work is done.
+    template<class It, class F>
+    void parallelFor(It first, It last, F &&f, std::size_t grainSize=0)
+    {
+      using Diff = typename std::iterator_traits<It>::difference_type;
+      std::size_t n = static_cast<std::size_t>(std::distance(first,last));
+      if (n==0) return;
+      if (grainSize==0)
+      {
+        // aim for a few chunks per thread so fast threads can pick up extra work
+        grainSize = std::max<std::size_t>(1,n/(4*numThreads()));
+      }
+      struct State
+      {
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> active{0};
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::exception_ptr error;
+      };
+      auto state = std::make_shared<State>();
+      // processes chunks until the range is exhausted
+      auto work = [state,first,n,grainSize,&f]()
+      {
+        state->active++;
+        std::size_t i;
+        while ((i=state->next.fetch_add(grainSize))<n)
+        {
+          std::size_t e = std::min(i+grainSize,n);
+          try
+          {
+            for (It it = std::next(first,static_cast<Diff>(i)); i<e; ++i, ++it)
+            {
+              f(*it);
+            }
+          }
+          catch (...)
+          {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (!state->error) state->error = std::current_exception();
+          }
+        }
+        if (--state->active==0)
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          state->cond.notify_all();
+        }
+      };
+      std::size_t numHelpers = std::min(numThreads(),(n+grainSize-1)/grainSize)-1;
+      for (std::size_t i=0; i<numHelpers; i++)
+      {
+        // helpers that start after the range is exhausted return without touching f
+        push(Task([state,work,n]() { if (state->next<n) work(); }));
+      }
+      work();
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->cond.wait(lock,[&]{ return state->active==0; });
+      if (state->error) std::rethrow_exception(state->error);
+    }
+
+    /// Calls \a f for each element of \a container in parallel, see parallelFor(It,It,F&&,std::size_t).
+    template<class C, class F>
+    void parallelFor(C &container, F &&f, std::size_t grainSize=0)
+    {
+      parallelFor(std::begin(container),std::end(container),std::forward<F>(f),grainSize);
+    }
+
+    /// finish waits until all queued work is done and then stops the threads.
+    void finish()
+    {
+      {
+        std::lock_guard<std::mutex> l(m_sleepMutex);
+        m_stop = true;
+      }
+      m_sleepCond.notify_all();
+      for (auto &t : m_threads)
+      {
+        if (t.joinable()) t.join();
+      }
+      m_threads.clear();
+    }
+
+  private:
+    /// Move-only type erased task, avoids the shared_ptr and std::function
+    /// wrapping needed to store a std::packaged_task in a copyable container.
+    class Task
+    {
+      public:
+        Task() = default;
+        template<class F>
+        explicit Task(F &&f) : m_impl(std::make_unique< Impl< std::decay_t<F> > >(std::forward<F>(f))) {}
+        void operator()() { m_impl->run(); }
+        explicit operator bool() const { return m_impl!=nullptr; }
+      private:
+        struct ImplBase
+        {
+          virtual ~ImplBase() {}
+          virtual void run() = 0;
+        };
+        template<class F>
+        struct Impl : public ImplBase
+        {
+          Impl(F &&f) : m_f(std::move(f)) {}
+          Impl(const F &f) : m_f(f) {}
+          void run() override { m_f(); }
+          F m_f;
+        };
+        std::unique_ptr<ImplBase> m_impl;
+    };
+
+    /// Queue of tasks owned by a single worker.
+    struct WorkQueue
+    {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+    /// Identifies the pool and queue a worker thread belongs to.
+    struct WorkerInfo
+    {
+      const WorkStealingThreadPool *pool = nullptr;
+      std::size_t index = 0;
+    };
+    static WorkerInfo &currentWorker()
+    {
+      static thread_local WorkerInfo info;
+      return info;
+    }
+
+    void push(Task &&task)
+    {
+      const WorkerInfo &w = currentWorker();
+      std::size_t index = w.pool==this ? w.index : m_nextQueue++ % m_queues.size();
+      m_pending++; // count the task before it becomes visible, so the count never drops below zero
+      {
+        std::lock_guard<std::mutex> l(m_queues[index].mutex);
+        m_queues[index].tasks.push_back(std::move(task));
+      }
+      if (m_numSleeping>0) // only wake up a thread if one is waiting
+      {
+        std::lock_guard<std::mutex> l(m_sleepMutex);
+        m_sleepCond.notify_one();
+      }
+    }
+
+    // take a task from the back of our own queue, or steal one from the front of another queue
+    bool pop(std::size_t index,Task &task)
+    {
+      {
+        WorkQueue &q = m_queues[index];
+        std::lock_guard<std::mutex> l(q.mutex);
+        if (!q.tasks.empty())
+        {
+          task = std::move(q.tasks.back());
+          q.tasks.pop_back();
+          m_pending--;
+          return true;
+        }
+      }
+      for (std::size_t i = 1; i < m_queues.size(); ++i)
+      {
+        WorkQueue &q = m_queues[(index+i)%m_queues.size()];
+        std::unique_lock<std::mutex> l(q.mutex,std::try_to_lock);
+        if (l.owns_lock() && !q.tasks.empty())
+        {
+          task = std::move(q.tasks.front());
+          q.tasks.pop_front();
+          m_pending--;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // the work that a worker thread does:
+    void threadTask(std::size_t index)
+    {
+      WorkerInfo &w = currentWorker();
+      w.pool  = this;
+      w.index = index;
+      while (true)
+      {
+        Task task;
+        if (pop(index,task))
+        {
+          task();
+          continue;
+        }
+        std::unique_lock<std::mutex> l(m_sleepMutex);
+        if (m_pending>0) continue; // a task is queued but the try-lock steal missed it
+        if (m_stop) break;         // no more work and asked to stop
+        m_numSleeping++;
+        m_sleepCond.wait(l,[&]{ return m_pending>0 || m_stop; });
+        m_numSleeping--;
+      }
+      w.pool = nullptr;
+    }
+
+    std::vector<WorkQueue>   m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::size_t> m_nextQueue{0};
+    std::atomic<std::size_t> m_pending{0};     // number of queued tasks not yet taken by a worker
+    std::atomic<int>         m_numSleeping{0}; // number of workers waiting for m_sleepCond
+
+    // used to let idle workers wait for new tasks
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCond;
+    bool m_stop = false;
+};
+
+/// Runs jobs on a WorkStealingThreadPool and passes their results to a consumer
+/// on the calling thread in the order in which the jobs were queued, so output
+/// combined from the results does not depend on the order in which the threads finish.
+///
+/// To bound the memory used by results that are waiting for their turn, at most
+/// four jobs per thread are in flight; queuing another job first consumes the
+/// oldest result.
+///
+/// Usage example:
+/// @code
+/// OrderedJobQueue<std::string> jobs(4,[&](std::string &s) { out << s; });
+/// for (const auto &cd : *Doxygen::classLinkedMap)
+/// {
+///   const ClassDef *cdp = cd.get();
+///   jobs.queue([cdp]() { return render(cdp); });
+/// }
+/// jobs.finish();
+/// @endcode
+template<class R>
+class OrderedJobQueue
+{
+  public:
+    using Consumer = std::function<void(R &)>;
+
+    /// start a pool of \a N threads whose results are passed to \a consumer
+    OrderedJobQueue(std::size_t N,Consumer &&consumer)
+      : m_threadPool(N), m_consumer(std::move(consumer)),
+        m_maxJobsInFlight(4*m_threadPool.numThreads()) {}
+    /// Waits for the jobs that are still running, but drops their results.
+    /// Call finish() to consume the results; the destructor never throws,
+    /// so it is safe to run while an exception unwinds the stack.
+    ~OrderedJobQueue()
+    {
+      for (auto &result : m_results)
+      {
+        if (result.valid()) result.wait();
+      }
+    }
+    OrderedJobQueue(const OrderedJobQueue &) = delete;
+    OrderedJobQueue &operator=(const OrderedJobQueue &) = delete;
+
+    /// Queue the callable function \a f, which returns a value of type R,
+    /// for the threads to execute.
+    template<class F>
+    void queue(F &&f)
+    {
+      if (m_results.size()>=m_maxJobsInFlight)
+      {
+        consumeNext();
+      }
+      m_results.emplace_back(m_threadPool.queue(std::forward<F>(f)));
+    }
+
+    /// Waits for all queued jobs and consumes their results. Rethrows the
+    /// exception of a failed job; the results of the jobs queued after it
+    /// are then dropped when the queue is destroyed.
+    void finish()
+    {
+      while (!m_results.empty())
+      {
+        consumeNext();
+      }
+    }
+
+  private:
+    void consumeNext()
+    {
+      R result = m_results.front().get();
+      m_results.pop_front();
+      m_consumer(result);
+    }
+
+    WorkStealingThreadPool m_threadPool;
+    Consumer m_consumer;
+    std::size_t m_maxJobsInFlight;
+    std::deque< std::future<R> > m_results;
+};
 
+#endif
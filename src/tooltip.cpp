@@ -40,6 +40,7 @@ class TooltipManager::Private
   public:
     std::unordered_map<int, std::unique_ptr<TooltipData> > tooltips;
     std::unique_ptr<TooltipData> &getTooltipData(int id);
+    TooltipData *findTooltipData(int id);
 };
 
 TooltipManager &TooltipManager::instance()
@@ -75,6 +76,13 @@ std::unique_ptr<TooltipData> &TooltipManager::Private::getTooltipData(int id)
   return it->second;
 }
 
+TooltipData *TooltipManager::Private::findTooltipData(int id)
+{
+  std::lock_guard<std::mutex> lock(g_tooltipLock);
+  auto it = tooltips.find(id);
+  return it!=tooltips.end() ? it->second.get() : 0;
+}
+
 void TooltipManager::addTooltip(CodeOutputInterface &ol,const Definition *d)
 {
   bool sourceTooltips = Config_getBool(SOURCE_TOOLTIPS);
@@ -105,10 +113,9 @@ void TooltipManager::writeTooltips(CodeOutputInterface &ol)
 {
   int outputId = ol.id(); // get unique identifier per output file
   if (outputId==0) return; // not set => no HTML output
-  auto it = p->tooltips.find(outputId); // see if we have tooltips for this file
-  if (it!=p->tooltips.end())
+  TooltipData *ttd = p->findTooltipData(outputId); // see if we have tooltips for this file
+  if (ttd)
   {
-    auto &ttd = it->second;
     for (const auto &kv : ttd->tooltipInfo)
     {
       if (ttd->tooltipWritten.find(kv.first)==ttd->tooltipWritten.end()) // only write tooltips once
@@ -167,7 +167,7 @@ QCString removeAnonymousScopes(const QCString &s)
   int p=0;
   while ((i=re.match(s,p,&l))!=-1)
   {
-    result+=s.mid(p,i-p);
+    result+=s.midRef(p,i-p);
     int c=i;
     bool b1=FALSE,b2=FALSE;
     while (c<i+l && s.at(c)!='@') if (s.at(c++)==':') b1=TRUE;
@@ -179,7 +179,7 @@ QCString removeAnonymousScopes(const QCString &s)
     }
     p=i+l;
   }
-  result+=s.right(sl-p);
+  result+=s.rightRef(sl-p);
   //printf("removeAnonymousScopes('%s')='%s'\n",s.data(),result.data());
   return result;
 }
@@ -194,7 +194,7 @@ QCString replaceAnonymousScopes(const QCString &s,const char *replacement)
   int p=0;
   while ((i=re.match(s,p,&l))!=-1)
   {
-    result+=s.mid(p,i-p);
+    result+=s.midRef(p,i-p);
     if (replacement)
     {
       result+=replacement;
@@ -205,7 +205,7 @@ QCString replaceAnonymousScopes(const QCString &s,const char *replacement)
     }
     p=i+l;
   }
-  result+=s.right(sl-p);
+  result+=s.rightRef(sl-p);
   //printf("replaceAnonymousScopes('%s')='%s'\n",s.data(),result.data());
   return result;
 }
@@ -225,13 +225,13 @@ QCString stripAnonymousNamespaceScope(const QCString &s)
       if (s.at(i)!='@')
       {
         if (!newScope.isEmpty()) newScope+="::";
-        newScope+=s.mid(i,l);
+        newScope+=s.midRef(i,l);
       }
     }
     else if (i<sl)
     {
       if (!newScope.isEmpty()) newScope+="::";
-      newScope+=s.right(sl-i);
+      newScope+=s.rightRef(sl-i);
       goto done;
     }
     p=i+l;
@@ -311,31 +311,31 @@ QCString stripFromIncludePath(const QCString &path)
 int guessSection(const char *name)
 {
   QCString n=((QCString)name).lower();
-  if (n.right(2)==".c"    || // source
-      n.right(3)==".cc"   ||
-      n.right(4)==".cxx"  ||
-      n.right(4)==".cpp"  ||
-      n.right(4)==".c++"  ||
-      n.right(5)==".java" ||
-      n.right(2)==".m"    ||
-      n.right(3)==".mm"   ||
-      n.right(3)==".ii"   || // inline
-      n.right(4)==".ixx"  ||
-      n.right(4)==".ipp"  ||
-      n.right(4)==".i++"  ||
-      n.right(4)==".inl"  ||
-      n.right(4)==".xml"  ||
-      n.right(4)==".sql"
+  if (n.rightRef(2)==".c"    || // source
+      n.rightRef(3)==".cc"   ||
+      n.rightRef(4)==".cxx"  ||
+      n.rightRef(4)==".cpp"  ||
+      n.rightRef(4)==".c++"  ||
+      n.rightRef(5)==".java" ||
+      n.rightRef(2)==".m"    ||
+      n.rightRef(3)==".mm"   ||
+      n.rightRef(3)==".ii"   || // inline
+      n.rightRef(4)==".ixx"  ||
+      n.rightRef(4)==".ipp"  ||
+      n.rightRef(4)==".i++"  ||
+      n.rightRef(4)==".inl"  ||
+      n.rightRef(4)==".xml"  ||
+      n.rightRef(4)==".sql"
      ) return Entry::SOURCE_SEC;
-  if (n.right(2)==".h"    || // header
-      n.right(3)==".hh"   ||
-      n.right(4)==".hxx"  ||
-      n.right(4)==".hpp"  ||
-      n.right(4)==".h++"  ||
-      n.right(4)==".idl"  ||
-      n.right(4)==".ddl"  ||
-      n.right(5)==".pidl" ||
-      n.right(4)==".ice"
+  if (n.rightRef(2)==".h"    || // header
+      n.rightRef(3)==".hh"   ||
+      n.rightRef(4)==".hxx"  ||
+      n.rightRef(4)==".hpp"  ||
+      n.rightRef(4)==".h++"  ||
+      n.rightRef(4)==".idl"  ||
+      n.rightRef(4)==".ddl"  ||
+      n.rightRef(5)==".pidl" ||
+      n.rightRef(4)==".ice"
      ) return Entry::HEADER_SEC;
   return 0;
 }
@@ -1831,14 +1831,14 @@ static QCString extractCanonicalType(const Definition *d,const FileDef *fs,QCStr
     // foreach identifier in the type
   {
     //printf("     i=%d p=%d\n",i,p);
-    if (i>pp) canType += type.mid(pp,i-pp);
+    if (i>pp) canType += type.midRef(pp,i-pp);
 
     QCString ct = getCanonicalTypeForIdentifier(d,fs,word,&templSpec);
 
     // in case the ct is empty it means that "word" represents scope "d"
     // and this does not need to be added to the canonical
     // type (it is redundant), so/ we skip it. This solves problem 589616.
-    if (ct.isEmpty() && type.mid(p,2)=="::")
+    if (ct.isEmpty() && type.midRef(p,2)=="::")
     {
       p+=2;
     }
@@ -1858,16 +1858,16 @@ static QCString extractCanonicalType(const Definition *d,const FileDef *fs,QCStr
       //printf("adding resolved %s to %s\n",templSpec.data(),canType.data());
       while ((ti=re.match(templSpec,tp,&tl))!=-1)
       {
-        canType += templSpec.mid(tp,ti-tp);
+        canType += templSpec.midRef(tp,ti-tp);
         canType += getCanonicalTypeForIdentifier(d,fs,templSpec.mid(ti,tl),0);
         tp=ti+tl;
       }
-      canType+=templSpec.right(templSpec.length()-tp);
+      canType+=templSpec.rightRef(templSpec.length()-tp);
     }
 
     pp=p;
   }
-  canType += type.right(type.length()-pp);
+  canType += type.rightRef(type.length()-pp);
   //printf("extractCanonicalType = '%s'->'%s'\n",type.data(),canType.data());
 
   return removeRedundantWhiteSpace(canType);
@@ -2274,7 +2274,7 @@ bool getDefs(const QCString &scName,
   // strip common part of the scope from the scopeName
   while ((is=scopeName.findRev("::"))!=-1 &&
          (im=memberName.find("::",pm))!=-1 &&
-          (scopeName.right(scopeName.length()-is-2)==memberName.mid(pm,im-pm))
+          (scopeName.rightRef(scopeName.length()-is-2)==memberName.midRef(pm,im-pm))
         )
   {
     scopeName=scopeName.left(is);
@@ -2285,7 +2285,7 @@ bool getDefs(const QCString &scName,
 
   QCString mName=memberName;
   QCString mScope;
-  if (memberName.left(9)!="operator " && // treat operator conversion methods
+  if (memberName.leftRef(9)!="operator " && // treat operator conversion methods
       // as a special case
       (im=memberName.findRev("::"))!=-1 &&
       im<(int)memberName.length()-2 // not A::
@@ -3328,7 +3328,7 @@ FileDef *findFileDef(const FileNameLinkedMap *fnMap,const char *n,bool &ambig)
     {
       const std::unique_ptr<FileDef> &fd = fn->front();
       bool isSamePath = Portable::fileSystemIsCaseSensitive() ?
-                 fd->getPath().right(path.length())==path :
+                 fd->getPath().rightRef(path.length())==path :
                  fd->getPath().right(path.length()).lower()==path.lower();
       if (path.isEmpty() || isSamePath)
       {
@@ -3345,7 +3345,7 @@ FileDef *findFileDef(const FileNameLinkedMap *fnMap,const char *n,bool &ambig)
       {
         FileDef *fd = fd_p.get();
         QCString fdStripPath = stripFromIncludePath(fd->getPath());
-        if (path.isEmpty() || fdStripPath.right(pathStripped.length())==pathStripped)
+        if (path.isEmpty() || fdStripPath.rightRef(pathStripped.length())==pathStripped)
         {
           count++;
           lastMatch=fd;
@@ -3385,7 +3385,7 @@ QCString showFileDefMatches(const FileNameLinkedMap *fnMap,const char *n)
   {
     for (const auto &fd : *fn)
     {
-      if (path.isEmpty() || fd->getPath().right(path.length())==path)
+      if (path.isEmpty() || fd->getPath().rightRef(path.length())==path)
       {
         result+="   "+fd->absFilePath()+"\n";
       }
@@ -4258,7 +4258,7 @@ QCString convertCharEntitiesToUTF8(const QCString &s)
   {
     if (p>i)
     {
-      growBuf.addStr(s.mid(i,p-i));
+      growBuf.addStr(s.midRef(i,p-i));
     }
     QCString entity = s.mid(p,l);
     DocSymbol::SymType symType = HtmlEntityMapper::instance()->name2sym(entity);
@@ -4269,11 +4269,11 @@ QCString convertCharEntitiesToUTF8(const QCString &s)
     }
     else
     {
-      growBuf.addStr(s.mid(p,l));
+      growBuf.addStr(s.midRef(p,l));
     }
     i=p+l;
   }
-  growBuf.addStr(s.mid(i,s.length()-i));
+  growBuf.addStr(s.midRef(i,s.length()-i));
   growBuf.addChar(0);
   //printf("convertCharEntitiesToUTF8(%s)->%s\n",s.data(),growBuf.get());
   return growBuf.get();
@@ -4496,7 +4496,7 @@ QCString normalizeNonTemplateArgumentsInString(
   // for each identifier in the template part (e.g. B<T> -> T)
   while ((i=re.match(name,p,&l))!=-1)
   {
-    result += name.mid(p,i-p);
+    result += name.midRef(p,i-p);
     QCString n = name.mid(i,l);
     bool found=FALSE;
     for (const Argument &formArg : formalArgs)
@@ -4527,7 +4527,7 @@ QCString normalizeNonTemplateArgumentsInString(
     }
     p=i+l;
   }
-  result+=name.right(name.length()-p);
+  result+=name.rightRef(name.length()-p);
   //printf("normalizeNonTemplateArgumentInString(%s)=%s\n",name.data(),result.data());
   return removeRedundantWhiteSpace(result);
 }
@@ -4553,7 +4553,7 @@ QCString substituteTemplateArgumentsInString(
   // for each identifier in the base class name (e.g. B<T> -> B and T)
   while ((i=re.match(name,p,&l))!=-1)
   {
-    result += name.mid(p,i-p);
+    result += name.midRef(p,i-p);
     QCString n = name.mid(i,l);
     ArgumentList::iterator actIt;
     if (actualArgs)
@@ -4646,7 +4646,7 @@ QCString substituteTemplateArgumentsInString(
     }
     p=i+l;
   }
-  result+=name.right(name.length()-p);
+  result+=name.rightRef(name.length()-p);
   //printf("      Inheritance relation %s -> %s\n",
   //    name.data(),result.data());
   return result.stripWhiteSpace();
@@ -4693,11 +4693,11 @@ QCString stripTemplateSpecifiersFromScope(const QCString &fullName,
     if (parentOnly && si==-1) break;
     // we only do the parent scope, so we stop here if needed
 
-    result+=fullName.mid(p,i-p);
+    result+=fullName.midRef(p,i-p);
     //printf("  trying %s\n",(result+fullName.mid(i,e-i)).data());
     if (getClass(result+fullName.mid(i,e-i))!=0)
     {
-      result+=fullName.mid(i,e-i);
+      result+=fullName.midRef(i,e-i);
       //printf("  2:result+=%s\n",fullName.mid(i,e-i-1).data());
     }
     else if (pLastScopeStripped)
@@ -4708,7 +4708,7 @@ QCString stripTemplateSpecifiersFromScope(const QCString &fullName,
     p=e;
     i=fullName.find('<',p);
   }
-  result+=fullName.right(l-p);
+  result+=fullName.rightRef(l-p);
   //printf("3:result+=%s\n",fullName.right(l-p).data());
   return result;
 }
@@ -6445,7 +6445,7 @@ QCString replaceColorMarkers(const char *str)
   int i,l,sl=s.length(),p=0;
   while ((i=re.match(s,p,&l))!=-1)
   {
-    result+=s.mid(p,i-p);
+    result+=s.midRef(p,i-p);
     QCString lumStr = s.mid(i+2,l-2);
 #define HEXTONUM(x) (((x)>='0' && (x)<='9') ? ((x)-'0') :       \
                      ((x)>='a' && (x)<='f') ? ((x)-'a'+10) :    \
@@ -6472,7 +6472,7 @@ QCString replaceColorMarkers(const char *str)
     result+=colStr;
     p=i+l;
   }
-  result+=s.right(sl-p);
+  result+=s.rightRef(sl-p);
   return result;
 }
 
@@ -6508,6 +6508,41 @@ bool copyFile(const QCString &src,const QCString &dest)
   return TRUE;
 }
 
+/** Writes \a len bytes of \a data to file \a fileName, unless the file
+ *  already has exactly this content. In that case the file is not touched,
+ *  so its modification time is preserved for incremental runs.
+ *  Returns whether the file could be opened and written completely; an error
+ *  while flushing or closing the file counts as a failed write.
+ */
+WriteFileResult writeFileIfChanged(const QCString &fileName,const char *data,uint len)
+{
+  QFileInfo fi(fileName);
+  if (fi.exists() && fi.size()==len)
+  {
+    QFile f(fileName);
+    if (f.open(IO_ReadOnly))
+    {
+      char block[16384];
+      uint pos=0;
+      while (pos<len)
+      {
+        int n = f.readBlock(block,QMIN((uint)sizeof(block),len-pos));
+        if (n<=0 || memcmp(block,data+pos,n)!=0) break;
+        pos+=n;
+      }
+      if (pos==len) return WriteFileResult::Ok; // same content
+    }
+  }
+  QFile f(fileName);
+  if (!f.open(IO_WriteOnly))
+  {
+    return WriteFileResult::OpenFailed;
+  }
+  bool ok = len==0 || f.writeBlock(data,len)==(int)len;
+  f.close(); // sets the status to an error if flushing or closing failed
+  return ok && f.status()==IO_Ok ? WriteFileResult::Ok : WriteFileResult::WriteFailed;
+}
+
 /** Returns the section of text, in between a pair of markers.
  *  Full lines are returned, excluding the lines on which the markers appear.
  *  \sa routine lineBlock
@@ -7377,3 +7412,49 @@ QCString removeEmptyLines(const QCString &s)
   //printf("removeEmptyLines(%s)=%s\n",s.data(),out.data());
   return out.data();
 }
+
+//------------------------------------------------------------------------
+
+/** Per thread state for naming inline graphs */
+struct InlineGraphState
+{
+  QCString scope;
+  int      counter = 0;
+  bool     active  = false;
+};
+
+static THREAD_LOCAL InlineGraphState g_inlineGraphState;
+
+InlineGraphScope::InlineGraphScope(const QCString &scope)
+  : m_prevScope(g_inlineGraphState.scope),
+    m_prevCounter(g_inlineGraphState.counter),
+    m_prevActive(g_inlineGraphState.active)
+{
+  // the output file base can contain a sub directory (CREATE_SUBDIRS)
+  g_inlineGraphState.scope   = substitute(scope,"/","_");
+  g_inlineGraphState.counter = 0;
+  g_inlineGraphState.active  = true;
+}
+
+InlineGraphScope::~InlineGraphScope()
+{
+  g_inlineGraphState.scope   = m_prevScope;
+  g_inlineGraphState.counter = m_prevCounter;
+  g_inlineGraphState.active  = m_prevActive;
+}
+
+QCString inlineGraphName(const char *prefix,std::atomic_int &index)
+{
+  QCString result = prefix;
+  if (g_inlineGraphState.active)
+  {
+    // numbered per compound, so independent of the order in which threads run
+    result+=g_inlineGraphState.scope+"_"+QCString().setNum(++g_inlineGraphState.counter);
+  }
+  else
+  {
+    // pages that are generated sequentially keep the global numbering
+    result+=QCString().setNum(index++);
+  }
+  return result;
+}
@@ -22,6 +22,7 @@
  *  \brief A bunch of utility functions.
  */
 
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <algorithm>
@@ -410,6 +411,8 @@ void writeColoredImgData(const char *dir,ColoredImgDataItem data[]);
 QCString replaceColorMarkers(const char *str);
 
 bool copyFile(const QCString &src,const QCString &dest);
+enum class WriteFileResult { Ok, OpenFailed, WriteFailed };
+WriteFileResult writeFileIfChanged(const QCString &fileName,const char *data,uint len);
 QCString extractBlock(const QCString text,const QCString marker);
 int lineBlock(const QCString text,const QCString marker);
 
@@ -458,4 +461,28 @@ void writeLatexSpecialFormulaChars(FTextStream &t);
 bool recognizeFixedForm(const char* contents, FortranFormat format);
 FortranFormat convertFileNameFortranParserCode(QCString fn);
 
+/** Makes the names returned by inlineGraphName() on the current thread
+ *  unique within the output of the compound with output file base name
+ *  \a scope, for as long as this object lives. Compound pages can then be
+ *  generated on different threads while the graph names stay reproducible.
+ *  Only used when the pages are generated in parallel.
+ */
+class InlineGraphScope
+{
+  public:
+    InlineGraphScope(const QCString &scope);
+   ~InlineGraphScope();
+  private:
+    QCString m_prevScope;
+    int      m_prevCounter;
+    bool     m_prevActive;
+};
+
+/** Returns a new base name for an inline dot, msc or PlantUML graph,
+ *  consisting of \a prefix, the current InlineGraphScope and a number.
+ *  Without an InlineGraphScope the name is \a prefix followed by the
+ *  value of \a index, which is incremented.
+ */
+QCString inlineGraphName(const char *prefix,std::atomic_int &index);
+
 #endif
@@ -25,6 +25,7 @@
 #include <assert.h>
 #include <string.h>
 #include <map>
+#include <mutex>
 #include <qcstring.h>
 #include <qfileinfo.h>
 #include <qcstringlist.h>
@@ -599,9 +600,13 @@ ClassDef* VhdlDocGen::getPackageName(const QCString & name)
 static std::map<std::string,const MemberDef*>      g_varMap;
 static std::vector<ClassDef*>                      g_classList;
 static std::map<ClassDef*,std::vector<ClassDef*> > g_packages;
+// protects the above lookup caches, which are shared by the code parsers
+// running on different threads.
+static std::recursive_mutex                         g_lookupMutex;
 
 const MemberDef* VhdlDocGen::findMember(const QCString& className, const QCString& memName)
 {
+  std::lock_guard<std::recursive_mutex> lock(g_lookupMutex);
   ClassDef* cd,*ecd=0;
   const MemberDef *mdef=0;
 
@@ -702,6 +707,7 @@ const MemberDef* VhdlDocGen::findMember(const QCString& className, const QCStrin
  */
 const MemberDef* VhdlDocGen::findMemberDef(ClassDef* cd,const QCString& key,MemberListType type)
 {
+  std::lock_guard<std::recursive_mutex> lock(g_lookupMutex);
   QCString keyType=cd->symbolName()+"@"+key;
   //printf("\n %s | %s | %s",cd->symbolName().data(),key.data(,),keyType.data());
 
@@ -745,6 +751,7 @@ const MemberDef* VhdlDocGen::findMemberDef(ClassDef* cd,const QCString& key,Memb
 
 void VhdlDocGen::findAllPackages( ClassDef *cdef)
 {
+  std::lock_guard<std::recursive_mutex> lock(g_lookupMutex);
   if (g_packages.find(cdef)!=g_packages.end()) return;
   std::vector<ClassDef*> cList;
   MemberList *mem=cdef->getMemberList(MemberListType_variableMembers);
@@ -2786,6 +2793,7 @@ void VhdlDocGen::createFlowChart(const MemberDef *mdef)
 
 void VhdlDocGen::resetCodeVhdlParserState()
 {
+  std::lock_guard<std::recursive_mutex> lock(g_lookupMutex);
   g_varMap.clear();
   g_classList.clear();
   g_packages.clear();
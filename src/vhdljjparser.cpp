@@ -161,7 +161,7 @@ void VHDLOutlineParser::parseInput(const char *fileName,const char *fileBuf,
   s->lastEntity=0;
   s->lastEntity=0;
   p->oldEntry = 0;
-  s->current=std::make_shared<Entry>();
+  s->current=Entry::create();
   initEntry(s->current.get());
   p->commentScanner.enterFile(fileName,p->yyLineNr);
   p->lineParse.reserve(200);
@@ -473,11 +473,11 @@ void VHDLOutlineParser::addCompInst(const char *n, const char* instName, const c
     {
       initEntry(s->current.get());
       // TODO: protect with mutex
-      g_instFiles.emplace_back(std::make_shared<Entry>(*s->current));
+      g_instFiles.emplace_back(Entry::create(*s->current));
       // TODO: end protect with mutex
     }
 
-    s->current=std::make_shared<Entry>();
+    s->current=Entry::create();
   }
   else
   {
@@ -516,7 +516,7 @@ void VHDLOutlineParser::addVhdlType(const char *n,int startLine,int section,
 
     if (!s->lastCompound && (section==Entry::VARIABLE_SEC) &&  (spec == VhdlDocGen::USE || spec == VhdlDocGen::LIBRARY) )
     {
-      p->libUse.emplace_back(std::make_shared<Entry>(*s->current));
+      p->libUse.emplace_back(Entry::create(*s->current));
       s->current->reset();
     }
     newEntry();
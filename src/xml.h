@@ -1,12 +1,18 @@
 #ifndef XML_H
 #define XML_H
 
+#include <string.h>
+
 #include <memory>
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 /*! @brief Event handlers that can installed by the client and called while parsing a XML document.
+ *
+ *  The events are converted from the XMLEventHandler interface, which avoids the
+ *  copies made for these handlers and should be preferred for large documents.
  */
 class XMLHandlers
 {
@@ -37,6 +43,109 @@ class XMLHandlers
     }
 };
 
+/*! @brief Reference to a string owned by the parser.
+ *
+ *  It is only valid during the handler call it is passed to, use str() to keep a copy.
+ */
+class XMLStringRef
+{
+  public:
+    XMLStringRef() {}
+    XMLStringRef(const char *data,size_t length) : m_data(data), m_length(length) {}
+    const char *data() const   { return m_data; }
+    size_t      length() const { return m_length; }
+    bool        empty() const  { return m_length==0; }
+    std::string str() const    { return std::string(m_data,m_length); }
+    bool operator==(const char *s) const
+    {
+      size_t l = strlen(s);
+      return l==m_length && (l==0 || memcmp(m_data,s,l)==0);
+    }
+    bool operator!=(const char *s) const { return !operator==(s); }
+  private:
+    const char *m_data = "";
+    size_t      m_length = 0;
+};
+
+/*! @brief Name and value of an attribute of an element. */
+struct XMLAttribute
+{
+  XMLAttribute(XMLStringRef n,XMLStringRef v) : name(n), value(v) {}
+  XMLStringRef name;
+  XMLStringRef value;
+};
+
+/*! @brief The attributes of an element, in the order they appear in the document.
+ *
+ *  Elements have only a few attributes, so the list is searched linearly.
+ *  If an attribute appears more than once, the first occurrence is used.
+ */
+class XMLAttributeList
+{
+  public:
+    using const_iterator = std::vector<XMLAttribute>::const_iterator;
+    const_iterator begin() const { return m_attrs.begin(); }
+    const_iterator end() const   { return m_attrs.end(); }
+    size_t size() const          { return m_attrs.size(); }
+    bool empty() const           { return m_attrs.empty(); }
+    void clear()                 { m_attrs.clear(); }
+    void add(XMLStringRef name,XMLStringRef value) { m_attrs.emplace_back(name,value); }
+
+    /*! Returns the value of the attribute \a name or an empty reference if it is not present. */
+    XMLStringRef find(const char *name) const
+    {
+      for (const auto &attr : m_attrs)
+      {
+        if (attr.name==name) return attr.value;
+      }
+      return XMLStringRef();
+    }
+    /*! Returns a copy of the value of the attribute \a name or an empty string if it is not present. */
+    std::string value(const char *name) const
+    {
+      return find(name).str();
+    }
+  private:
+    std::vector<XMLAttribute> m_attrs;
+};
+
+/*! @brief Element name interned by the parser.
+ *
+ *  Each distinct element name is represented by a single XMLTag object for the
+ *  lifetime of the parser, so tags can be compared by address and their \a id
+ *  can be used as an index to cache information per tag.
+ */
+struct XMLTag
+{
+  XMLTag(int i,const std::string &n) : id(i), name(n) {}
+  int         id;   /**< number of the tag, tags are numbered from 0 in the order they are found */
+  std::string name; /**< name of the tag */
+};
+
+/*! @brief Low overhead event interface of the XML parser.
+ *
+ *  Unlike XMLHandlers, no strings or attribute maps are copied for the events:
+ *  element names are passed as interned tags and attributes and character data
+ *  as references into the buffers of the parser.
+ */
+class XMLEventHandler
+{
+  public:
+    virtual ~XMLEventHandler() {}
+    /*! Called at the start of the document */
+    virtual void startDocument() {}
+    /*! Called at the end of the document */
+    virtual void endDocument() {}
+    /*! Called when an opening tag has been found */
+    virtual void startElement(const XMLTag &,const XMLAttributeList &) {}
+    /*! Called when a closing tag has been found */
+    virtual void endElement(const XMLTag &) {}
+    /*! Called with the content between tags, with leading and trailing whitespace removed */
+    virtual void characters(XMLStringRef) {}
+    /*! Called when the parser encounters an error */
+    virtual void error(const std::string &,int,const std::string &) {}
+};
+
 class XMLLocator
 {
   public:
@@ -55,6 +164,10 @@ class XMLParser : public XMLLocator
      *  @param handlers The event handlers passed by the client.
      */
     XMLParser(const XMLHandlers &handlers);
+    /*! Creates an instance of the parser object that reports its events to
+     *  \a handler, which should outlive the parser.
+     */
+    XMLParser(XMLEventHandler &handler);
     /*! Destructor */
    ~XMLParser();
 
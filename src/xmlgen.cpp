@@ -15,6 +15,10 @@
 
 #include <stdlib.h>
 
+#include <functional>
+#include <memory>
+#include <thread>
+
 #include <qdir.h>
 #include <qfile.h>
 #include <qtextstream.h>
@@ -48,6 +52,7 @@
 #include "section.h"
 #include "htmlentity.h"
 #include "resourcemgr.h"
+#include "threadpool.h"
 
 // no debug info
 #define XML_DB(x) do {} while(0)
@@ -1234,6 +1239,7 @@ static void generateXMLForClass(const ClassDef *cd,FTextStream &ti)
     return;
   }
   FTextStream t(&f);
+  t.setBuffered(true);
   //t.setEncoding(FTextStream::UnicodeUTF8);
 
   writeXMLHeader(t);
@@ -1417,6 +1423,7 @@ static void generateXMLForNamespace(const NamespaceDef *nd,FTextStream &ti)
     return;
   }
   FTextStream t(&f);
+  t.setBuffered(true);
   //t.setEncoding(FTextStream::UnicodeUTF8);
 
   writeXMLHeader(t);
@@ -1493,6 +1500,7 @@ static void generateXMLForFile(FileDef *fd,FTextStream &ti)
     return;
   }
   FTextStream t(&f);
+  t.setBuffered(true);
   //t.setEncoding(FTextStream::UnicodeUTF8);
 
   writeXMLHeader(t);
@@ -1606,6 +1614,7 @@ static void generateXMLForGroup(const GroupDef *gd,FTextStream &ti)
   }
 
   FTextStream t(&f);
+  t.setBuffered(true);
   //t.setEncoding(FTextStream::UnicodeUTF8);
   writeXMLHeader(t);
   t << "  <compounddef id=\""
@@ -1662,6 +1671,7 @@ static void generateXMLForDir(DirDef *dd,FTextStream &ti)
   }
 
   FTextStream t(&f);
+  t.setBuffered(true);
   //t.setEncoding(FTextStream::UnicodeUTF8);
   writeXMLHeader(t);
   t << "  <compounddef id=\""
@@ -1716,6 +1726,7 @@ static void generateXMLForPage(PageDef *pd,FTextStream &ti,bool isExample)
   }
 
   FTextStream t(&f);
+  t.setBuffered(true);
   //t.setEncoding(FTextStream::UnicodeUTF8);
   writeXMLHeader(t);
   t << "  <compounddef id=\"" << pageName;
@@ -1823,6 +1834,65 @@ static void generateXMLForPage(PageDef *pd,FTextStream &ti,bool isExample)
   ti << "  </compound>" << endl;
 }
 
+/** Writes the XML files of the compounds, either directly on the calling
+ *  thread, or using a pool of worker threads when NUM_PROC_THREADS is larger
+ *  than one.
+ *
+ *  In the parallel case every job writes the entries it adds to index.xml
+ *  to a string of its own. These fragments are appended to the index in the
+ *  order in which the jobs were added, so index.xml does not depend on the
+ *  order in which the threads finish.
+ */
+class XmlCompoundGenerator
+{
+  public:
+    using Job = std::function<void(FTextStream &)>;
+
+    XmlCompoundGenerator(FTextStream &ti) : m_ti(ti)
+    {
+      std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+      if (numThreads==0)
+      {
+        numThreads = std::thread::hardware_concurrency();
+      }
+      if (numThreads>1)
+      {
+        m_jobs = std::make_unique< OrderedJobQueue< std::shared_ptr<QGString> > >(numThreads,
+            [this](std::shared_ptr<QGString> &fragment) { m_ti << fragment->data(); });
+      }
+    }
+
+    /** Runs \a job now (single threaded) or queues it for one of the worker threads */
+    void add(Job &&job)
+    {
+      if (!m_jobs) // single threaded version
+      {
+        job(m_ti);
+        return;
+      }
+      auto processJob = [job=std::move(job)]()
+      {
+        auto fragment = std::make_shared<QGString>();
+        {
+          FTextStream t(fragment.get());
+          job(t);
+        }
+        return fragment;
+      };
+      m_jobs->queue(processJob);
+    }
+
+    /** Waits for all queued jobs and writes their index entries */
+    void finish()
+    {
+      if (m_jobs) m_jobs->finish();
+    }
+
+  private:
+    FTextStream &m_ti;
+    std::unique_ptr< OrderedJobQueue< std::shared_ptr<QGString> > > m_jobs;
+};
+
 void generateXML()
 {
   // + classes
@@ -1883,6 +1953,7 @@ void generateXML()
     return;
   }
   FTextStream t(&f);
+  t.setBuffered(true);
   //t.setEncoding(FTextStream::UnicodeUTF8);
 
   // write index header
@@ -1893,48 +1964,58 @@ void generateXML()
   t << "xml:lang=\"" << theTranslator->trISOLang() << "\"";
   t << ">" << endl;
 
+  XmlCompoundGenerator compoundGen(t);
   for (const auto &cd : *Doxygen::classLinkedMap)
   {
-    generateXMLForClass(cd.get(),t);
+    const ClassDef *cdp = cd.get();
+    compoundGen.add([cdp](FTextStream &ti) { generateXMLForClass(cdp,ti); });
   }
   for (const auto &nd : *Doxygen::namespaceLinkedMap)
   {
     msg("Generating XML output for namespace %s\n",nd->name().data());
-    generateXMLForNamespace(nd.get(),t);
+    const NamespaceDef *ndp = nd.get();
+    compoundGen.add([ndp](FTextStream &ti) { generateXMLForNamespace(ndp,ti); });
   }
   for (const auto &fn : *Doxygen::inputNameLinkedMap)
   {
     for (const auto &fd : *fn)
     {
       msg("Generating XML output for file %s\n",fd->name().data());
-      generateXMLForFile(fd.get(),t);
+      FileDef *fdp = fd.get();
+      compoundGen.add([fdp](FTextStream &ti) { generateXMLForFile(fdp,ti); });
     }
   }
   for (const auto &gd : *Doxygen::groupLinkedMap)
   {
     msg("Generating XML output for group %s\n",gd->name().data());
-    generateXMLForGroup(gd.get(),t);
+    const GroupDef *gdp = gd.get();
+    compoundGen.add([gdp](FTextStream &ti) { generateXMLForGroup(gdp,ti); });
   }
   for (const auto &pd : *Doxygen::pageLinkedMap)
   {
     msg("Generating XML output for page %s\n",pd->name().data());
-    generateXMLForPage(pd.get(),t,FALSE);
+    PageDef *pdp = pd.get();
+    compoundGen.add([pdp](FTextStream &ti) { generateXMLForPage(pdp,ti,FALSE); });
   }
   for (const auto &dd : *Doxygen::dirLinkedMap)
   {
     msg("Generate XML output for dir %s\n",dd->name().data());
-    generateXMLForDir(dd.get(),t);
+    DirDef *ddp = dd.get();
+    compoundGen.add([ddp](FTextStream &ti) { generateXMLForDir(ddp,ti); });
   }
   for (const auto &pd : *Doxygen::exampleLinkedMap)
   {
     msg("Generating XML output for example %s\n",pd->name().data());
-    generateXMLForPage(pd.get(),t,TRUE);
+    PageDef *pdp = pd.get();
+    compoundGen.add([pdp](FTextStream &ti) { generateXMLForPage(pdp,ti,TRUE); });
   }
   if (Doxygen::mainPage)
   {
     msg("Generating XML output for the main page\n");
-    generateXMLForPage(Doxygen::mainPage.get(),t,FALSE);
+    PageDef *pdp = Doxygen::mainPage.get();
+    compoundGen.add([pdp](FTextStream &ti) { generateXMLForPage(pdp,ti,FALSE); });
   }
+  compoundGen.finish();
 
   //t << "  </compoundlist>" << endl;
   t << "</doxygenindex>" << endl;
@@ -748,6 +748,77 @@ function setClassAttr(elem,attr)
   elem.setAttribute('className',attr);
 }
 
+// Data of the shards loaded by loadSearchShards(), indexed by shard number
+var searchShardData = [];
+
+// Called by the data file of a shard when it is loaded. The data is in a
+// compact format (see writeCompactSearchData() in searchindex.cpp), which is
+// expanded here into the format of searchData used by createResults().
+function addSearchShard(index,data)
+{
+  var entries = [];
+  var id = '';
+  for (var i=0; i<data.e.length; i++)
+  {
+    var e = data.e[i];
+    id = id.substr(0,e[0])+e[1];
+    var item = [e[2]];
+    for (var c=3; c+2<e.length; c+=3)
+    {
+      var file = data.f[e[c]];
+      item.push([e[c+1] ? file[0]+'#'+e[c+1] : file[0], file[1], data.s[e[c+2]]]);
+    }
+    entries.push([id+'_'+(data.c+i),item]);
+  }
+  searchShardData[index] = entries;
+}
+
+// Loads the data files baseName_<n>.js of the shards that can contain matches
+// for the search in the URL query and calls onLoaded() once all are available.
+// shards[n] is the prefix of the search ids of all symbols in shard n.
+function loadSearchShards(baseName,shards,onLoaded)
+{
+  var search = unescape(window.location.search.substring(1));
+  search = convertToId(search.replace(/^ +/, "").replace(/ +$/, "").toLowerCase());
+  var needed = [];
+  for (var i=0; i<shards.length; i++)
+  {
+    var prefix = shards[i];
+    if (prefix.substr(0, search.length)==search || search.substr(0, prefix.length)==prefix)
+    {
+      needed.push(i);
+    }
+  }
+  var pending = needed.length+1;
+  var shardLoaded = function()
+  {
+    if (--pending==0)
+    {
+      // combine the shards in their original order
+      searchData = [];
+      for (var n=0; n<needed.length; n++)
+      {
+        if (searchShardData[needed[n]])
+        {
+          searchData = searchData.concat(searchShardData[needed[n]]);
+        }
+      }
+      onLoaded();
+    }
+  }
+  var head = document.getElementsByTagName('head')[0];
+  for (var n=0; n<needed.length; n++)
+  {
+    var script = document.createElement('script');
+    script.type = 'text/javascript';
+    script.src = baseName + '_' + needed[n].toString(16) + '.js';
+    script.onload = shardLoaded;
+    script.onerror = shardLoaded;
+    head.appendChild(script);
+  }
+  shardLoaded();
+}
+
 function createResults()
 {
   var results = document.getElementById("SRResults");
@@ -43,6 +43,19 @@ function readInt($file)
   return ($b1<<24)|($b2<<16)|($b3<<8)|$b4;
 }
 
+function readVInt($file)
+{
+  $result=0; $shift=0;
+  do
+  {
+    $b = ord(fgetc($file));
+    $result |= ($b&0x7f)<<$shift;
+    $shift+=7;
+  }
+  while ($b&0x80);
+  return $result;
+}
+
 function readString($file)
 {
   $result="";
@@ -71,22 +84,29 @@ function computeIndex($word)
   return $hi*256+$lo;
 }
 
-function search($file,$word,&$statsList)
+function search($file,$urlTable,$word,&$statsList)
 {
   $index = computeIndex($word);
   if ($index!=-1) // found a valid index
   {
-    fseek($file,$index*4+4); // 4 bytes per entry, skip header
+    fseek($file,$index*4+12); // 4 bytes per entry, skip header
     $index = readInt($file);
     if ($index) // found words matching the hash key
     {
       $start=sizeof($statsList);
       $count=$start;
       fseek($file,$index);
-      $w = readString($file);
-      while ($w)
+      $statIdx = readInt($file);
+      $numWords = readVInt($file);
+      $w = "";
+      for ($n=0;$n<$numWords;$n++)
       {
-        $statIdx = readInt($file);
+        // words are sorted and only store the part that differs from the previous one
+        $prefixLen = readVInt($file);
+        $suffixLen = readVInt($file);
+        $w = substr($w,0,$prefixLen);
+        if ($suffixLen>0) $w.=fread($file,$suffixLen);
+        $statIdx += readVInt($file);
         if ($word==substr($w,0,strlen($word)))
         { // found word that matches (as substring)
           $statsList[$count++]=array(
@@ -97,7 +117,10 @@ function search($file,$word,&$statsList)
               "docs"=>array()
               );
         }
-        $w = readString($file);
+        else if (strcmp($w,$word)>0)
+        { // all remaining words are larger
+          break;
+        }
       }
       $totalHi=0;
       $totalFreqHi=0;
@@ -109,13 +132,14 @@ function search($file,$word,&$statsList)
         // whole word matches have a double weight
         if ($statInfo["full"]) $multiplier=2;
         fseek($file,$statInfo["index"]); 
-        $numDocs = readInt($file);
+        $numDocs = readVInt($file);
         $docInfo = array();
         // read docs info + occurrence frequency of the word
+        $idx=0;
         for ($i=0;$i<$numDocs;$i++)
         {
-          $idx=readInt($file); 
-          $freq=readInt($file); 
+          $idx+=readVInt($file);
+          $freq=readVInt($file);
           $docInfo[$i]=array("idx"  => $idx,
                              "freq" => $freq>>1,
                              "rank" => 0.0,
@@ -134,7 +158,8 @@ function search($file,$word,&$statsList)
         // read name and url info for the doc
         for ($i=0;$i<$numDocs;$i++)
         {
-          fseek($file,$docInfo[$i]["idx"]);
+          fseek($file,$urlTable+$docInfo[$i]["idx"]*4);
+          fseek($file,readInt($file));
           $docInfo[$i]["name"]=readString($file);
           $docInfo[$i]["url"]=readString($file);
         }
@@ -311,10 +336,12 @@ function run_query($query)
   {
     die("Error: Search index file could NOT be opened!");
   }
-  if (readHeader($file)!="DOXS")
+  if (readHeader($file)!="DOXC")
   {
     die("Error: Header of index file is invalid!");
   }
+  $numUrls = readInt($file);
+  $urlTable = readInt($file);
   $results = array();
   $requiredWords = array();
   $forbiddenWords = array();
@@ -327,7 +354,7 @@ function run_query($query)
     if (!in_array($word,$foundWords))
     {
       $foundWords[]=$word;
-      search($file,strtolower($word),$results);
+      search($file,$urlTable,strtolower($word),$results);
     }
     $word=strtok(" ");
   }
@@ -0,0 +1,112 @@
+#!/usr/bin/python
+
+# Runs doxygen on all test inputs once with a single thread and once with
+# multiple threads and checks that both runs produce byte-identical output.
+
+from __future__ import print_function
+import argparse, filecmp, glob, os, re, shutil, subprocess, sys
+
+# in a multi threaded run the images of inline graphs are named after the page
+# they appear on (see NUM_PROC_THREADS), so inputs containing them are skipped
+inline_graph_reg = re.compile(r'[\\@](dot|msc|startuml)\b')
+
+def has_inline_graphs(fname):
+	with open(fname,'rb') as f:
+		return inline_graph_reg.search(f.read().decode('utf-8','replace')) is not None
+
+def write_config(args,cfg_file,out_dir,num_threads,inputs):
+	settings = [
+		'OUTPUT_DIRECTORY=%s' % out_dir,
+		'INPUT=%s' % ' '.join(inputs),
+		'EXAMPLE_PATH=%s' % args.inputdir,
+		'IMAGE_PATH=%s' % args.inputdir,
+		'STRIP_FROM_PATH=%s' % args.inputdir,
+		'QUIET=YES',
+		'WARNINGS=NO',
+		'EXTRACT_ALL=YES',
+		'SOURCE_BROWSER=YES',
+		'INLINE_SOURCES=YES',
+		'REFERENCED_BY_RELATION=YES',
+		'REFERENCES_RELATION=YES',
+		'SEARCHENGINE=YES',
+		'HAVE_DOT=NO',
+		'GENERATE_HTML=YES',
+		'GENERATE_LATEX=YES',
+		'GENERATE_RTF=YES',
+		'GENERATE_MAN=YES',
+		'GENERATE_XML=YES',
+		'GENERATE_DOCBOOK=YES',
+		'NUM_PROC_THREADS=%d' % num_threads,
+		'PARALLEL_SOURCE_GENERATION=YES',
+	]
+	with open(cfg_file,'w') as f:
+		for s in settings:
+			print(s,file=f)
+
+def run_doxygen(args,name,num_threads,inputs):
+	out_dir = os.path.abspath(os.path.join(args.outputdir,name))
+	shutil.rmtree(out_dir,ignore_errors=True)
+	os.makedirs(out_dir)
+	cfg_file = os.path.join(out_dir,'Doxyfile')
+	write_config(args,cfg_file,out_dir,num_threads,inputs)
+	# fix the date written into the RTF and man pages
+	env = dict(os.environ,SOURCE_DATE_EPOCH='0')
+	with open(os.path.join(out_dir,'doxygen.log'),'w') as log:
+		rc = subprocess.call([args.doxygen,cfg_file],cwd=out_dir,env=env,stdout=log,stderr=log)
+	if rc!=0:
+		print('doxygen with %d thread(s) failed with exit code %d, see %s' %
+		      (num_threads,rc,os.path.join(out_dir,'doxygen.log')))
+	return out_dir if rc==0 else None
+
+def compare_dirs(dcmp,prefix,differences):
+	for name in dcmp.left_only:
+		differences.append('only in the single threaded output: %s' % os.path.join(prefix,name))
+	for name in dcmp.right_only:
+		differences.append('only in the multi threaded output: %s' % os.path.join(prefix,name))
+	for name in dcmp.common_files:
+		if name in ('Doxyfile','doxygen.log'):
+			continue
+		if not filecmp.cmp(os.path.join(dcmp.left,name),os.path.join(dcmp.right,name),shallow=False):
+			differences.append('differs: %s' % os.path.join(prefix,name))
+	for name,sub in sorted(dcmp.subdirs.items()):
+		compare_dirs(sub,os.path.join(prefix,name),differences)
+
+def main():
+	parser = argparse.ArgumentParser(description=
+		'check that a multi threaded doxygen run produces the same output as a single threaded run')
+	parser.add_argument('--doxygen',nargs='?',default='doxygen',help=
+		'path/name of the doxygen executable')
+	parser.add_argument('--inputdir',nargs='?',default='.',help=
+		'input directory containing the tests')
+	parser.add_argument('--outputdir',nargs='?',default='.',help=
+		'output directory to write the doxygen output to')
+	parser.add_argument('--threads',nargs='?',default=4,type=int,help=
+		'number of threads used for the multi threaded run')
+	parser.add_argument('--keep',help='keep result directories',
+		action="store_true")
+	args = parser.parse_args()
+	args.inputdir = os.path.abspath(args.inputdir)
+	if os.path.dirname(args.doxygen): # doxygen is run from the output directory
+		args.doxygen = os.path.abspath(args.doxygen)
+
+	inputs = sorted(f for f in glob.glob(os.path.join(args.inputdir,'[0-9][0-9][0-9]_*'))
+	                if os.path.isfile(f) and not has_inline_graphs(f))
+	single = run_doxygen(args,'threads_1',1,inputs)
+	multi  = run_doxygen(args,'threads_%d' % args.threads,args.threads,inputs)
+	if single is None or multi is None:
+		sys.exit(1)
+
+	differences = []
+	compare_dirs(filecmp.dircmp(single,multi),'',differences)
+	for d in differences:
+		print(d)
+	if differences:
+		print('%d difference(s) between the output of 1 and %d threads' % (len(differences),args.threads))
+		sys.exit(1)
+	print('The output of 1 and %d threads is identical (%d input files)' % (args.threads,len(inputs)))
+	if not args.keep:
+		shutil.rmtree(single,ignore_errors=True)
+		shutil.rmtree(multi,ignore_errors=True)
+
+if __name__ == '__main__':
+	main()
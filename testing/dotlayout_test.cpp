@@ -0,0 +1,173 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2020 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  @brief Checks of the SVG output of the built-in graph layout.
+ *
+ *  Usage: dotlayout_test [outputdir]
+ *
+ *  Lays out a few small graphs with DotLayout and checks that
+ *  - all texts, including the edge labels, are inside the viewBox
+ *  - titles that doxygen already escaped are not escaped a second time,
+ *    in the SVG as well as in the image map
+ *
+ *  Text extents are estimated with the Helvetica width of a space for spaces
+ *  and of a digit for all other characters, which is the width of most
+ *  characters in the test labels and more than the width of the others.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "dotlayout.h"
+
+static int g_failures = 0;
+
+static void check(bool ok,const char *test,const char *what)
+{
+  if (!ok)
+  {
+    fprintf(stderr,"%s: %s\n",test,what);
+    g_failures++;
+  }
+}
+
+static std::string readFile(const std::string &fileName)
+{
+  std::string result;
+  FILE *f = fopen(fileName.c_str(),"r");
+  if (f==0) return result;
+  char buf[4096];
+  size_t n;
+  while ((n=fread(buf,1,sizeof(buf),f))>0) result.append(buf,n);
+  fclose(f);
+  return result;
+}
+
+static double attrValue(const std::string &text,size_t pos,const char *name)
+{
+  std::string key = std::string(" ")+name+"=\"";
+  size_t p = text.find(key,pos);
+  return p==std::string::npos ? 0 : atof(text.c_str()+p+key.length());
+}
+
+/** Checks that all text elements of \a svg are inside its viewBox */
+static void checkTextBounds(const char *test,const std::string &svg)
+{
+  double width=0, height=0, tx=0, ty=0;
+  size_t p = svg.find("viewBox=\"");
+  check(p!=std::string::npos,test,"no viewBox");
+  if (p==std::string::npos) return;
+  sscanf(svg.c_str()+p,"viewBox=\"%*f %*f %lf %lf\"",&width,&height);
+  p = svg.find("translate(");
+  check(p!=std::string::npos,test,"no translation");
+  if (p==std::string::npos) return;
+  sscanf(svg.c_str()+p,"translate(%lf %lf)",&tx,&ty);
+
+  int numTexts=0;
+  for (p=svg.find("<text ");p!=std::string::npos;p=svg.find("<text ",p+1))
+  {
+    size_t start = svg.find('>',p)+1;
+    size_t end   = svg.find("</text>",start);
+    size_t len   = end-start;
+    size_t numSpaces = 0;
+    for (size_t i=start;i<end;i++) if (svg[i]==' ') numSpaces++;
+    double x = attrValue(svg,p,"x")+tx, y = attrValue(svg,p,"y")+ty;
+    double fontSize = attrValue(svg,p,"font-size");
+    double w = (static_cast<double>(len-numSpaces)*0.556+static_cast<double>(numSpaces)*0.278)*fontSize;
+    double x0 = x, x1 = x+w;
+    if (svg.compare(p,26,"<text text-anchor=\"middle\"")==0) { x0=x-w/2; x1=x+w/2; }
+    else if (svg.compare(p,23,"<text text-anchor=\"end\"")==0) { x0=x-w; x1=x; }
+    double y0 = y-fontSize, y1 = y+0.25*fontSize;
+    if (x0<0 || x1>width || y0<0 || y1>height)
+    {
+      fprintf(stderr,"%s: text '%s' at (%.2f,%.2f)-(%.2f,%.2f) is outside of the viewBox %.2fx%.2f\n",
+              test,svg.substr(start,len).c_str(),x0,y0,x1,y1,width,height);
+      g_failures++;
+    }
+    numTexts++;
+  }
+  check(numTexts>0,test,"no texts found");
+}
+
+static void layoutGraph(const std::string &outDir,const char *test,const char *dotText,
+                        std::string &svg,std::string &map)
+{
+  std::string svgFile = outDir+"/"+test+".svg";
+  std::string mapFile = outDir+"/"+test+".map";
+  DotLayout layout;
+  bool ok = layout.prepare(dotText,50) && layout.writeSvg(svgFile.c_str(),mapFile.c_str());
+  check(ok,test,"layout failed");
+  svg = readFile(svgFile);
+  map = readFile(mapFile);
+  remove(svgFile.c_str());
+  remove(mapFile.c_str());
+}
+
+static const char *g_labelGraphTB =
+  "digraph \"Labels\"\n"
+  "{\n"
+  "  edge [fontname=\"Helvetica\",fontsize=\"10\",labelfontname=\"Helvetica\",labelfontsize=\"10\"];\n"
+  "  node [fontname=\"Helvetica\",fontsize=\"10\",shape=box];\n"
+  "  Node1 [label=\"A\",height=0.2,width=0.4,color=\"black\",fillcolor=\"grey75\",style=\"filled\"];\n"
+  "  Node2 -> Node1 [dir=\"back\",color=\"darkorchid3\",fontsize=\"10\",style=\"dashed\",label=\" head_node_data_0123456789\\nsecond\"];\n"
+  "  Node2 [label=\"B\",height=0.2,width=0.4,color=\"black\",URL=\"$b.html\"];\n"
+  "  Node3 -> Node1 [dir=\"back\",color=\"midnightblue\",fontsize=\"10\",style=\"solid\"];\n"
+  "  Node3 [label=\"C\",height=0.2,width=0.4,color=\"black\",URL=\"$c.html\"];\n"
+  "}\n";
+
+static const char *g_labelGraphLR =
+  "digraph \"Labels\"\n"
+  "{\n"
+  "  edge [fontname=\"Helvetica\",fontsize=\"10\",labelfontname=\"Helvetica\",labelfontsize=\"10\"];\n"
+  "  node [fontname=\"Helvetica\",fontsize=\"10\",shape=box];\n"
+  "  rankdir=\"LR\";\n"
+  "  Node1 [label=\"A\",height=0.2,width=0.4,color=\"black\"];\n"
+  "  Node1 -> Node2 [color=\"midnightblue\",fontsize=\"10\",style=\"solid\",label=\" head_node_data_0123456789\\nsecond\"];\n"
+  "  Node2 [label=\"B\",height=0.2,width=0.4,color=\"black\"];\n"
+  "}\n";
+
+static const char *g_escapedTitle =
+  "digraph \"A&lt;T&amp;U&gt;\"\n"
+  "{\n"
+  "  node [fontname=\"Helvetica\",fontsize=\"10\",shape=box];\n"
+  "  Node1 [label=\"A\\< T & U \\>\",height=0.2,width=0.4,color=\"black\",URL=\"$a.html\"];\n"
+  "  Node2 -> Node1 [dir=\"back\",color=\"midnightblue\",fontsize=\"10\",style=\"solid\"];\n"
+  "  Node2 [label=\"B\",height=0.2,width=0.4,color=\"black\",URL=\"$b.html\"];\n"
+  "}\n";
+
+int main(int argc,char **argv)
+{
+  std::string outDir = argc>1 ? argv[1] : ".";
+  std::string svg, map;
+
+  layoutGraph(outDir,"labels_tb",g_labelGraphTB,svg,map);
+  checkTextBounds("labels_tb",svg);
+
+  layoutGraph(outDir,"labels_lr",g_labelGraphLR,svg,map);
+  checkTextBounds("labels_lr",svg);
+
+  layoutGraph(outDir,"escaped_title",g_escapedTitle,svg,map);
+  check(svg.find("<title>A&lt;T&amp;U&gt;</title>")!=std::string::npos,"escaped_title","title escaped twice in SVG");
+  check(svg.find("A&lt; T &amp; U &gt;</text>")!=std::string::npos,"escaped_title","label not escaped in SVG");
+  check(map.find("<map id=\"A&lt;T&amp;U&gt;\" name=\"A&lt;T&amp;U&gt;\">")!=std::string::npos,
+        "escaped_title","title escaped twice in map");
+
+  if (g_failures==0) printf("All tests passed\n");
+  return g_failures==0 ? 0 : 1;
+}